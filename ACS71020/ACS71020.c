@@ -1,5 +1,60 @@
 #include "ACS71020.h"
 
-/**
- * Nothing here yet
- */
\ No newline at end of file
+void acs_device_init(acs_device_t *dev, const acs_transport_t *transport,
+                     uint8_t address)
+{
+    dev->transport = transport;
+    dev->address   = address;
+}
+
+int acs_read_register(const acs_device_t *dev, uint8_t reg_addr, uint32_t *value)
+{
+    if (dev == NULL || dev->transport == NULL || value == NULL)
+        return ACS_ERR_PARAM;
+
+    return dev->transport->read(dev->transport->ctx, dev->address, reg_addr,
+                                value, 1U);
+}
+
+int acs_write_register(const acs_device_t *dev, uint8_t reg_addr, uint32_t value)
+{
+    if (dev == NULL || dev->transport == NULL)
+        return ACS_ERR_PARAM;
+
+    return dev->transport->write(dev->transport->ctx, dev->address, reg_addr,
+                                 &value, 1U);
+}
+
+int acs_read_snapshot(const acs_device_t *dev, acs_snapshot_t *snap)
+{
+    uint32_t words[ACS_SNAPSHOT_WORDS];
+
+    if (dev == NULL || dev->transport == NULL || snap == NULL)
+        return ACS_ERR_PARAM;
+
+    int ret = dev->transport->read(dev->transport->ctx, dev->address,
+                                   ACS_REG_MEAS_FIRST, words,
+                                   (uint8_t)ACS_SNAPSHOT_WORDS);
+    if (ret != ACS_OK)
+        return ret;
+
+    for (uint8_t i = 0; i < ACS_SNAPSHOT_WORDS; i++)
+        snap->words[i] = words[i];
+
+    return ACS_OK;
+}
+
+int acs_unlock(const acs_device_t *dev)
+{
+    uint32_t access;
+
+    int ret = acs_write_register(dev, ACS_REG_ACCESS_CODE, ACS_CUSTOMER_CODE);
+    if (ret != ACS_OK)
+        return ret;
+
+    ret = acs_read_register(dev, ACS_REG_CUSTOMER_ACCESS, &access);
+    if (ret != ACS_OK)
+        return ret;
+
+    return acs_0x30_customer_access_get(access) ? ACS_OK : ACS_ERR_LOCKED;
+}
\ No newline at end of file
@@ -26,6 +26,8 @@
 #include <stdint.h>
 #include "ACS71020_eeprom.h"
 #include "ACS71020_volatile.h"
+#include "ACS71020_fields.h"
+#include "ACS71020_transport.h"
 
 /**
  * register maps and bit fields are in ACS71020_eeprom.h and ACS71020_volatile.h
@@ -33,4 +35,109 @@
  * to perform power related operations
  */
 
+#define ACS_REG_MEAS_FIRST      0x20U       // irms / vrms
+#define ACS_REG_MEAS_LAST       0x2DU       // status flags
+#define ACS_REG_VCODES          0x2AU       // vcodes, icodes follows in 0x2B
+#define ACS_REG_ACCESS_CODE     0x2FU
+#define ACS_REG_CUSTOMER_ACCESS 0x30U
+#define ACS_CUSTOMER_CODE       0x4F70656EU // Written to 0x2F to unlock writes
+
+#define ACS_REG_EEPROM_FIRST    0x0BU
+#define ACS_REG_EEPROM_LAST     0x0FU
+
+#define ACS_SNAPSHOT_WORDS (ACS_REG_MEAS_LAST - ACS_REG_MEAS_FIRST + 1U)
+#define ACS_EEPROM_WORDS   (ACS_REG_EEPROM_LAST - ACS_REG_EEPROM_FIRST + 1U)
+
+/**
+ * @brief One device on a bus. address is the 7-bit I2C slave address and is
+ * ignored by SPI transports.
+ */
+typedef struct
+{
+    const acs_transport_t *transport;
+    uint8_t address;
+} acs_device_t;
+
+/**
+ * @brief The whole measurement block 0x20 to 0x2D, laid out exactly as it is
+ * on the device so that it can be filled by a single burst read.
+ */
+typedef union
+{
+    uint32_t words[ACS_SNAPSHOT_WORDS];
+    struct
+    {
+        acs_0x20_t reg_0x20;
+        acs_0x21_t reg_0x21;
+        acs_0x22_t reg_0x22;
+        acs_0x23_t reg_0x23;
+        acs_0x24_t reg_0x24;
+        acs_0x25_t reg_0x25;
+        acs_0x26_t reg_0x26;
+        acs_0x27_t reg_0x27;
+        acs_0x28_t reg_0x28;
+        acs_0x29_t reg_0x29;
+        acs_0x2A_t reg_0x2A;
+        acs_0x2B_t reg_0x2B;
+        acs_0x2C_t reg_0x2C;
+        acs_0x2D_t reg_0x2D;
+    } regs;
+} acs_snapshot_t;
+
+_Static_assert(sizeof(acs_snapshot_t) == ACS_SNAPSHOT_WORDS * sizeof(uint32_t),
+               "acs_snapshot_t must match the register block layout");
+
+/**
+ * @brief Voltage ADC update rate selected by vadc_rate_set in a 0x0E word.
+ * @return 32000 or 4000
+ */
+static inline uint32_t acs_adc_rate_hz(uint32_t reg_0x0E)
+{
+    return eeprom_0x0E_vadc_rate_set_get(reg_0x0E) ? 4000U : 32000U;
+}
+
+/**
+ * @brief Delay of one chan_del_sel step for the ADC rate selected in a 0x0E
+ * word. The 7 steps span 218.75 us at 32 kHz and 875 us at 4 kHz, so a step
+ * is one sample at 32 kHz and half a sample at 4 kHz.
+ * @return 31250 or 125000 ns
+ */
+static inline uint32_t acs_chan_del_step_ns(uint32_t reg_0x0E)
+{
+    return eeprom_0x0E_vadc_rate_set_get(reg_0x0E) ? 125000U : 31250U;
+}
+
+/**
+ * @brief Binds a device handle to a transport and slave address.
+ */
+void acs_device_init(acs_device_t *dev, const acs_transport_t *transport,
+                     uint8_t address);
+
+/**
+ * @brief Reads a single 32-bit register.
+ * @return ACS_OK or a negative acs_err_t
+ */
+int acs_read_register(const acs_device_t *dev, uint8_t reg_addr, uint32_t *value);
+
+/**
+ * @brief Writes a single 32-bit register.
+ * @return ACS_OK or a negative acs_err_t
+ */
+int acs_write_register(const acs_device_t *dev, uint8_t reg_addr, uint32_t value);
+
+/**
+ * @brief Reads the whole measurement block 0x20 to 0x2D in one bus
+ * transaction. snap is left untouched on failure.
+ * @return ACS_OK or a negative acs_err_t
+ */
+int acs_read_snapshot(const acs_device_t *dev, acs_snapshot_t *snap);
+
+/**
+ * @brief Writes the customer access code to 0x2F and checks customer_access
+ * in 0x30. EEPROM registers can only be written after this.
+ * @return ACS_OK, ACS_ERR_LOCKED if the device did not enter customer mode,
+ * or a transport error
+ */
+int acs_unlock(const acs_device_t *dev);
+
 #endif // _ACS71020_H_
\ No newline at end of file
@@ -0,0 +1,268 @@
+#include <string.h>
+#include "ACS71020_async.h"
+#include "ACS71020_ecc.h"
+
+void acs_async_init(acs_async_t *drv, const acs_async_bus_t *bus, uint8_t dev_addr)
+{
+    memset(drv, 0, sizeof(*drv));
+    drv->bus      = bus;
+    drv->dev_addr = dev_addr;
+    atomic_init(&drv->state, ACS_ASYNC_IDLE);
+}
+
+/**
+ * @brief Claims the driver for a new operation. The exchange makes a submit
+ * from the main loop safe against a completion running in an ISR. The
+ * driver stays ACS_ASYNC_CLAIMED, where completions are spurious, until
+ * begin() has published the operation.
+ */
+static bool claim(acs_async_t *drv)
+{
+    int idle = ACS_ASYNC_IDLE;
+    return atomic_compare_exchange_strong_explicit(&drv->state, &idle, ACS_ASYNC_CLAIMED,
+                                                   memory_order_acquire, memory_order_relaxed);
+}
+
+static void set_state(acs_async_t *drv, acs_async_state_t state)
+{
+    atomic_store_explicit(&drv->state, (int)state, memory_order_relaxed);
+}
+
+/**
+ * @brief Enters the first state of a claimed operation, with op visible to
+ * any completion that sees that state.
+ */
+static void begin(acs_async_t *drv, acs_async_op_t *op, acs_async_state_t first)
+{
+    drv->op = op;
+    atomic_store_explicit(&drv->state, (int)first, memory_order_release);
+}
+
+/**
+ * @brief Ends the operation. The driver goes idle before the callback so the
+ * callback can chain the next operation.
+ */
+static void finish(acs_async_t *drv, int status)
+{
+    acs_async_op_t *op = drv->op;
+
+    op->status = status;
+    drv->op    = NULL;
+    if (status == ACS_OK)
+        drv->completed++;
+    else
+        drv->errors++;
+    atomic_store_explicit(&drv->state, ACS_ASYNC_IDLE, memory_order_release);
+
+    if (op->callback != NULL)
+        op->callback(op->user, op, status);
+}
+
+static int start_read(acs_async_t *drv, uint8_t reg_addr, uint32_t *words, uint8_t count)
+{
+    return drv->bus->start_read(drv->bus->ctx, drv->dev_addr, reg_addr, words, count);
+}
+
+static int start_write(acs_async_t *drv, uint8_t reg_addr, const uint32_t *words, uint8_t count)
+{
+    return drv->bus->start_write(drv->bus->ctx, drv->dev_addr, reg_addr, words, count);
+}
+
+static int start_word(acs_async_t *drv)
+{
+    acs_async_op_t *op = drv->op;
+
+    drv->frame = acs_ecc_wire_frame(op->words[op->index] >> ACS_EEPROM_DATA_SHIFT);
+    return start_write(drv, (uint8_t)(op->reg_addr + op->index), &drv->frame, 1U);
+}
+
+/**
+ * @brief A start that failed never completes, so the submit reports it and
+ * the callback is not called.
+ */
+static int submit_failed(acs_async_t *drv, int ret)
+{
+    drv->op = NULL;
+    drv->errors++;
+    atomic_store_explicit(&drv->state, ACS_ASYNC_IDLE, memory_order_release);
+    return ret;
+}
+
+int acs_async_read_snapshot(acs_async_t *drv, acs_async_op_t *op, acs_snapshot_t *snap,
+                            acs_async_callback_t callback, void *user)
+{
+    if (drv == NULL || op == NULL || snap == NULL)
+        return ACS_ERR_PARAM;
+    if (!claim(drv))
+        return ACS_ERR_BUSY;
+
+    op->callback = callback;
+    op->user     = user;
+    op->status   = ACS_ERR_BUSY;
+    op->snap     = snap;
+    op->reg_addr = ACS_REG_MEAS_FIRST;
+    op->count    = ACS_SNAPSHOT_WORDS;
+    begin(drv, op, ACS_ASYNC_READ);
+
+    int ret = start_read(drv, ACS_REG_MEAS_FIRST, snap->words, ACS_SNAPSHOT_WORDS);
+    return ret == ACS_OK ? ACS_OK : submit_failed(drv, ret);
+}
+
+int acs_async_write_eeprom(acs_async_t *drv, acs_async_op_t *op, uint8_t reg_addr,
+                           const uint32_t *words, uint8_t count,
+                           acs_async_callback_t callback, void *user)
+{
+    if (drv == NULL || op == NULL || words == NULL || count == 0U ||
+        reg_addr < ACS_REG_EEPROM_FIRST || reg_addr + count > ACS_REG_EEPROM_LAST + 1U)
+        return ACS_ERR_PARAM;
+    if (!claim(drv))
+        return ACS_ERR_BUSY;
+
+    op->callback = callback;
+    op->user     = user;
+    op->status   = ACS_ERR_BUSY;
+    op->snap     = NULL;
+    op->reg_addr = reg_addr;
+    op->count    = count;
+    op->index    = 0U;
+    memcpy(op->words, words, sizeof(uint32_t) * count);
+    begin(drv, op, ACS_ASYNC_UNLOCK);
+
+    static const uint32_t code = ACS_CUSTOMER_CODE;
+    int ret = start_write(drv, ACS_REG_ACCESS_CODE, &code, 1U);
+    return ret == ACS_OK ? ACS_OK : submit_failed(drv, ret);
+}
+
+void acs_async_complete(acs_async_t *drv, int status)
+{
+    acs_async_state_t state = (acs_async_state_t)atomic_load_explicit(&drv->state,
+                                                                      memory_order_acquire);
+    acs_async_op_t *op = drv->op;
+    int ret = status;
+
+    switch (state)
+    {
+    case ACS_ASYNC_IDLE:
+    case ACS_ASYNC_CLAIMED:
+        drv->spurious++;
+        return;
+
+    case ACS_ASYNC_READ:
+        break;
+
+    case ACS_ASYNC_UNLOCK:
+        if (ret != ACS_OK)
+            break;
+        set_state(drv, ACS_ASYNC_CHECK_ACCESS);
+        ret = start_read(drv, ACS_REG_CUSTOMER_ACCESS, &drv->access, 1U);
+        if (ret == ACS_OK)
+            return;
+        break;
+
+    case ACS_ASYNC_CHECK_ACCESS:
+        if (ret != ACS_OK)
+            break;
+        if (!acs_0x30_customer_access_get(drv->access))
+        {
+            ret = ACS_ERR_LOCKED;
+            break;
+        }
+        set_state(drv, ACS_ASYNC_WRITE);
+        ret = start_word(drv);
+        if (ret == ACS_OK)
+            return;
+        break;
+
+    case ACS_ASYNC_WRITE:
+        if (ret != ACS_OK)
+            break;
+        if (++op->index < op->count)
+        {
+            ret = start_word(drv);
+            if (ret == ACS_OK)
+                return;
+        }
+        break;
+    }
+
+    finish(drv, ret);
+}
+
+/* ----------------------------------------------------------------------- */
+/* Simulated completion source                                              */
+/* ----------------------------------------------------------------------- */
+
+static int sim_start_read(void *ctx, uint8_t dev_addr, uint8_t reg_addr,
+                          uint32_t *words, uint8_t count)
+{
+    acs_async_sim_t *sim = ctx;
+
+    if (sim->pending)
+        return ACS_ERR_BUSY;
+
+    sim->pending  = true;
+    sim->write    = false;
+    sim->dev_addr = dev_addr;
+    sim->reg_addr = reg_addr;
+    sim->count    = count;
+    sim->rx       = words;
+    sim->tx       = NULL;
+    return ACS_OK;
+}
+
+static int sim_start_write(void *ctx, uint8_t dev_addr, uint8_t reg_addr,
+                           const uint32_t *words, uint8_t count)
+{
+    acs_async_sim_t *sim = ctx;
+
+    if (sim->pending)
+        return ACS_ERR_BUSY;
+
+    sim->pending  = true;
+    sim->write    = true;
+    sim->dev_addr = dev_addr;
+    sim->reg_addr = reg_addr;
+    sim->count    = count;
+    sim->rx       = NULL;
+    sim->tx       = words;
+    return ACS_OK;
+}
+
+void acs_async_bus_sim_init(acs_async_bus_t *bus, acs_async_sim_t *sim,
+                            const acs_transport_t *inner, acs_async_t *drv)
+{
+    memset(sim, 0, sizeof(*sim));
+    sim->inner = inner;
+    sim->drv   = drv;
+
+    bus->start_read  = sim_start_read;
+    bus->start_write = sim_start_write;
+    bus->ctx         = sim;
+}
+
+bool acs_async_sim_fire(acs_async_sim_t *sim)
+{
+    int ret;
+
+    if (!sim->pending)
+        return false;
+    sim->pending = false;
+    sim->transfers++;
+
+    if (sim->fail_next != ACS_OK)
+    {
+        ret = sim->fail_next;
+        sim->fail_next = ACS_OK;
+    }
+    else if (sim->write)
+    {
+        ret = sim->inner->write(sim->inner->ctx, sim->dev_addr, sim->reg_addr, sim->tx, sim->count);
+    }
+    else
+    {
+        ret = sim->inner->read(sim->inner->ctx, sim->dev_addr, sim->reg_addr, sim->rx, sim->count);
+    }
+
+    acs_async_complete(sim->drv, ret);
+    return true;
+}
@@ -0,0 +1,162 @@
+/**
+ * @file ACS71020_async.h
+ * @author Usman Mehmood (usmanmehmood55@gmail.com)
+ * @brief Non-blocking driver for interrupt or DMA driven buses. An operation,
+ * a snapshot read of 0x20 to 0x2D or a write of EEPROM words, is submitted
+ * and the call returns as soon as the first transfer is started. The
+ * platform's transfer-complete interrupt calls acs_async_complete(), which
+ * moves an explicit state machine on to the next transfer, and when the
+ * last one is done, calls the operation's callback.
+ * One operation is in flight at a time, submitting another returns
+ * ACS_ERR_BUSY. The driver allocates nothing, the operation and the buffers
+ * it points to belong to the caller and must stay valid until the callback.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _ACS71020_async_H_
+#define _ACS71020_async_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "ACS71020.h"
+
+/**
+ * @brief Starts a block read of count consecutive registers into words, with
+ * the same framing as acs_transport_t, and returns at once. When the
+ * transfer is done the platform calls acs_async_complete(), typically from
+ * its DMA or I2C interrupt.
+ * @return ACS_OK if the transfer was started, or a negative acs_err_t
+ */
+typedef int (*acs_async_start_read_fn_t)(void *ctx, uint8_t dev_addr, uint8_t reg_addr,
+                                         uint32_t *words, uint8_t count);
+
+/**
+ * @brief As acs_async_start_read_fn_t, for a block write. words stays valid
+ * until completion.
+ */
+typedef int (*acs_async_start_write_fn_t)(void *ctx, uint8_t dev_addr, uint8_t reg_addr,
+                                          const uint32_t *words, uint8_t count);
+
+typedef struct
+{
+    acs_async_start_read_fn_t  start_read;
+    acs_async_start_write_fn_t start_write;
+    void                      *ctx;
+} acs_async_bus_t;
+
+typedef enum
+{
+    ACS_ASYNC_IDLE,
+    ACS_ASYNC_CLAIMED,          // Taken by a submit, nothing started yet
+    ACS_ASYNC_READ,             // Snapshot read in flight
+    ACS_ASYNC_UNLOCK,           // Access code write to 0x2F in flight
+    ACS_ASYNC_CHECK_ACCESS,     // Read of 0x30 in flight
+    ACS_ASYNC_WRITE,            // One EEPROM word write in flight
+} acs_async_state_t;
+
+struct acs_async_op;
+
+/**
+ * @brief Called once per operation with its final status, from the context
+ * that called acs_async_complete(). The driver is idle again by then, so the
+ * callback may submit the next operation.
+ */
+typedef void (*acs_async_callback_t)(void *user, struct acs_async_op *op, int status);
+
+typedef struct acs_async_op
+{
+    acs_async_callback_t callback;
+    void                *user;
+    int                  status;
+
+    acs_snapshot_t      *snap;                      // Snapshot reads
+    uint32_t             words[ACS_EEPROM_WORDS];   // EEPROM writes, as frames
+    uint8_t              reg_addr;
+    uint8_t              count;
+    uint8_t              index;                     // Next word to write
+} acs_async_op_t;
+
+typedef struct
+{
+    const acs_async_bus_t *bus;
+    uint8_t                dev_addr;
+
+    _Atomic int            state;   // acs_async_state_t
+    acs_async_op_t        *op;
+    uint32_t               access;  // 0x30 as read back during unlock
+    uint32_t               frame;   // Word being written, with its EEC bits
+
+    uint32_t               completed;
+    uint32_t               errors;
+    uint32_t               spurious;    // Completions with nothing in flight
+} acs_async_t;
+
+void acs_async_init(acs_async_t *drv, const acs_async_bus_t *bus, uint8_t dev_addr);
+
+static inline bool acs_async_busy(const acs_async_t *drv)
+{
+    return atomic_load_explicit(&((acs_async_t *)drv)->state, memory_order_acquire) != ACS_ASYNC_IDLE;
+}
+
+/**
+ * @brief Starts reading 0x20 to 0x2D into snap in one transfer.
+ * @return ACS_OK, ACS_ERR_BUSY, ACS_ERR_PARAM, or the error the bus returned
+ * when starting, in which case the callback is not called
+ */
+int acs_async_read_snapshot(acs_async_t *drv, acs_async_op_t *op, acs_snapshot_t *snap,
+                            acs_async_callback_t callback, void *user);
+
+/**
+ * @brief Unlocks the device and writes count EEPROM words starting at
+ * reg_addr, one transfer per word, with the EEC bits generated as
+ * acs_shadow_flush() does. The words are copied into op.
+ * @return as acs_async_read_snapshot()
+ */
+int acs_async_write_eeprom(acs_async_t *drv, acs_async_op_t *op, uint8_t reg_addr,
+                           const uint32_t *words, uint8_t count,
+                           acs_async_callback_t callback, void *user);
+
+/**
+ * @brief Transfer-complete hook, to be called by the platform once for every
+ * transfer it started, with its status. Safe to call from an ISR.
+ */
+void acs_async_complete(acs_async_t *drv, int status);
+
+/**
+ * @brief Completion source for tests and hosts without interrupts. Starting
+ * a transfer only records it, acs_async_sim_fire() later performs it through
+ * a blocking transport and signals completion, as the interrupt would.
+ */
+typedef struct
+{
+    const acs_transport_t *inner;
+    acs_async_t           *drv;
+
+    bool                   pending;
+    bool                   write;
+    uint8_t                dev_addr;
+    uint8_t                reg_addr;
+    uint8_t                count;
+    uint32_t              *rx;
+    const uint32_t        *tx;
+
+    int                    fail_next;   // When not ACS_OK, completes the next transfer with it
+    uint32_t               transfers;
+} acs_async_sim_t;
+
+void acs_async_bus_sim_init(acs_async_bus_t *bus, acs_async_sim_t *sim,
+                            const acs_transport_t *inner, acs_async_t *drv);
+
+/**
+ * @brief Performs the recorded transfer, if any, and calls acs_async_complete().
+ * @return true if a transfer was pending
+ */
+bool acs_async_sim_fire(acs_async_sim_t *sim);
+
+#endif // _ACS71020_async_H_
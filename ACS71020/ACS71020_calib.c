@@ -0,0 +1,153 @@
+#include <math.h>
+#include "ACS71020_calib.h"
+#include "ACS71020_config.h"
+
+#define ICODES_ONE  32768.0     // icodes Q15, 1.0 is current full scale
+#define TRIM9_MIN   (-256)
+#define TRIM9_MAX   255
+#define TRIM7_MIN   (-64)
+#define TRIM7_MAX   63
+
+const float acs_crs_sns_gain[8] = { 1.0f, 2.0f, 3.0f, 3.5f, 4.0f, 4.5f, 5.5f, 8.0f };
+
+static double mean_codes(const acs_calib_point_t *point)
+{
+    double sum = 0.0;
+
+    for (uint32_t i = 0; i < point->count; i++)
+        sum += point->codes[i];
+    return sum / (double)point->count;
+}
+
+/**
+ * @brief Least squares line through the point means, code = slope * reference
+ * + intercept. With one point the slope is not determined and only the
+ * intercept, the mean of that point, is returned.
+ */
+static int fit(const acs_calib_point_t *points, uint8_t count, double *slope, double *intercept)
+{
+    double sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (points[i].codes == NULL || points[i].count == 0U)
+            return ACS_ERR_PARAM;
+
+        double x = points[i].reference;
+        double y = mean_codes(&points[i]);
+        sx  += x;
+        sy  += y;
+        sxx += x * x;
+        sxy += x * y;
+    }
+
+    if (count == 1U)
+    {
+        *slope     = 0.0;
+        *intercept = sy;
+        return ACS_OK;
+    }
+
+    double det = count * sxx - sx * sx;
+    if (fabs(det) < 1e-12)
+        return ACS_ERR_PARAM;
+
+    *slope     = (count * sxy - sx * sy) / det;
+    *intercept = (sy - *slope * sx) / count;
+    return ACS_OK;
+}
+
+static int32_t clamp_round(double v, int32_t min, int32_t max, bool *clamped)
+{
+    double r = floor(v + 0.5);
+    if (r < min || r > max)
+    {
+        *clamped = true;
+        return r < min ? min : max;
+    }
+    return (int32_t)r;
+}
+
+int acs_calib_solve(uint32_t reg_0x0B, uint32_t reg_0x0D,
+                    const acs_calib_point_t *current, uint8_t current_count,
+                    const acs_calib_point_t *power, uint8_t power_count,
+                    acs_calib_result_t *result)
+{
+    double slope, intercept;
+    bool clamped = false;
+
+    if (current == NULL || current_count < 2U || result == NULL ||
+        (power != NULL && power_count == 0U))
+        return ACS_ERR_PARAM;
+
+    int ret = fit(current, current_count, &slope, &intercept);
+    if (ret != ACS_OK)
+        return ret;
+    if (!(slope > 0.0))
+        return ACS_ERR_RANGE;
+
+    // Undo the trims in effect to get the sensor's own gain k and offset o,
+    // raw = k * reference + o
+    double g0 = acs_crs_sns_gain[eeprom_0x0B_crs_sns_get(reg_0x0B)];
+    double f0 = 1.0 + eeprom_0x0B_sns_fine_sget(reg_0x0B) / (double)ACS_CALIB_SNS_DIVISOR;
+    double q0 = eeprom_0x0B_qvo_fine_sget(reg_0x0B) * (double)ACS_CALIB_QVO_STEP;
+    double k  = slope / (g0 * f0);
+    double o  = (intercept / f0 - q0) / g0;
+
+    // Total gain needed is ICODES_ONE / k, split into the coarse step that
+    // leaves the fine gain closest to 1
+    double need = ICODES_ONE / k;
+    int32_t crs = -1;
+    double best = 0.0;
+    for (int32_t c = 0; c < 8; c++)
+    {
+        double f = need / acs_crs_sns_gain[c];
+        if (f < 0.5 || f > 1.0 + TRIM9_MAX / (double)ACS_CALIB_SNS_DIVISOR)
+            continue;
+        if (crs < 0 || fabs(f - 1.0) < best)
+        {
+            crs  = c;
+            best = fabs(f - 1.0);
+        }
+    }
+    if (crs < 0)
+        return ACS_ERR_RANGE;
+
+    double g   = acs_crs_sns_gain[crs];
+    int32_t sns = clamp_round((need / g - 1.0) * ACS_CALIB_SNS_DIVISOR, TRIM9_MIN, TRIM9_MAX, &clamped);
+    int32_t qvo = clamp_round(-o * g / ACS_CALIB_QVO_STEP, TRIM9_MIN, TRIM9_MAX, &clamped);
+
+    double f = 1.0 + sns / (double)ACS_CALIB_SNS_DIVISOR;
+    result->crs_sns      = crs;
+    result->sns_fine     = sns;
+    result->qvo_fine     = qvo;
+    result->gain_error   = (float)(k * g * f / ICODES_ONE - 1.0);
+    result->offset_error = (float)((o * g + qvo * (double)ACS_CALIB_QVO_STEP) * f);
+
+    // The power offset does not depend on the current gain, only the trim
+    // in effect has to be taken out of the intercept
+    int32_t pacc0 = eeprom_0x0D_pacc_trim_sget(reg_0x0D);
+    result->pacc_trim = pacc0;
+    if (power != NULL)
+    {
+        ret = fit(power, power_count, &slope, &intercept);
+        if (ret != ACS_OK)
+            return ret;
+        result->pacc_trim = clamp_round(pacc0 - intercept / ACS_CALIB_PACC_STEP,
+                                        TRIM7_MIN, TRIM7_MAX, &clamped);
+    }
+
+    return clamped ? ACS_ERR_RANGE : ACS_OK;
+}
+
+int acs_calib_apply(const acs_calib_result_t *result, acs_shadow_t *shadow)
+{
+    acs_config_t config;
+
+    acs_config_init(&config);
+    acs_config_set_qvo_fine(&config, result->qvo_fine);
+    acs_config_set_sns_fine(&config, result->sns_fine);
+    acs_config_set_crs_sns(&config, result->crs_sns);
+    acs_config_set_pacc_trim(&config, result->pacc_trim);
+    return acs_config_apply(&config, shadow, NULL);
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+/**
+ * @file ACS71020_calib.h
+ * @author Usman Mehmood (usmanmehmood55@gmail.com)
+ * @brief One-shot calibration of the current channel and active power. The
+ * current path is modelled as
+ *   icodes = ((raw * crs_gain[crs_sns]) + 64 * qvo_fine) * (1 + sns_fine / 512)
+ * and active power as pactive + 6 * pacc_trim. A least squares line through
+ * the reference points, measured with the trims currently in the device,
+ * gives the sensor's own gain and offset, from which the new trims follow
+ * directly: the coarse gain that leaves the fine gain closest to 1, the fine
+ * gain, the offset in 64 LSB steps and the power offset in 6 LSB steps. The
+ * result is written once, through the shadow cache.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _ACS71020_calib_H_
+#define _ACS71020_calib_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include "ACS71020.h"
+#include "ACS71020_shadow.h"
+
+#define ACS_CALIB_QVO_STEP      64      // icodes per qvo_fine step
+#define ACS_CALIB_SNS_DIVISOR   512     // Fine gain is 1 + sns_fine / 512
+#define ACS_CALIB_PACC_STEP     6       // pactive codes per pacc_trim step
+
+/**
+ * @brief Relative current gain of each crs_sns setting.
+ */
+extern const float acs_crs_sns_gain[8];
+
+/**
+ * @brief One reference level and the raw readings taken at it. For current
+ * points reference is a DC current as a signed fraction of full scale and
+ * codes are sign extended icodes, for power points reference is a fraction
+ * of full-scale power and codes are sign extended pactive values.
+ */
+typedef struct
+{
+    float          reference;
+    const int32_t *codes;
+    uint32_t       count;
+} acs_calib_point_t;
+
+typedef struct
+{
+    int32_t qvo_fine;
+    int32_t sns_fine;
+    int32_t crs_sns;
+    int32_t pacc_trim;
+
+    float   gain_error;     // Predicted relative current gain error after trimming
+    float   offset_error;   // Predicted current offset after trimming, in icodes
+} acs_calib_result_t;
+
+/**
+ * @brief Solves for new trims.
+ * @param reg_0x0B the 0x0B word the current points were measured with
+ * @param reg_0x0D the 0x0D word the power points were measured with
+ * @param current at least two points at different references
+ * @param power NULL to keep pacc_trim, otherwise at least one point; with a
+ * single point it has to be at zero load
+ * @return ACS_OK, ACS_ERR_PARAM, or ACS_ERR_RANGE if the sensor is outside
+ * what the trims can correct, in which case result holds the nearest trims
+ */
+int acs_calib_solve(uint32_t reg_0x0B, uint32_t reg_0x0D,
+                    const acs_calib_point_t *current, uint8_t current_count,
+                    const acs_calib_point_t *power, uint8_t power_count,
+                    acs_calib_result_t *result);
+
+/**
+ * @brief Writes the trims in one unlock session, only if they changed.
+ * @return as acs_config_apply()
+ */
+int acs_calib_apply(const acs_calib_result_t *result, acs_shadow_t *shadow);
+
+#endif // _ACS71020_calib_H_
\ No newline at end of file
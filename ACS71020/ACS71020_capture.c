@@ -0,0 +1,99 @@
+#include "ACS71020_capture.h"
+
+int acs_ring_init(acs_ring_t *ring, acs_sample_t *storage, uint32_t capacity)
+{
+    if (ring == NULL || storage == NULL || capacity == 0U ||
+        (capacity & (capacity - 1U)) != 0U)
+        return ACS_ERR_PARAM;
+
+    ring->buffer = storage;
+    ring->mask   = capacity - 1U;
+    atomic_init(&ring->head, 0U);
+    atomic_init(&ring->tail, 0U);
+    atomic_init(&ring->overruns, 0U);
+    return ACS_OK;
+}
+
+int acs_ring_push(acs_ring_t *ring, const acs_sample_t *sample)
+{
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+    if (head - tail > ring->mask)
+    {
+        atomic_fetch_add_explicit(&ring->overruns, 1U, memory_order_relaxed);
+        return ACS_ERR_FULL;
+    }
+
+    ring->buffer[head & ring->mask] = *sample;
+    atomic_store_explicit(&ring->head, head + 1U, memory_order_release);
+    return ACS_OK;
+}
+
+uint32_t acs_ring_pop(acs_ring_t *ring, acs_sample_t *out, uint32_t max)
+{
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint32_t n = head - tail;
+
+    if (n > max)
+        n = max;
+
+    for (uint32_t i = 0; i < n; i++)
+        out[i] = ring->buffer[(tail + i) & ring->mask];
+
+    atomic_store_explicit(&ring->tail, tail + n, memory_order_release);
+    return n;
+}
+
+uint32_t acs_ring_count(acs_ring_t *ring)
+{
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    return head - tail;
+}
+
+void acs_capture_init(acs_capture_t *cap, const acs_device_t *dev, acs_ring_t *ring)
+{
+    cap->dev  = dev;
+    cap->ring = ring;
+    cap->seq  = 0U;
+    atomic_init(&cap->stop, false);
+    atomic_init(&cap->bus_errors, 0U);
+}
+
+int acs_capture_step(acs_capture_t *cap)
+{
+    const acs_transport_t *t = cap->dev->transport;
+    uint32_t words[2];
+
+    // Taken before the read, so a poll lost to a bus error leaves a gap
+    uint32_t seq = cap->seq++;
+
+    // vcodes and icodes are adjacent, one burst gets a coherent pair
+    int ret = t->read(t->ctx, cap->dev->address, ACS_REG_VCODES, words, 2U);
+    if (ret != ACS_OK)
+    {
+        atomic_fetch_add_explicit(&cap->bus_errors, 1U, memory_order_relaxed);
+        return ret;
+    }
+
+    acs_sample_t sample =
+    {
+        .vcodes = acs_0x2A_vcodes_sget(words[0]),
+        .icodes = acs_0x2B_icodes_sget(words[1]),
+        .seq    = seq,
+    };
+    return acs_ring_push(cap->ring, &sample);
+}
+
+void acs_capture_run(acs_capture_t *cap)
+{
+    while (!atomic_load_explicit(&cap->stop, memory_order_relaxed))
+        (void)acs_capture_step(cap);
+}
+
+void acs_capture_stop(acs_capture_t *cap)
+{
+    atomic_store_explicit(&cap->stop, true, memory_order_relaxed);
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+/**
+ * @file ACS71020_capture.h
+ * @author Usman Mehmood (usmanmehmood55@gmail.com)
+ * @brief Waveform capture of vcodes (0x2A) and icodes (0x2B). A producer,
+ * either a thread or an ISR, polls both registers in one burst as fast as
+ * the transport allows and pushes the samples into a single-producer /
+ * single-consumer lock-free ring. When the ring is full the new sample is
+ * dropped and counted, it never blocks the producer.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _ACS71020_capture_H_
+#define _ACS71020_capture_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "ACS71020.h"
+
+/**
+ * @brief One instantaneous sample. The codes are sign extended from 17 bits,
+ * seq increments on every poll, failed or not, so samples lost to bus errors
+ * or overruns show up as jumps in seq.
+ */
+typedef struct
+{
+    int32_t  vcodes;
+    int32_t  icodes;
+    uint32_t seq;
+} acs_sample_t;
+
+/**
+ * @brief Lock-free ring. head is only written by the producer and tail only
+ * by the consumer. capacity must be a power of two.
+ */
+typedef struct
+{
+    acs_sample_t        *buffer;
+    uint32_t             mask;
+    _Atomic uint32_t     head;
+    _Atomic uint32_t     tail;
+    _Atomic uint32_t     overruns;  // Samples dropped because the ring was full
+} acs_ring_t;
+
+/**
+ * @brief Capture state for one device and one ring.
+ */
+typedef struct
+{
+    const acs_device_t  *dev;
+    acs_ring_t          *ring;
+    atomic_bool          stop;
+    uint32_t             seq;
+    _Atomic uint32_t     bus_errors;
+} acs_capture_t;
+
+/**
+ * @brief Initializes a ring over caller provided storage.
+ * @return ACS_OK, or ACS_ERR_PARAM if capacity is not a power of two
+ */
+int acs_ring_init(acs_ring_t *ring, acs_sample_t *storage, uint32_t capacity);
+
+/**
+ * @brief Producer side. Adds one sample, or counts an overrun if full.
+ * @return ACS_OK or ACS_ERR_FULL
+ */
+int acs_ring_push(acs_ring_t *ring, const acs_sample_t *sample);
+
+/**
+ * @brief Consumer side. Removes up to max samples.
+ * @return number of samples copied to out
+ */
+uint32_t acs_ring_pop(acs_ring_t *ring, acs_sample_t *out, uint32_t max);
+
+/**
+ * @brief Number of samples waiting. Exact when called from either side.
+ */
+uint32_t acs_ring_count(acs_ring_t *ring);
+
+void acs_capture_init(acs_capture_t *cap, const acs_device_t *dev, acs_ring_t *ring);
+
+/**
+ * @brief Polls 0x2A and 0x2B once and pushes the sample. Short enough to be
+ * called from a timer ISR.
+ * @return ACS_OK, ACS_ERR_FULL on overrun, or a transport error
+ */
+int acs_capture_step(acs_capture_t *cap);
+
+/**
+ * @brief Polls back to back until acs_capture_stop() is called. Meant to be
+ * the body of a dedicated producer thread.
+ */
+void acs_capture_run(acs_capture_t *cap);
+
+/**
+ * @brief Asks acs_capture_run() to return. Safe to call from any thread.
+ */
+void acs_capture_stop(acs_capture_t *cap);
+
+#endif // _ACS71020_capture_H_
\ No newline at end of file
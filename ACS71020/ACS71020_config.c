@@ -0,0 +1,136 @@
+#include <string.h>
+#include "ACS71020_config.h"
+
+static bool in_range(int32_t value, uint8_t width, bool is_signed)
+{
+    int32_t min = is_signed ? -(int32_t)(1UL << (width - 1U)) : 0;
+    int32_t max = is_signed ? (int32_t)(1UL << (width - 1U)) - 1 : (int32_t)((1UL << width) - 1U);
+    return value >= min && value <= max;
+}
+
+#define CHECK_FIELD(prefix, address, field, shift, width, is_signed)            \
+    if ((config->present & ACS_CONFIG_BIT(field)) != 0U &&                      \
+        !in_range(config->field, (width), (is_signed)))                         \
+    {                                                                           \
+        if (bad_field != NULL)                                                  \
+            *bad_field = #field;                                                \
+        return ACS_ERR_RANGE;                                                   \
+    }
+
+int acs_config_validate(const acs_config_t *config, const char **bad_field)
+{
+    if (config == NULL)
+        return ACS_ERR_PARAM;
+
+    ACS_EEPROM_FIELDS(CHECK_FIELD)
+
+    // Narrower than the field allows
+    if ((config->present & ACS_CONFIG_BIT(i2c_slv_addr)) != 0U &&
+        (config->i2c_slv_addr < ACS_CONFIG_I2C_ADDR_MIN || config->i2c_slv_addr > ACS_CONFIG_I2C_ADDR_MAX))
+    {
+        if (bad_field != NULL)
+            *bad_field = "i2c_slv_addr";
+        return ACS_ERR_RANGE;
+    }
+
+    return ACS_OK;
+}
+
+#define COMPILE_FIELD(prefix, address, field, shift, width, is_signed)          \
+    if ((config->present & ACS_CONFIG_BIT(field)) != 0U)                        \
+    {                                                                           \
+        uint32_t *word = &image[(address) - ACS_REG_EEPROM_FIRST];              \
+        *word = prefix##_##field##_set(*word, (uint32_t)config->field);         \
+    }
+
+int acs_config_compile(const acs_config_t *config, const uint32_t *base, uint32_t *image)
+{
+    int ret = acs_config_validate(config, NULL);
+    if (ret != ACS_OK)
+        return ret;
+
+    for (uint8_t i = 0; i < ACS_EEPROM_WORDS; i++)
+        image[i] = base[i] & ~(uint32_t)ACS_FIELD_MASK(6);
+
+    ACS_EEPROM_FIELDS(COMPILE_FIELD)
+
+    return ACS_OK;
+}
+
+uint8_t acs_config_diff(const uint32_t *a, const uint32_t *b)
+{
+    uint8_t changed = 0U;
+
+    for (uint8_t i = 0; i < ACS_EEPROM_WORDS; i++)
+        if (a[i] != b[i])
+            changed |= (uint8_t)(1U << i);
+    return changed;
+}
+
+#define WORD_FIELD(prefix, address, field, shift, width, is_signed)             \
+    if ((address) == ACS_REG_EEPROM_FIRST + index)                              \
+        fields |= ACS_CONFIG_BIT(field);
+
+// Config bits of every field that lives in word 0x0B + index
+static uint32_t word_fields(uint8_t index)
+{
+    uint32_t fields = 0U;
+
+    ACS_EEPROM_FIELDS(WORD_FIELD)
+
+    return fields;
+}
+
+int acs_config_apply(const acs_config_t *config, acs_shadow_t *shadow,
+                     acs_config_result_t *result)
+{
+    uint32_t base[ACS_EEPROM_WORDS];
+    uint32_t image[ACS_EEPROM_WORDS];
+
+    if (result != NULL)
+        memset(result, 0, sizeof(*result));
+
+    int ret = acs_config_validate(config, NULL);
+    if (ret != ACS_OK)
+        return ret;
+
+    if (!shadow->loaded)
+    {
+        ret = acs_shadow_load(shadow);
+        if (ret != ACS_OK && ret != ACS_ERR_ECC)
+            return ret;
+    }
+
+    // The cached data of an uncorrectable word is garbage, only a config that
+    // sets every one of its fields may replace it, and then none of it is kept
+    for (uint8_t i = 0; i < ACS_EEPROM_WORDS; i++)
+    {
+        base[i] = shadow->cache.words[i];
+        if ((shadow->uncorrectable & (1U << i)) == 0U)
+            continue;
+
+        uint32_t fields = word_fields(i);
+        if ((config->present & fields) != fields)
+            return ACS_ERR_ECC;
+        base[i] = 0U;
+    }
+
+    ret = acs_config_compile(config, base, image);
+    if (ret != ACS_OK)
+        return ret;
+
+    for (uint8_t i = 0; i < ACS_EEPROM_WORDS; i++)
+        (void)acs_shadow_write(shadow, ACS_REG_EEPROM_FIRST + i, image[i]);
+
+    uint8_t  dirty   = shadow->dirty;
+    uint32_t written = shadow->words_written;
+
+    ret = acs_shadow_flush(shadow);
+
+    if (result != NULL)
+    {
+        result->changed       = dirty & (uint8_t)~shadow->dirty;
+        result->words_written = (uint8_t)(shadow->words_written - written);
+    }
+    return ret;
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+/**
+ * @file ACS71020_config.h
+ * @author Usman Mehmood (usmanmehmood55@gmail.com)
+ * @brief Declarative EEPROM configuration. An acs_config_t names the fields
+ * to change, it is validated against each field's range, compiled on top of
+ * the device's current EEPROM words into an image, and only the words of the
+ * image that differ from the device are written, in one unlock session.
+ * Fields that are not set keep their device value, so per-device factory
+ * trims survive a fleet-wide configuration change.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _ACS71020_config_H_
+#define _ACS71020_config_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "ACS71020.h"
+#include "ACS71020_shadow.h"
+
+#define ACS_CONFIG_I2C_ADDR_MIN 96
+#define ACS_CONFIG_I2C_ADDR_MAX 110
+
+#define ACS_CONFIG_INDEX(prefix, address, field, shift, width, is_signed) \
+    ACS_CONFIG_FIELD_##field,
+
+typedef enum
+{
+    ACS_EEPROM_FIELDS(ACS_CONFIG_INDEX)
+    ACS_CONFIG_FIELD_COUNT,
+} acs_config_field_t;
+
+_Static_assert(ACS_CONFIG_FIELD_COUNT <= 32, "acs_config_t.present is 32 bits");
+
+#define ACS_CONFIG_BIT(field) (1UL << ACS_CONFIG_FIELD_##field)
+
+#define ACS_CONFIG_MEMBER(prefix, address, field, shift, width, is_signed) \
+    int32_t field;
+
+/**
+ * @brief One member per EEPROM field, named after it. Only the members whose
+ * ACS_CONFIG_BIT() is set in present are applied. Signed fields take
+ * negative values directly.
+ */
+typedef struct
+{
+    uint32_t present;
+    ACS_EEPROM_FIELDS(ACS_CONFIG_MEMBER)
+} acs_config_t;
+
+/**
+ * @brief Outcome of acs_config_apply().
+ */
+typedef struct
+{
+    uint8_t changed;        // Bit n set when word 0x0B + n was written
+    uint8_t words_written;
+} acs_config_result_t;
+
+/**
+ * For every EEPROM field this generates
+ *   void acs_config_set_<field>(acs_config_t *config, int32_t value)
+ * which stores the value and marks the field present.
+ */
+#define ACS_CONFIG_SETTER(prefix, address, field, shift, width, is_signed)     \
+    static inline void acs_config_set_##field(acs_config_t *config, int32_t value) \
+    {                                                                         \
+        config->field    = value;                                             \
+        config->present |= ACS_CONFIG_BIT(field);                             \
+    }
+
+ACS_EEPROM_FIELDS(ACS_CONFIG_SETTER)
+
+static inline void acs_config_init(acs_config_t *config)
+{
+    *config = (acs_config_t){ 0 };
+}
+
+/**
+ * @brief Checks every present field against its range: the field width,
+ * signed where the field is, and 96 to 110 for i2c_slv_addr.
+ * @param bad_field set to the name of the first offending field, may be NULL
+ * @return ACS_OK or ACS_ERR_RANGE
+ */
+int acs_config_validate(const acs_config_t *config, const char **bad_field);
+
+/**
+ * @brief Builds an EEPROM image from the present fields on top of base.
+ * Images hold frame words like the shadow cache: data in bits 6 to 31, EEC
+ * and reserved bits clear.
+ * @param base the current words 0x0B to 0x0F
+ * @param image receives the five new words, may alias base
+ * @return ACS_OK, or ACS_ERR_RANGE if validation fails
+ */
+int acs_config_compile(const acs_config_t *config, const uint32_t *base, uint32_t *image);
+
+/**
+ * @brief Words that differ between two images.
+ * @return bit n set when word 0x0B + n differs
+ */
+uint8_t acs_config_diff(const uint32_t *a, const uint32_t *b);
+
+/**
+ * @brief Validates and applies a configuration through a shadow cache. The
+ * cache is loaded first if it never was, then the image is compiled onto it
+ * and flushed, so only changed words are written and the device is unlocked
+ * once, or not at all when nothing changed. A word the device reported as
+ * uncorrectable is only written when the configuration sets every field of
+ * it, its other data bits are then cleared.
+ * @param result may be NULL
+ * @return ACS_OK, ACS_ERR_RANGE, ACS_ERR_ECC if an uncorrectable word is not
+ * fully covered (nothing is written), ACS_ERR_LOCKED or a transport error
+ */
+int acs_config_apply(const acs_config_t *config, acs_shadow_t *shadow,
+                     acs_config_result_t *result);
+
+#endif // _ACS71020_config_H_
\ No newline at end of file
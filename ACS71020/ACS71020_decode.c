@@ -0,0 +1,206 @@
+#include "ACS71020_decode.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/**
+ * @brief Scale of one LSB of a field with frac fractional bits, multiplied by
+ * its full-scale value.
+ */
+static double lsb_scale(int frac, double full_scale)
+{
+    return full_scale / (double)((uint32_t)1U << frac);
+}
+
+/**
+ * @brief Describes one field to decode, taken from ACS71020_fields.h.
+ */
+typedef struct
+{
+    uint32_t shift;
+    uint32_t mask;
+    uint32_t sign;      // 0 for unsigned fields
+} field_fmt_t;
+
+/*
+ * One format per volatile field, generated from ACS_VOLATILE_FIELDS so that
+ * positions are never spelled out twice.
+ */
+#define FIELD_ID(prefix, address, field, shift, width, is_signed) FIELD_##field,
+enum { ACS_VOLATILE_FIELDS(FIELD_ID) FIELD_COUNT };
+
+#define FIELD_FMT(prefix, address, field, shift, width, is_signed) \
+    [FIELD_##field] = { (shift), ACS_FIELD_MASK(width), (is_signed) ? ACS_FIELD_SIGN(width) : 0U },
+
+static const field_fmt_t field_fmts[FIELD_COUNT] =
+{
+    ACS_VOLATILE_FIELDS(FIELD_FMT)
+};
+
+#define FMT(field) (field_fmts[FIELD_##field])
+
+/**
+ * @brief Branchless extraction of a field as a sign extended integer. For
+ * unsigned fields sign is 0 and the xor/subtract pair is a no-op.
+ */
+static inline int32_t field_extract(uint32_t reg, const field_fmt_t *fmt)
+{
+    uint32_t v = (reg >> fmt->shift) & fmt->mask;
+    return (int32_t)((v ^ fmt->sign) - fmt->sign);
+}
+
+static size_t decode_field_simd(const uint32_t *in, float *out, size_t count,
+                                const field_fmt_t *fmt, float scale)
+{
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    const __m128i shift = _mm_cvtsi32_si128((int)fmt->shift);
+    const __m256i mask  = _mm256_set1_epi32((int)fmt->mask);
+    const __m256i sign  = _mm256_set1_epi32((int)fmt->sign);
+    const __m256  k     = _mm256_set1_ps(scale);
+
+    for (; i + 8U <= count; i += 8U)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)&in[i]);
+        v = _mm256_and_si256(_mm256_srl_epi32(v, shift), mask);
+        v = _mm256_sub_epi32(_mm256_xor_si256(v, sign), sign);
+        _mm256_storeu_ps(&out[i], _mm256_mul_ps(_mm256_cvtepi32_ps(v), k));
+    }
+#elif defined(__SSE2__)
+    const __m128i shift = _mm_cvtsi32_si128((int)fmt->shift);
+    const __m128i mask  = _mm_set1_epi32((int)fmt->mask);
+    const __m128i sign  = _mm_set1_epi32((int)fmt->sign);
+    const __m128  k     = _mm_set1_ps(scale);
+
+    for (; i + 4U <= count; i += 4U)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)&in[i]);
+        v = _mm_and_si128(_mm_srl_epi32(v, shift), mask);
+        v = _mm_sub_epi32(_mm_xor_si128(v, sign), sign);
+        _mm_storeu_ps(&out[i], _mm_mul_ps(_mm_cvtepi32_ps(v), k));
+    }
+#elif defined(__ARM_NEON)
+    const int32x4_t   shift = vdupq_n_s32(-(int32_t)fmt->shift);
+    const uint32x4_t  mask  = vdupq_n_u32(fmt->mask);
+    const uint32x4_t  sign  = vdupq_n_u32(fmt->sign);
+    const float32x4_t k     = vdupq_n_f32(scale);
+
+    for (; i + 4U <= count; i += 4U)
+    {
+        uint32x4_t v = vandq_u32(vshlq_u32(vld1q_u32(&in[i]), shift), mask);
+        v = vsubq_u32(veorq_u32(v, sign), sign);
+        vst1q_f32(&out[i], vmulq_f32(vcvtq_f32_s32(vreinterpretq_s32_u32(v)), k));
+    }
+#else
+    (void)in; (void)out; (void)count; (void)fmt; (void)scale;
+#endif
+
+    return i;
+}
+
+static void decode_field_f32(const uint32_t *in, float *out, size_t count,
+                             const field_fmt_t *fmt, double scale)
+{
+    if (in == NULL || out == NULL)
+        return;
+
+    size_t i = decode_field_simd(in, out, count, fmt, (float)scale);
+    for (; i < count; i++)
+        out[i] = (float)field_extract(in[i], fmt) * (float)scale;
+}
+
+static void decode_field_f64(const uint32_t *in, double *out, size_t count,
+                             const field_fmt_t *fmt, double scale)
+{
+    if (in == NULL || out == NULL)
+        return;
+
+    for (size_t i = 0; i < count; i++)
+        out[i] = (double)field_extract(in[i], fmt) * scale;
+}
+
+/* The register unions are a single uint32_t, arrays of them are word arrays */
+#define WORDS(regs) ((regs) != NULL ? &(regs)->register_value : NULL)
+
+int acs_decode_batch_f32(const acs_raw_batch_t *raw, size_t count,
+                         const acs_full_scale_t *fs, const acs_decoded_f32_t *out)
+{
+    if (raw == NULL || fs == NULL || out == NULL)
+        return ACS_ERR_PARAM;
+
+    decode_field_f32(WORDS(raw->reg_0x20), out->irms, count, &FMT(irms),
+                     lsb_scale(ACS_IRMS_FRAC, fs->current));
+    decode_field_f32(WORDS(raw->reg_0x20), out->vrms, count, &FMT(vrms),
+                     lsb_scale(ACS_VRMS_FRAC, fs->voltage));
+    decode_field_f32(WORDS(raw->reg_0x21), out->pactive, count, &FMT(pactive),
+                     lsb_scale(ACS_PACTIVE_FRAC, fs->power));
+    decode_field_f32(WORDS(raw->reg_0x22), out->papparent, count, &FMT(papparent),
+                     lsb_scale(ACS_PAPPARENT_FRAC, fs->power));
+    decode_field_f32(WORDS(raw->reg_0x23), out->pimag, count, &FMT(pimag),
+                     lsb_scale(ACS_PIMAG_FRAC, fs->power));
+    decode_field_f32(WORDS(raw->reg_0x24), out->pfactor, count, &FMT(pfactor),
+                     lsb_scale(ACS_PFACTOR_FRAC, 1.0));
+    decode_field_f32(WORDS(raw->reg_0x2A), out->vcodes, count, &FMT(vcodes),
+                     lsb_scale(ACS_VCODES_FRAC, fs->voltage));
+    decode_field_f32(WORDS(raw->reg_0x2B), out->icodes, count, &FMT(icodes),
+                     lsb_scale(ACS_ICODES_FRAC, fs->current));
+    decode_field_f32(WORDS(raw->reg_0x2C), out->pinstant, count, &FMT(pinstant),
+                     lsb_scale(ACS_PINSTANT_FRAC, fs->power));
+
+    return ACS_OK;
+}
+
+int acs_decode_batch_f64(const acs_raw_batch_t *raw, size_t count,
+                         const acs_full_scale_t *fs, const acs_decoded_f64_t *out)
+{
+    if (raw == NULL || fs == NULL || out == NULL)
+        return ACS_ERR_PARAM;
+
+    decode_field_f64(WORDS(raw->reg_0x20), out->irms, count, &FMT(irms),
+                     lsb_scale(ACS_IRMS_FRAC, fs->current));
+    decode_field_f64(WORDS(raw->reg_0x20), out->vrms, count, &FMT(vrms),
+                     lsb_scale(ACS_VRMS_FRAC, fs->voltage));
+    decode_field_f64(WORDS(raw->reg_0x21), out->pactive, count, &FMT(pactive),
+                     lsb_scale(ACS_PACTIVE_FRAC, fs->power));
+    decode_field_f64(WORDS(raw->reg_0x22), out->papparent, count, &FMT(papparent),
+                     lsb_scale(ACS_PAPPARENT_FRAC, fs->power));
+    decode_field_f64(WORDS(raw->reg_0x23), out->pimag, count, &FMT(pimag),
+                     lsb_scale(ACS_PIMAG_FRAC, fs->power));
+    decode_field_f64(WORDS(raw->reg_0x24), out->pfactor, count, &FMT(pfactor),
+                     lsb_scale(ACS_PFACTOR_FRAC, 1.0));
+    decode_field_f64(WORDS(raw->reg_0x2A), out->vcodes, count, &FMT(vcodes),
+                     lsb_scale(ACS_VCODES_FRAC, fs->voltage));
+    decode_field_f64(WORDS(raw->reg_0x2B), out->icodes, count, &FMT(icodes),
+                     lsb_scale(ACS_ICODES_FRAC, fs->current));
+    decode_field_f64(WORDS(raw->reg_0x2C), out->pinstant, count, &FMT(pinstant),
+                     lsb_scale(ACS_PINSTANT_FRAC, fs->power));
+
+    return ACS_OK;
+}
+
+void acs_decode_snapshot(const acs_snapshot_t *snap, const acs_full_scale_t *fs,
+                         acs_measurement_t *out)
+{
+    const uint32_t *w = snap->words;
+
+#define DECODE(reg, fmt, frac, full_scale) \
+    (float)((double)field_extract(w[(reg) - ACS_REG_MEAS_FIRST], &(fmt)) * lsb_scale(frac, full_scale))
+
+    out->irms      = DECODE(0x20, FMT(irms),      ACS_IRMS_FRAC,      fs->current);
+    out->vrms      = DECODE(0x20, FMT(vrms),      ACS_VRMS_FRAC,      fs->voltage);
+    out->pactive   = DECODE(0x21, FMT(pactive),   ACS_PACTIVE_FRAC,   fs->power);
+    out->papparent = DECODE(0x22, FMT(papparent), ACS_PAPPARENT_FRAC, fs->power);
+    out->pimag     = DECODE(0x23, FMT(pimag),     ACS_PIMAG_FRAC,     fs->power);
+    out->pfactor   = DECODE(0x24, FMT(pfactor),   ACS_PFACTOR_FRAC,   1.0);
+    out->vcodes    = DECODE(0x2A, FMT(vcodes),    ACS_VCODES_FRAC,    fs->voltage);
+    out->icodes    = DECODE(0x2B, FMT(icodes),    ACS_ICODES_FRAC,    fs->current);
+    out->pinstant  = DECODE(0x2C, FMT(pinstant),  ACS_PINSTANT_FRAC,  fs->power);
+
+#undef DECODE
+}
\ No newline at end of file
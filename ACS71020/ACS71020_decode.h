@@ -0,0 +1,131 @@
+/**
+ * @file ACS71020_decode.h
+ * @author Usman Mehmood (usmanmehmood55@gmail.com)
+ * @brief Conversion of raw measurement registers to engineering units. The
+ * batch functions take one array per register and write one array per
+ * field (structure of arrays), so that each field can be decoded with SIMD
+ * over many recorded frames at once.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _ACS71020_decode_H_
+#define _ACS71020_decode_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "ACS71020.h"
+
+/*
+ * Fixed point formats, from the register descriptions in ACS71020_volatile.h.
+ * A field's value is its code times 2^-FRAC times the full-scale multiplier.
+ */
+#define ACS_IRMS_FRAC       14
+#define ACS_VRMS_FRAC       15
+#define ACS_PACTIVE_FRAC    15
+#define ACS_PAPPARENT_FRAC  15
+#define ACS_PIMAG_FRAC      15
+#define ACS_PFACTOR_FRAC     9
+#define ACS_VCODES_FRAC     16
+#define ACS_ICODES_FRAC     15
+#define ACS_PINSTANT_FRAC   29
+
+/**
+ * @brief Full-scale multipliers the device is trimmed for. For example a part
+ * trimmed to 30 A with a divider giving 275 mV at 250 V has current = 30,
+ * voltage = 250 and power = 7500.
+ */
+typedef struct
+{
+    double current; // A
+    double voltage; // V
+    double power;   // W, VA or VAR
+} acs_full_scale_t;
+
+/**
+ * @brief Raw register arrays, all of the same length. Any pointer may be NULL
+ * in which case the fields of that register are skipped.
+ */
+typedef struct
+{
+    const acs_0x20_t *reg_0x20; // irms, vrms
+    const acs_0x21_t *reg_0x21; // pactive
+    const acs_0x22_t *reg_0x22; // papparent
+    const acs_0x23_t *reg_0x23; // pimag
+    const acs_0x24_t *reg_0x24; // pfactor
+    const acs_0x2A_t *reg_0x2A; // vcodes
+    const acs_0x2B_t *reg_0x2B; // icodes
+    const acs_0x2C_t *reg_0x2C; // pinstant
+} acs_raw_batch_t;
+
+/**
+ * @brief Output arrays in engineering units. A NULL pointer skips that field.
+ */
+typedef struct
+{
+    float *irms;        // A
+    float *vrms;        // V
+    float *pactive;     // W
+    float *papparent;   // VA
+    float *pimag;       // VAR
+    float *pfactor;     // -2 to ~2
+    float *vcodes;      // V
+    float *icodes;      // A
+    float *pinstant;    // W
+} acs_decoded_f32_t;
+
+typedef struct
+{
+    double *irms;
+    double *vrms;
+    double *pactive;
+    double *papparent;
+    double *pimag;
+    double *pfactor;
+    double *vcodes;
+    double *icodes;
+    double *pinstant;
+} acs_decoded_f64_t;
+
+/**
+ * @brief One snapshot in engineering units.
+ */
+typedef struct
+{
+    float irms;
+    float vrms;
+    float pactive;
+    float papparent;
+    float pimag;
+    float pfactor;
+    float vcodes;
+    float icodes;
+    float pinstant;
+} acs_measurement_t;
+
+/**
+ * @brief Decodes count frames into single precision arrays. Uses AVX2, SSE2 or
+ * NEON when the compiler targets them, and a scalar loop otherwise.
+ * @return ACS_OK or ACS_ERR_PARAM
+ */
+int acs_decode_batch_f32(const acs_raw_batch_t *raw, size_t count,
+                         const acs_full_scale_t *fs, const acs_decoded_f32_t *out);
+
+/**
+ * @brief Decodes count frames into double precision arrays.
+ * @return ACS_OK or ACS_ERR_PARAM
+ */
+int acs_decode_batch_f64(const acs_raw_batch_t *raw, size_t count,
+                         const acs_full_scale_t *fs, const acs_decoded_f64_t *out);
+
+/**
+ * @brief Decodes a single snapshot.
+ */
+void acs_decode_snapshot(const acs_snapshot_t *snap, const acs_full_scale_t *fs,
+                         acs_measurement_t *out);
+
+#endif // _ACS71020_decode_H_
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include "ACS71020_transport.h"
+#include "ACS71020_ecc.h"
+
+/*
+ * Hamming layout: codeword positions 1 to 31, check bits at the powers of two
+ * and the 26 data bits, LSB first, at the remaining positions. The syndrome
+ * of a word is the xor of the positions of its set data bits, precomputed
+ * here per data byte.
+ */
+static const uint8_t syndrome_byte0[256] =
+{
+    0x00, 0x03, 0x05, 0x06, 0x06, 0x05, 0x03, 0x00, 0x07, 0x04, 0x02, 0x01, 0x01, 0x02, 0x04, 0x07,
+    0x09, 0x0A, 0x0C, 0x0F, 0x0F, 0x0C, 0x0A, 0x09, 0x0E, 0x0D, 0x0B, 0x08, 0x08, 0x0B, 0x0D, 0x0E,
+    0x0A, 0x09, 0x0F, 0x0C, 0x0C, 0x0F, 0x09, 0x0A, 0x0D, 0x0E, 0x08, 0x0B, 0x0B, 0x08, 0x0E, 0x0D,
+    0x03, 0x00, 0x06, 0x05, 0x05, 0x06, 0x00, 0x03, 0x04, 0x07, 0x01, 0x02, 0x02, 0x01, 0x07, 0x04,
+    0x0B, 0x08, 0x0E, 0x0D, 0x0D, 0x0E, 0x08, 0x0B, 0x0C, 0x0F, 0x09, 0x0A, 0x0A, 0x09, 0x0F, 0x0C,
+    0x02, 0x01, 0x07, 0x04, 0x04, 0x07, 0x01, 0x02, 0x05, 0x06, 0x00, 0x03, 0x03, 0x00, 0x06, 0x05,
+    0x01, 0x02, 0x04, 0x07, 0x07, 0x04, 0x02, 0x01, 0x06, 0x05, 0x03, 0x00, 0x00, 0x03, 0x05, 0x06,
+    0x08, 0x0B, 0x0D, 0x0E, 0x0E, 0x0D, 0x0B, 0x08, 0x0F, 0x0C, 0x0A, 0x09, 0x09, 0x0A, 0x0C, 0x0F,
+    0x0C, 0x0F, 0x09, 0x0A, 0x0A, 0x09, 0x0F, 0x0C, 0x0B, 0x08, 0x0E, 0x0D, 0x0D, 0x0E, 0x08, 0x0B,
+    0x05, 0x06, 0x00, 0x03, 0x03, 0x00, 0x06, 0x05, 0x02, 0x01, 0x07, 0x04, 0x04, 0x07, 0x01, 0x02,
+    0x06, 0x05, 0x03, 0x00, 0x00, 0x03, 0x05, 0x06, 0x01, 0x02, 0x04, 0x07, 0x07, 0x04, 0x02, 0x01,
+    0x0F, 0x0C, 0x0A, 0x09, 0x09, 0x0A, 0x0C, 0x0F, 0x08, 0x0B, 0x0D, 0x0E, 0x0E, 0x0D, 0x0B, 0x08,
+    0x07, 0x04, 0x02, 0x01, 0x01, 0x02, 0x04, 0x07, 0x00, 0x03, 0x05, 0x06, 0x06, 0x05, 0x03, 0x00,
+    0x0E, 0x0D, 0x0B, 0x08, 0x08, 0x0B, 0x0D, 0x0E, 0x09, 0x0A, 0x0C, 0x0F, 0x0F, 0x0C, 0x0A, 0x09,
+    0x0D, 0x0E, 0x08, 0x0B, 0x0B, 0x08, 0x0E, 0x0D, 0x0A, 0x09, 0x0F, 0x0C, 0x0C, 0x0F, 0x09, 0x0A,
+    0x04, 0x07, 0x01, 0x02, 0x02, 0x01, 0x07, 0x04, 0x03, 0x00, 0x06, 0x05, 0x05, 0x06, 0x00, 0x03,
+};
+
+static const uint8_t syndrome_byte1[256] =
+{
+    0x00, 0x0D, 0x0E, 0x03, 0x0F, 0x02, 0x01, 0x0C, 0x11, 0x1C, 0x1F, 0x12, 0x1E, 0x13, 0x10, 0x1D,
+    0x12, 0x1F, 0x1C, 0x11, 0x1D, 0x10, 0x13, 0x1E, 0x03, 0x0E, 0x0D, 0x00, 0x0C, 0x01, 0x02, 0x0F,
+    0x13, 0x1E, 0x1D, 0x10, 0x1C, 0x11, 0x12, 0x1F, 0x02, 0x0F, 0x0C, 0x01, 0x0D, 0x00, 0x03, 0x0E,
+    0x01, 0x0C, 0x0F, 0x02, 0x0E, 0x03, 0x00, 0x0D, 0x10, 0x1D, 0x1E, 0x13, 0x1F, 0x12, 0x11, 0x1C,
+    0x14, 0x19, 0x1A, 0x17, 0x1B, 0x16, 0x15, 0x18, 0x05, 0x08, 0x0B, 0x06, 0x0A, 0x07, 0x04, 0x09,
+    0x06, 0x0B, 0x08, 0x05, 0x09, 0x04, 0x07, 0x0A, 0x17, 0x1A, 0x19, 0x14, 0x18, 0x15, 0x16, 0x1B,
+    0x07, 0x0A, 0x09, 0x04, 0x08, 0x05, 0x06, 0x0B, 0x16, 0x1B, 0x18, 0x15, 0x19, 0x14, 0x17, 0x1A,
+    0x15, 0x18, 0x1B, 0x16, 0x1A, 0x17, 0x14, 0x19, 0x04, 0x09, 0x0A, 0x07, 0x0B, 0x06, 0x05, 0x08,
+    0x15, 0x18, 0x1B, 0x16, 0x1A, 0x17, 0x14, 0x19, 0x04, 0x09, 0x0A, 0x07, 0x0B, 0x06, 0x05, 0x08,
+    0x07, 0x0A, 0x09, 0x04, 0x08, 0x05, 0x06, 0x0B, 0x16, 0x1B, 0x18, 0x15, 0x19, 0x14, 0x17, 0x1A,
+    0x06, 0x0B, 0x08, 0x05, 0x09, 0x04, 0x07, 0x0A, 0x17, 0x1A, 0x19, 0x14, 0x18, 0x15, 0x16, 0x1B,
+    0x14, 0x19, 0x1A, 0x17, 0x1B, 0x16, 0x15, 0x18, 0x05, 0x08, 0x0B, 0x06, 0x0A, 0x07, 0x04, 0x09,
+    0x01, 0x0C, 0x0F, 0x02, 0x0E, 0x03, 0x00, 0x0D, 0x10, 0x1D, 0x1E, 0x13, 0x1F, 0x12, 0x11, 0x1C,
+    0x13, 0x1E, 0x1D, 0x10, 0x1C, 0x11, 0x12, 0x1F, 0x02, 0x0F, 0x0C, 0x01, 0x0D, 0x00, 0x03, 0x0E,
+    0x12, 0x1F, 0x1C, 0x11, 0x1D, 0x10, 0x13, 0x1E, 0x03, 0x0E, 0x0D, 0x00, 0x0C, 0x01, 0x02, 0x0F,
+    0x00, 0x0D, 0x0E, 0x03, 0x0F, 0x02, 0x01, 0x0C, 0x11, 0x1C, 0x1F, 0x12, 0x1E, 0x13, 0x10, 0x1D,
+};
+
+static const uint8_t syndrome_byte2[256] =
+{
+    0x00, 0x16, 0x17, 0x01, 0x18, 0x0E, 0x0F, 0x19, 0x19, 0x0F, 0x0E, 0x18, 0x01, 0x17, 0x16, 0x00,
+    0x1A, 0x0C, 0x0D, 0x1B, 0x02, 0x14, 0x15, 0x03, 0x03, 0x15, 0x14, 0x02, 0x1B, 0x0D, 0x0C, 0x1A,
+    0x1B, 0x0D, 0x0C, 0x1A, 0x03, 0x15, 0x14, 0x02, 0x02, 0x14, 0x15, 0x03, 0x1A, 0x0C, 0x0D, 0x1B,
+    0x01, 0x17, 0x16, 0x00, 0x19, 0x0F, 0x0E, 0x18, 0x18, 0x0E, 0x0F, 0x19, 0x00, 0x16, 0x17, 0x01,
+    0x1C, 0x0A, 0x0B, 0x1D, 0x04, 0x12, 0x13, 0x05, 0x05, 0x13, 0x12, 0x04, 0x1D, 0x0B, 0x0A, 0x1C,
+    0x06, 0x10, 0x11, 0x07, 0x1E, 0x08, 0x09, 0x1F, 0x1F, 0x09, 0x08, 0x1E, 0x07, 0x11, 0x10, 0x06,
+    0x07, 0x11, 0x10, 0x06, 0x1F, 0x09, 0x08, 0x1E, 0x1E, 0x08, 0x09, 0x1F, 0x06, 0x10, 0x11, 0x07,
+    0x1D, 0x0B, 0x0A, 0x1C, 0x05, 0x13, 0x12, 0x04, 0x04, 0x12, 0x13, 0x05, 0x1C, 0x0A, 0x0B, 0x1D,
+    0x1D, 0x0B, 0x0A, 0x1C, 0x05, 0x13, 0x12, 0x04, 0x04, 0x12, 0x13, 0x05, 0x1C, 0x0A, 0x0B, 0x1D,
+    0x07, 0x11, 0x10, 0x06, 0x1F, 0x09, 0x08, 0x1E, 0x1E, 0x08, 0x09, 0x1F, 0x06, 0x10, 0x11, 0x07,
+    0x06, 0x10, 0x11, 0x07, 0x1E, 0x08, 0x09, 0x1F, 0x1F, 0x09, 0x08, 0x1E, 0x07, 0x11, 0x10, 0x06,
+    0x1C, 0x0A, 0x0B, 0x1D, 0x04, 0x12, 0x13, 0x05, 0x05, 0x13, 0x12, 0x04, 0x1D, 0x0B, 0x0A, 0x1C,
+    0x01, 0x17, 0x16, 0x00, 0x19, 0x0F, 0x0E, 0x18, 0x18, 0x0E, 0x0F, 0x19, 0x00, 0x16, 0x17, 0x01,
+    0x1B, 0x0D, 0x0C, 0x1A, 0x03, 0x15, 0x14, 0x02, 0x02, 0x14, 0x15, 0x03, 0x1A, 0x0C, 0x0D, 0x1B,
+    0x1A, 0x0C, 0x0D, 0x1B, 0x02, 0x14, 0x15, 0x03, 0x03, 0x15, 0x14, 0x02, 0x1B, 0x0D, 0x0C, 0x1A,
+    0x00, 0x16, 0x17, 0x01, 0x18, 0x0E, 0x0F, 0x19, 0x19, 0x0F, 0x0E, 0x18, 0x01, 0x17, 0x16, 0x00,
+};
+
+static const uint8_t syndrome_byte3[4] =
+{
+    0x00, 0x1E, 0x1F, 0x01,
+};
+
+static const uint8_t position_to_bit[32] =
+{
+    0xFF, 0xFF, 0xFF, 0x00, 0xFF, 0x01, 0x02, 0x03, 0xFF, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A,
+    0xFF, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19,
+};
+
+#define ACS_ECC_SYNDROME_MASK   0x1FU
+#define ACS_ECC_PARITY_BIT      0x20U
+#define ACS_ECC_CHECK_MASK      0x3FU
+
+static inline uint32_t parity32(uint32_t x)
+{
+    x ^= x >> 16;
+    x ^= x >> 8;
+    x ^= x >> 4;
+    x ^= x >> 2;
+    x ^= x >> 1;
+    return x & 1U;
+}
+
+static inline uint8_t syndrome(uint32_t data)
+{
+    return syndrome_byte0[data & 0xFFU]
+         ^ syndrome_byte1[(data >> 8) & 0xFFU]
+         ^ syndrome_byte2[(data >> 16) & 0xFFU]
+         ^ syndrome_byte3[(data >> 24) & 0x03U];
+}
+
+uint8_t acs_ecc_encode(uint32_t data)
+{
+    data &= ACS_EEPROM_DATA_MASK;
+
+    uint8_t check = syndrome(data);
+    uint32_t overall = parity32(data) ^ parity32(check);
+    return (uint8_t)(check | (overall ? ACS_ECC_PARITY_BIT : 0U));
+}
+
+uint32_t acs_ecc_codeword(uint32_t data)
+{
+    return acs_ecc_wire_frame(data) | acs_ecc_encode(data);
+}
+
+acs_eec_t acs_ecc_verify(uint32_t codeword, uint32_t *data)
+{
+    uint32_t d = codeword >> ACS_EEPROM_DATA_SHIFT;
+    uint8_t check = (uint8_t)(codeword & ACS_ECC_CHECK_MASK);
+    uint8_t s = syndrome(d) ^ (check & ACS_ECC_SYNDROME_MASK);
+    uint32_t odd = parity32(codeword);
+    acs_eec_t result = ACS_EEC_OK;
+
+    if (odd)
+    {
+        // Single bit error. A zero syndrome means the overall parity bit
+        // itself, a power of two a Hamming bit, anything else a data bit.
+        uint8_t bit = position_to_bit[s];
+        if (bit != 0xFFU)
+            d ^= 1UL << bit;
+        result = ACS_EEC_CORRECTED;
+    }
+    else if (s != 0U)
+    {
+        result = ACS_EEC_UNCORRECTABLE;
+    }
+
+    if (data != NULL)
+        *data = d;
+    return result;
+}
+
+size_t acs_ecc_verify_batch(const uint32_t *codewords, size_t count,
+                            uint8_t *status, uint32_t *data)
+{
+    size_t bad = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        acs_eec_t r = acs_ecc_verify(codewords[i], data != NULL ? &data[i] : NULL);
+        bad += (r == ACS_EEC_UNCORRECTABLE);
+        if (status != NULL)
+            status[i] = (uint8_t)r;
+    }
+    return bad;
+}
+
+size_t acs_ecc_reported_batch(const uint32_t *frames, size_t count, uint8_t *status)
+{
+    size_t bad = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        acs_eec_t r = acs_ecc_reported(frames[i]);
+        bad += (r == ACS_EEC_UNCORRECTABLE);
+        if (status != NULL)
+            status[i] = (uint8_t)r;
+    }
+    return bad;
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+/**
+ * @file ACS71020_ecc.h
+ * @author Usman Mehmood (usmanmehmood55@gmail.com)
+ * @brief Error correction for EEPROM words. Each EEPROM word holds 26 bits of
+ * data. The device keeps its own check bits and reports the outcome of
+ * every read in the 2-bit EEC field of the frame (see eeprom_reg_t), so a
+ * bulk read can be screened without reading anything twice.
+ * For configuration images and dumps kept on the host, the same protection
+ * is provided by a Hamming SEC-DED code: 5 Hamming bits and one overall
+ * parity bit, stored in the 6 low bits of the word below the data.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _ACS71020_ecc_H_
+#define _ACS71020_ecc_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "ACS71020_fields.h"
+
+#define ACS_EEPROM_DATA_BITS    26U
+#define ACS_EEPROM_DATA_SHIFT   6U
+#define ACS_EEPROM_DATA_MASK    0x03FFFFFFU
+
+/**
+ * @brief Values of the EEC field, also used for host side verification.
+ */
+typedef enum
+{
+    ACS_EEC_OK              = 0, // 00 No error
+    ACS_EEC_CORRECTED       = 1, // 01 Error detected and message corrected
+    ACS_EEC_UNCORRECTABLE   = 2, // 10 Uncorrectable error
+    ACS_EEC_DONT_CARE       = 3, // 11 Don't care
+} acs_eec_t;
+
+/**
+ * @brief Frame to write to the device for 26 bits of data. The EEC and
+ * reserved bits are left clear, the device computes its own check bits.
+ */
+static inline uint32_t acs_ecc_wire_frame(uint32_t data)
+{
+    return (data & ACS_EEPROM_DATA_MASK) << ACS_EEPROM_DATA_SHIFT;
+}
+
+/**
+ * @brief EEC status the device reported for a frame it returned.
+ */
+static inline acs_eec_t acs_ecc_reported(uint32_t frame)
+{
+    return (acs_eec_t)eeprom_frame_EEC_get(frame);
+}
+
+/**
+ * @brief Computes the 6 check bits of 26 bits of data. Four table lookups.
+ */
+uint8_t acs_ecc_encode(uint32_t data);
+
+/**
+ * @brief Builds a host side codeword, data in bits 6 to 31 and the check
+ * bits in bits 0 to 5.
+ */
+uint32_t acs_ecc_codeword(uint32_t data);
+
+/**
+ * @brief Checks a host side codeword, correcting a single flipped bit.
+ * @param data receives the (corrected) 26 data bits, may be NULL
+ * @return ACS_EEC_OK, ACS_EEC_CORRECTED or ACS_EEC_UNCORRECTABLE
+ */
+acs_eec_t acs_ecc_verify(uint32_t codeword, uint32_t *data);
+
+/**
+ * @brief acs_ecc_verify() over a whole dump.
+ * @param status one acs_eec_t per word, may be NULL
+ * @param data corrected data per word, may be NULL
+ * @return number of uncorrectable words
+ */
+size_t acs_ecc_verify_batch(const uint32_t *codewords, size_t count,
+                            uint8_t *status, uint32_t *data);
+
+/**
+ * @brief Screens frames read from the device by their reported EEC field.
+ * @param status one acs_eec_t per frame, may be NULL
+ * @return number of frames flagged uncorrectable
+ */
+size_t acs_ecc_reported_batch(const uint32_t *frames, size_t count, uint8_t *status);
+
+#endif // _ACS71020_ecc_H_
\ No newline at end of file
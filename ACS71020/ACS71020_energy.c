@@ -0,0 +1,133 @@
+#include <string.h>
+#include "ACS71020_energy.h"
+
+#define ENERGY_STATE_MAGIC   0x47524E45U // "ENRG" in little endian
+#define ENERGY_STATE_VERSION 2U    // 2: checksum over fields, not bytes
+
+#define FRAC_MASK   (((uint32_t)1U << ACS_ENERGY_FRAC_BITS) - 1U)
+
+// pactive has 15 fractional bits, the accumulators 29
+#define PACTIVE_TO_FRAC_SHIFT (ACS_ENERGY_FRAC_BITS - 15U)
+
+/**
+ * @brief Adds magnitude * dt, magnitude in 2^-29 of full scale. The product
+ * is below 2^63 for any 32-bit magnitude up to 2^31 and dt up to 2^32 us.
+ */
+static inline void accumulate(acs_energy_reg_t *reg, uint32_t magnitude, uint32_t dt_us)
+{
+    uint64_t sum = (uint64_t)magnitude * dt_us + reg->frac;
+
+    reg->units += sum >> ACS_ENERGY_FRAC_BITS;
+    reg->frac   = (uint32_t)sum & FRAC_MASK;
+}
+
+/**
+ * @brief Advances the timestamp and returns the interval to integrate, or 0
+ * for the first update and for gaps.
+ */
+static uint32_t interval(acs_energy_t *energy, uint64_t now_us)
+{
+    bool valid = energy->started && now_us >= energy->last_us;
+    uint64_t dt = now_us - energy->last_us;
+
+    energy->last_us = now_us;
+    energy->started = true;
+
+    if (!valid)
+        return 0U;
+    if (dt > energy->max_dt_us)
+    {
+        energy->gaps++;
+        return 0U;
+    }
+    energy->updates++;
+    return (uint32_t)dt;
+}
+
+void acs_energy_init(acs_energy_t *energy, uint32_t max_dt_us)
+{
+    memset(energy, 0, sizeof(*energy));
+    energy->max_dt_us = max_dt_us;
+}
+
+void acs_energy_update(acs_energy_t *energy, const acs_snapshot_t *snap, uint64_t now_us)
+{
+    uint32_t dt = interval(energy, now_us);
+    if (dt == 0U)
+        return;
+
+    int32_t pactive = acs_0x21_pactive_sget(snap->regs.reg_0x21.register_value);
+    uint32_t magnitude = (uint32_t)(pactive < 0 ? -pactive : pactive) << PACTIVE_TO_FRAC_SHIFT;
+
+    if (acs_0x2D_pospf_get(snap->regs.reg_0x2D.register_value))
+        accumulate(&energy->imported, magnitude, dt);
+    else
+        accumulate(&energy->exported, magnitude, dt);
+}
+
+void acs_energy_update_instant(acs_energy_t *energy, uint32_t reg_0x2C, uint64_t now_us)
+{
+    uint32_t dt = interval(energy, now_us);
+    if (dt == 0U)
+        return;
+
+    int32_t pinstant = acs_0x2C_pinstant_sget(reg_0x2C);
+
+    if (pinstant >= 0)
+        accumulate(&energy->imported, (uint32_t)pinstant, dt);
+    else
+        accumulate(&energy->exported, 0U - (uint32_t)pinstant, dt);
+}
+
+double acs_energy_wh(const acs_energy_reg_t *reg, double full_scale_power)
+{
+    double units = (double)reg->units + (double)reg->frac / (double)(FRAC_MASK + 1U);
+    return units * full_scale_power / 3.6e9;
+}
+
+static uint32_t fnv1a(uint32_t hash, uint64_t value, uint8_t bytes)
+{
+    for (uint8_t i = 0; i < bytes; i++)
+        hash = (hash ^ (uint8_t)(value >> (8U * i))) * 16777619U;
+    return hash;
+}
+
+/**
+ * @brief FNV-1a over the fields before the checksum, one by one, LSB first,
+ * so that struct padding, whatever it holds, does not take part.
+ */
+static uint32_t state_checksum(const acs_energy_state_t *state)
+{
+    uint32_t hash = 2166136261U;
+
+    hash = fnv1a(hash, state->magic, 4U);
+    hash = fnv1a(hash, state->version, 4U);
+    hash = fnv1a(hash, state->imported.units, 8U);
+    hash = fnv1a(hash, state->imported.frac, 4U);
+    hash = fnv1a(hash, state->exported.units, 8U);
+    hash = fnv1a(hash, state->exported.frac, 4U);
+    return hash;
+}
+
+void acs_energy_save(const acs_energy_t *energy, acs_energy_state_t *state)
+{
+    memset(state, 0, sizeof(*state));
+    state->magic    = ENERGY_STATE_MAGIC;
+    state->version  = ENERGY_STATE_VERSION;
+    state->imported = energy->imported;
+    state->exported = energy->exported;
+    state->checksum = state_checksum(state);
+}
+
+int acs_energy_restore(acs_energy_t *energy, const acs_energy_state_t *state)
+{
+    if (state->magic != ENERGY_STATE_MAGIC || state->version != ENERGY_STATE_VERSION ||
+        state->checksum != state_checksum(state) ||
+        state->imported.frac > FRAC_MASK || state->exported.frac > FRAC_MASK)
+        return ACS_ERR_PARAM;
+
+    energy->imported = state->imported;
+    energy->exported = state->exported;
+    energy->started  = false;
+    return ACS_OK;
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+/**
+ * @file ACS71020_energy.h
+ * @author Usman Mehmood (usmanmehmood55@gmail.com)
+ * @brief Energy accumulation. Power is integrated over time entirely in
+ * integers, so nothing is lost to float rounding however high the update
+ * rate. The accumulators count full-scale power times microseconds, with
+ * 29 fractional bits, which is exactly the resolution of pinstant; pactive
+ * is 15 fractional bits and is shifted up. Import and export are kept apart,
+ * split by pospf in 0x2D.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _ACS71020_energy_H_
+#define _ACS71020_energy_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "ACS71020.h"
+
+#define ACS_ENERGY_FRAC_BITS 29U
+
+/**
+ * @brief Energy in units of full-scale power times one microsecond. frac
+ * holds the remainder in 2^-29 of a unit and is always below 2^29.
+ */
+typedef struct
+{
+    uint64_t units;
+    uint32_t frac;
+} acs_energy_reg_t;
+
+typedef struct
+{
+    acs_energy_reg_t imported;  // pospf = 1, consumed
+    acs_energy_reg_t exported;  // pospf = 0, generated
+
+    uint64_t last_us;
+    uint32_t max_dt_us;         // Longer intervals are not integrated
+    bool     started;
+
+    uint32_t updates;
+    uint32_t gaps;              // Intervals dropped for exceeding max_dt_us
+} acs_energy_t;
+
+/**
+ * @brief Persistent copy of the accumulators.
+ */
+typedef struct
+{
+    uint32_t         magic;
+    uint32_t         version;
+    acs_energy_reg_t imported;
+    acs_energy_reg_t exported;
+    uint32_t         checksum;
+} acs_energy_state_t;
+
+/**
+ * @param max_dt_us longest interval to integrate over, so that a stalled
+ * reader does not book a whole outage at the last known power
+ */
+void acs_energy_init(acs_energy_t *energy, uint32_t max_dt_us);
+
+/**
+ * @brief Integrates pactive of a snapshot over the time since the previous
+ * update. Import or export is chosen by pospf. Cheap enough for an ISR.
+ */
+void acs_energy_update(acs_energy_t *energy, const acs_snapshot_t *snap, uint64_t now_us);
+
+/**
+ * @brief Integrates a raw 0x2C pinstant word instead, for waveform rate
+ * updates. Positive power is import. Do not mix with acs_energy_update() on
+ * the same accumulator.
+ */
+void acs_energy_update_instant(acs_energy_t *energy, uint32_t reg_0x2C, uint64_t now_us);
+
+/**
+ * @brief Converts an accumulator to watt hours.
+ * @param full_scale_power the full-scale power multiplier in W
+ */
+double acs_energy_wh(const acs_energy_reg_t *reg, double full_scale_power);
+
+/**
+ * @brief Copies the accumulators into a checksummed state for storage.
+ */
+void acs_energy_save(const acs_energy_t *energy, acs_energy_state_t *state);
+
+/**
+ * @brief Restores the accumulators from a stored state. Timing restarts
+ * with the next update.
+ * @return ACS_OK, or ACS_ERR_PARAM if the state is corrupt or of another
+ * version
+ */
+int acs_energy_restore(acs_energy_t *energy, const acs_energy_state_t *state);
+
+#endif // _ACS71020_energy_H_
\ No newline at end of file
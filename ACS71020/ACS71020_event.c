@@ -0,0 +1,290 @@
+#include <string.h>
+#include "ACS71020_event.h"
+
+// Codes per unit of full scale
+#define VRMS_SCALE   32768.0f   // Q15
+#define IRMS_SCALE   16384.0f   // Q14
+#define VCODES_SCALE 65536.0f   // Q16
+#define ICODES_SCALE 32768.0f   // Q15
+
+static const float detector_scale[ACS_EVENT_HW_OVERVOLTAGE] =
+{
+    [ACS_EVENT_OVERVOLTAGE_RMS]    = VRMS_SCALE,
+    [ACS_EVENT_UNDERVOLTAGE_RMS]   = VRMS_SCALE,
+    [ACS_EVENT_OVERCURRENT_RMS]    = IRMS_SCALE,
+    [ACS_EVENT_OVERVOLTAGE_PEAK]   = VCODES_SCALE,
+    [ACS_EVENT_UNDERVOLTAGE_PEAK]  = VCODES_SCALE,
+    [ACS_EVENT_OVERCURRENT_PEAK]   = ICODES_SCALE,
+};
+
+static uint32_t to_codes(float fraction, float scale)
+{
+    if (fraction <= 0.0f)
+        return 0U;
+
+    float codes = fraction * scale + 0.5f;
+    return codes >= 4294967040.0f ? 0xFFFFFF00U : (uint32_t)codes;
+}
+
+static int detector_init(acs_event_detector_t *det, const acs_event_threshold_t *th,
+                         bool over, float scale)
+{
+    memset(det, 0, sizeof(*det));
+    if (!th->enabled)
+        return ACS_OK;
+
+    if (over ? th->clear > th->set : th->clear < th->set)
+        return ACS_ERR_PARAM;
+
+    det->enabled     = true;
+    det->over        = over;
+    det->set         = to_codes(th->set, scale);
+    det->clear       = to_codes(th->clear, scale);
+    det->trip_count  = th->trip_count > 0U ? th->trip_count : 1U;
+    det->clear_count = th->clear_count > 0U ? th->clear_count : 1U;
+    return ACS_OK;
+}
+
+int acs_event_init(acs_event_engine_t *engine, const acs_device_t *dev,
+                   const acs_event_config_t *config, acs_event_callback_t callback,
+                   void *user)
+{
+    const acs_event_threshold_t *th[ACS_EVENT_HW_OVERVOLTAGE] =
+    {
+        &config->overvoltage_rms,  &config->undervoltage_rms,  &config->overcurrent_rms,
+        &config->overvoltage_peak, &config->undervoltage_peak, &config->overcurrent_peak,
+    };
+
+    if (engine == NULL || config == NULL || callback == NULL)
+        return ACS_ERR_PARAM;
+
+    memset(engine, 0, sizeof(*engine));
+    engine->dev                = dev;
+    engine->callback           = callback;
+    engine->user               = user;
+    engine->auto_clear_latched = config->auto_clear_latched;
+
+    for (int k = 0; k < ACS_EVENT_HW_OVERVOLTAGE; k++)
+    {
+        bool over = k != ACS_EVENT_UNDERVOLTAGE_RMS && k != ACS_EVENT_UNDERVOLTAGE_PEAK;
+        if (detector_init(&engine->detectors[k], th[k], over, detector_scale[k]) != ACS_OK)
+            return ACS_ERR_PARAM;
+    }
+
+    // Crossings closer than half a half-cycle are noise, and a half-cycle
+    // that never ends is a collapsed voltage, still to be evaluated
+    bool peaks = config->overvoltage_peak.enabled || config->undervoltage_peak.enabled ||
+                 config->overcurrent_peak.enabled;
+    if (peaks)
+    {
+        if (config->sample_hz == 0U || config->line_hz <= 0.0f)
+            return ACS_ERR_PARAM;
+
+        engine->sample_hz = config->sample_hz;
+
+        float halfcycle = (float)config->sample_hz / (2.0f * config->line_hz);
+        engine->halfcycle_min = (uint32_t)(halfcycle * 0.5f);
+        engine->halfcycle_max = (uint32_t)(halfcycle * 1.5f) + 1U;
+    }
+
+    return ACS_OK;
+}
+
+static void dispatch(acs_event_engine_t *engine, acs_event_kind_t kind, bool active,
+                     float level, uint64_t now_us)
+{
+    const acs_event_t event = { kind, active, level, now_us };
+
+    if (active)
+        engine->counts[kind]++;
+    engine->callback(engine->user, &event);
+}
+
+/**
+ * @brief Debounces one condition. While inactive, trip has to hold for
+ * trip_count calls in a row, while active release for clear_count calls.
+ */
+static void detect(acs_event_engine_t *engine, acs_event_kind_t kind, bool trip,
+                   bool release, uint32_t value, uint64_t now_us)
+{
+    acs_event_detector_t *det = &engine->detectors[kind];
+
+    if (!(det->active ? release : trip))
+    {
+        det->run = 0U;
+        return;
+    }
+
+    if (++det->run < (det->active ? det->clear_count : det->trip_count))
+        return;
+
+    det->run    = 0U;
+    det->active = !det->active;
+    dispatch(engine, kind, det->active, (float)value / detector_scale[kind], now_us);
+}
+
+static inline bool beyond_set(const acs_event_detector_t *det, uint32_t value)
+{
+    return det->over ? value >= det->set : value <= det->set;
+}
+
+static inline bool within_clear(const acs_event_detector_t *det, uint32_t value)
+{
+    return det->over ? value < det->clear : value > det->clear;
+}
+
+static void evaluate(acs_event_engine_t *engine, acs_event_kind_t kind, uint32_t value,
+                     uint64_t now_us)
+{
+    const acs_event_detector_t *det = &engine->detectors[kind];
+
+    if (det->enabled)
+        detect(engine, kind, beyond_set(det, value), within_clear(det, value), value, now_us);
+}
+
+int acs_event_flags(acs_event_engine_t *engine, uint32_t reg_0x2D, uint64_t now_us)
+{
+    static const struct
+    {
+        acs_event_kind_t kind;
+        uint32_t (*get)(uint32_t reg);
+    } flags[] =
+    {
+        { ACS_EVENT_HW_OVERVOLTAGE,    acs_0x2D_overvoltage_get },
+        { ACS_EVENT_HW_UNDERVOLTAGE,   acs_0x2D_undervoltage_get },
+        { ACS_EVENT_HW_FAULT,          acs_0x2D_faultout_get },
+        { ACS_EVENT_HW_FAULT_LATCHED,  acs_0x2D_faultlatched_get },
+    };
+
+    for (size_t f = 0; f < sizeof(flags) / sizeof(flags[0]); f++)
+    {
+        uint32_t bit = 1U << f;
+        uint32_t now = flags[f].get(reg_0x2D) ? bit : 0U;
+
+        if ((engine->flags & bit) != now)
+            dispatch(engine, flags[f].kind, now != 0U, now != 0U ? 1.0f : 0.0f, now_us);
+        engine->flags = (engine->flags & ~bit) | now;
+    }
+
+    // Writing 1 clears the latch, its release is seen on the next read
+    if (engine->auto_clear_latched && engine->dev != NULL && acs_0x2D_faultlatched_get(reg_0x2D))
+    {
+        int ret = acs_write_register(engine->dev, ACS_REG_MEAS_LAST,
+                                     acs_0x2D_faultlatched_set(0U, 1U));
+        if (ret != ACS_OK)
+        {
+            engine->bus_errors++;
+            return ret;
+        }
+    }
+
+    return ACS_OK;
+}
+
+int acs_event_snapshot(acs_event_engine_t *engine, const acs_snapshot_t *snap, uint64_t now_us)
+{
+    uint32_t vrms = acs_0x20_vrms_get(snap->regs.reg_0x20.register_value);
+    uint32_t irms = acs_0x20_irms_get(snap->regs.reg_0x20.register_value);
+
+    evaluate(engine, ACS_EVENT_OVERVOLTAGE_RMS, vrms, now_us);
+    evaluate(engine, ACS_EVENT_UNDERVOLTAGE_RMS, vrms, now_us);
+    evaluate(engine, ACS_EVENT_OVERCURRENT_RMS, irms, now_us);
+
+    return acs_event_flags(engine, snap->regs.reg_0x2D.register_value, now_us);
+}
+
+int acs_event_poll(acs_event_engine_t *engine, uint64_t now_us)
+{
+    uint32_t reg_0x2D;
+
+    int ret = acs_read_register(engine->dev, ACS_REG_MEAS_LAST, &reg_0x2D);
+    if (ret != ACS_OK)
+    {
+        engine->bus_errors++;
+        return ret;
+    }
+    return acs_event_flags(engine, reg_0x2D, now_us);
+}
+
+static void end_halfcycle(acs_event_engine_t *engine, uint64_t now_us)
+{
+    const acs_event_detector_t *ov = &engine->detectors[ACS_EVENT_OVERVOLTAGE_PEAK];
+    const acs_event_detector_t *oc = &engine->detectors[ACS_EVENT_OVERCURRENT_PEAK];
+
+    // Over-detectors trip per sample, they release on a whole half-cycle
+    if (ov->enabled && ov->active)
+        detect(engine, ACS_EVENT_OVERVOLTAGE_PEAK, false, within_clear(ov, engine->v_peak),
+               engine->v_peak, now_us);
+    if (oc->enabled && oc->active)
+        detect(engine, ACS_EVENT_OVERCURRENT_PEAK, false, within_clear(oc, engine->i_peak),
+               engine->i_peak, now_us);
+
+    evaluate(engine, ACS_EVENT_UNDERVOLTAGE_PEAK, engine->v_peak, now_us);
+
+    engine->v_peak        = 0U;
+    engine->i_peak        = 0U;
+    engine->halfcycle_len = 0U;
+}
+
+void acs_event_sample(acs_event_engine_t *engine, const acs_sample_t *sample, uint64_t now_us)
+{
+    const acs_event_detector_t *ov = &engine->detectors[ACS_EVENT_OVERVOLTAGE_PEAK];
+    const acs_event_detector_t *oc = &engine->detectors[ACS_EVENT_OVERCURRENT_PEAK];
+
+    bool     positive = sample->vcodes >= 0;
+    uint32_t v = positive ? (uint32_t)sample->vcodes : 0U - (uint32_t)sample->vcodes;
+    uint32_t i = sample->icodes >= 0 ? (uint32_t)sample->icodes : 0U - (uint32_t)sample->icodes;
+
+    if ((positive != engine->positive && engine->halfcycle_len >= engine->halfcycle_min) ||
+        engine->halfcycle_len >= engine->halfcycle_max)
+    {
+        end_halfcycle(engine, now_us);
+        engine->positive = positive;
+    }
+
+    engine->halfcycle_len++;
+    if (v > engine->v_peak)
+        engine->v_peak = v;
+    if (i > engine->i_peak)
+        engine->i_peak = i;
+
+    if (ov->enabled && !ov->active)
+        detect(engine, ACS_EVENT_OVERVOLTAGE_PEAK, beyond_set(ov, v), false, v, now_us);
+    if (oc->enabled && !oc->active)
+        detect(engine, ACS_EVENT_OVERCURRENT_PEAK, beyond_set(oc, i), false, i, now_us);
+}
+
+void acs_event_samples(acs_event_engine_t *engine, const acs_sample_t *samples,
+                       uint32_t count, uint64_t now_us)
+{
+    for (uint32_t n = 0; n < count; n++)
+    {
+        uint64_t offset_us = engine->sample_hz > 0U ? (uint64_t)n * 1000000U / engine->sample_hz : 0U;
+        acs_event_sample(engine, &samples[n], now_us + offset_us);
+    }
+}
+
+void acs_event_on_dio(acs_event_engine_t *engine, uint8_t pin, bool level)
+{
+    uint8_t bit = (uint8_t)(1U << (pin & 1U));
+
+    if (level)
+        atomic_fetch_or(&engine->dio_level, bit);
+    else
+        atomic_fetch_and(&engine->dio_level, (uint8_t)~bit);
+    atomic_fetch_or(&engine->dio_pending, bit);
+}
+
+void acs_event_service(acs_event_engine_t *engine, uint64_t now_us)
+{
+    uint8_t pending = atomic_exchange(&engine->dio_pending, 0U);
+    uint8_t level   = atomic_load(&engine->dio_level);
+
+    for (uint8_t pin = 0; pin < 2U; pin++)
+    {
+        uint8_t bit = (uint8_t)(1U << pin);
+        if (pending & bit)
+            dispatch(engine, (acs_event_kind_t)(ACS_EVENT_DIO0 + pin), (level & bit) != 0U,
+                     (level & bit) != 0U ? 1.0f : 0.0f, now_us);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,189 @@
+/**
+ * @file ACS71020_event.h
+ * @author Usman Mehmood (usmanmehmood55@gmail.com)
+ * @brief Over/undervoltage and overcurrent event engine. The device's own
+ * detectors in 0x0D and 0x0E only have 6-bit thresholds, so the same
+ * conditions are also evaluated on the host, with full resolution
+ * thresholds, hysteresis and debounce:
+ *  - on every snapshot, against vrms and irms
+ *  - on every waveform sample, against the peak of each voltage half-cycle,
+ *    so a trip is seen within the half-cycle it happens in
+ * The overvoltage, undervoltage, faultout and faultlatched flags of 0x2D
+ * and edges on DIO0 / DIO1 are merged in as events of their own. All
+ * callbacks run in the context of the call that evaluated the event, so the
+ * latency is bounded by how often snapshots and samples are fed in.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _ACS71020_event_H_
+#define _ACS71020_event_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "ACS71020.h"
+#include "ACS71020_capture.h"
+
+typedef enum
+{
+    // Host detectors on snapshots
+    ACS_EVENT_OVERVOLTAGE_RMS,
+    ACS_EVENT_UNDERVOLTAGE_RMS,
+    ACS_EVENT_OVERCURRENT_RMS,
+
+    // Host detectors on samples, per voltage half-cycle
+    ACS_EVENT_OVERVOLTAGE_PEAK,
+    ACS_EVENT_UNDERVOLTAGE_PEAK,
+    ACS_EVENT_OVERCURRENT_PEAK,
+
+    // Device flags in 0x2D
+    ACS_EVENT_HW_OVERVOLTAGE,
+    ACS_EVENT_HW_UNDERVOLTAGE,
+    ACS_EVENT_HW_FAULT,
+    ACS_EVENT_HW_FAULT_LATCHED,
+
+    // Pin edges
+    ACS_EVENT_DIO0,
+    ACS_EVENT_DIO1,
+
+    ACS_EVENT_COUNT,
+} acs_event_kind_t;
+
+typedef struct
+{
+    acs_event_kind_t kind;
+    bool             active;        // Asserted, or released
+    float            level;         // Fraction of full scale, or flag / pin level
+    uint64_t         timestamp_us;
+} acs_event_t;
+
+typedef void (*acs_event_callback_t)(void *user, const acs_event_t *event);
+
+/**
+ * @brief Threshold of one host detector, as a fraction of full scale. For
+ * over-detectors clear is below set, for under-detectors above it. The
+ * condition has to hold for trip_count evaluations in a row to assert, and
+ * the release condition for clear_count evaluations to release.
+ */
+typedef struct
+{
+    bool     enabled;
+    float    set;
+    float    clear;
+    uint16_t trip_count;
+    uint16_t clear_count;
+} acs_event_threshold_t;
+
+typedef struct
+{
+    acs_event_threshold_t overvoltage_rms;
+    acs_event_threshold_t undervoltage_rms;
+    acs_event_threshold_t overcurrent_rms;
+
+    acs_event_threshold_t overvoltage_peak;
+    acs_event_threshold_t undervoltage_peak;
+    acs_event_threshold_t overcurrent_peak;
+
+    uint32_t sample_hz;             // Rate samples are fed in at
+    float    line_hz;               // Nominal line frequency
+
+    bool     auto_clear_latched;    // Write 1 to faultlatched once reported
+} acs_event_config_t;
+
+/**
+ * @brief One host detector, thresholds converted to register codes.
+ */
+typedef struct
+{
+    bool     enabled;
+    bool     over;
+    bool     active;
+    uint32_t set;
+    uint32_t clear;
+    uint16_t trip_count;
+    uint16_t clear_count;
+    uint16_t run;
+} acs_event_detector_t;
+
+typedef struct
+{
+    const acs_device_t   *dev;
+    acs_event_callback_t  callback;
+    void                 *user;
+    bool                  auto_clear_latched;
+
+    acs_event_detector_t  detectors[ACS_EVENT_HW_OVERVOLTAGE];
+
+    // Half-cycle tracking of the sample path
+    uint32_t              sample_hz;
+    bool                  positive;
+    uint32_t              v_peak;
+    uint32_t              i_peak;
+    uint32_t              halfcycle_len;
+    uint32_t              halfcycle_min;
+    uint32_t              halfcycle_max;
+
+    uint32_t              flags;        // Last seen 0x2D flag bits
+
+    _Atomic uint8_t       dio_pending;  // Pins with an edge not dispatched yet
+    _Atomic uint8_t       dio_level;
+
+    uint32_t              counts[ACS_EVENT_COUNT];  // Assertions per kind
+    uint32_t              bus_errors;
+} acs_event_engine_t;
+
+/**
+ * @brief Converts the thresholds and arms the engine. dev is only needed for
+ * acs_event_poll() and the faultlatched auto-clear, it may be NULL otherwise.
+ * @return ACS_OK, or ACS_ERR_PARAM for an inconsistent threshold
+ */
+int acs_event_init(acs_event_engine_t *engine, const acs_device_t *dev,
+                   const acs_event_config_t *config, acs_event_callback_t callback,
+                   void *user);
+
+/**
+ * @brief Evaluates the rms detectors and the flags of a snapshot.
+ * @return ACS_OK, or a transport error from clearing faultlatched
+ */
+int acs_event_snapshot(acs_event_engine_t *engine, const acs_snapshot_t *snap, uint64_t now_us);
+
+/**
+ * @brief Evaluates the flags of a 0x2D word alone, for fast flag polling.
+ * @return ACS_OK, or a transport error from clearing faultlatched
+ */
+int acs_event_flags(acs_event_engine_t *engine, uint32_t reg_0x2D, uint64_t now_us);
+
+/**
+ * @brief Reads 0x2D and evaluates its flags.
+ * @return ACS_OK or a transport error
+ */
+int acs_event_poll(acs_event_engine_t *engine, uint64_t now_us);
+
+/**
+ * @brief Evaluates the peak detectors on one waveform sample.
+ */
+void acs_event_sample(acs_event_engine_t *engine, const acs_sample_t *sample, uint64_t now_us);
+
+/**
+ * @brief Evaluates count consecutive samples, the first taken at now_us.
+ */
+void acs_event_samples(acs_event_engine_t *engine, const acs_sample_t *samples,
+                       uint32_t count, uint64_t now_us);
+
+/**
+ * @brief GPIO edge hook, safe to call from an ISR. Only records the edge.
+ * @param pin 0 or 1
+ */
+void acs_event_on_dio(acs_event_engine_t *engine, uint8_t pin, bool level);
+
+/**
+ * @brief Dispatches the pin edges recorded since the last call.
+ */
+void acs_event_service(acs_event_engine_t *engine, uint64_t now_us);
+
+#endif // _ACS71020_event_H_
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include <string.h>
+#include "ACS71020_transport.h"
+#include "ACS71020_fields.h"
+
+#define ACS_VOLATILE_DESC(prefix, address, field, shift, width, is_signed) \
+    { #prefix, #field, address, shift, width, is_signed, 0 },
+#define ACS_EEPROM_DESC(prefix, address, field, shift, width, is_signed) \
+    { #prefix, #field, address, shift, width, is_signed, 1 },
+
+const acs_field_desc_t acs_field_table[] =
+{
+    ACS_VOLATILE_FIELDS(ACS_VOLATILE_DESC)
+    ACS_EEPROM_FIELDS(ACS_EEPROM_DESC)
+};
+
+const size_t acs_field_count = sizeof(acs_field_table) / sizeof(acs_field_table[0]);
+
+const acs_field_desc_t *acs_field_find(uint8_t address, const char *name)
+{
+    for (size_t i = 0; i < acs_field_count; i++)
+    {
+        if (acs_field_table[i].address == address &&
+            strcmp(acs_field_table[i].name, name) == 0)
+            return &acs_field_table[i];
+    }
+    return NULL;
+}
+
+int32_t acs_field_decode(const acs_field_desc_t *desc, uint32_t reg)
+{
+    uint32_t raw = (reg >> desc->shift) & ACS_FIELD_MASK(desc->width);
+    uint32_t sign = desc->is_signed ? ACS_FIELD_SIGN(desc->width) : 0U;
+    return (int32_t)((raw ^ sign) - sign);
+}
+
+/*
+ * Each check sets one bitfield to all ones through the union and compares the
+ * resulting word against the mask and shift from the table. index counts
+ * along with acs_field_table so a failure can be reported by position.
+ */
+#define ACS_VOLATILE_CHECK(prefix, address, field, shift, width, is_signed) \
+    {                                                                       \
+        prefix##_t u;                                                       \
+        u.register_value = 0U;                                              \
+        u.fields.field = ACS_FIELD_MASK(width);                             \
+        if (u.register_value != (ACS_FIELD_MASK(width) << (shift)))         \
+            return index + 1;                                               \
+        index++;                                                            \
+    }
+
+#define ACS_EEPROM_CHECK(prefix, address, field, shift, width, is_signed)   \
+    {                                                                       \
+        prefix##_t u;                                                       \
+        u.eeprom_data = 0U;                                                 \
+        u.fields.field = ACS_FIELD_MASK(width);                             \
+        if (u.eeprom_data != (ACS_FIELD_MASK(width) << (shift)))            \
+            return index + 1;                                               \
+        index++;                                                            \
+    }
+
+#define ACS_FRAME_CHECK(prefix, address, field, shift, width, is_signed)    \
+    {                                                                       \
+        eeprom_reg_t r;                                                     \
+        r.frame.value = 0U;                                                 \
+        r.frame.fields.field = ACS_FIELD_MASK(width);                       \
+        if (r.frame.value != (ACS_FIELD_MASK(width) << (shift)))            \
+            return index + 1;                                               \
+        index++;                                                            \
+    }
+
+int acs_fields_verify_layout(void)
+{
+    int index = 0;
+
+    ACS_VOLATILE_FIELDS(ACS_VOLATILE_CHECK)
+    ACS_EEPROM_FIELDS(ACS_EEPROM_CHECK)
+    ACS_EEPROM_FRAME_FIELDS(ACS_FRAME_CHECK)
+
+    return ACS_OK;
+}
\ No newline at end of file
@@ -0,0 +1,184 @@
+/**
+ * @file ACS71020_fields.h
+ * @author Usman Mehmood (usmanmehmood55@gmail.com)
+ * @brief Machine readable description of every field of every register, and
+ * the shift/mask accessors generated from it. The unions in
+ * ACS71020_volatile.h and ACS71020_eeprom.h are kept for readability, but
+ * their bitfield layout is up to the compiler, while the accessors below
+ * always compile to a constant shift and mask.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _ACS71020_fields_H_
+#define _ACS71020_fields_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "ACS71020_eeprom.h"
+#include "ACS71020_volatile.h"
+
+/**
+ * @brief Volatile register fields.
+ * X(prefix, address, field, shift, width, is_signed)
+ */
+#define ACS_VOLATILE_FIELDS(X)                      \
+    X(acs_0x20,    0x20, irms,             1, 15, 0) \
+    X(acs_0x20,    0x20, vrms,            17, 15, 0) \
+    X(acs_0x21,    0x21, pactive,          0, 17, 1) \
+    X(acs_0x22,    0x22, papparent,        0, 16, 0) \
+    X(acs_0x23,    0x23, pimag,            0, 16, 0) \
+    X(acs_0x24,    0x24, pfactor,          0, 11, 1) \
+    X(acs_0x25,    0x25, numptsout,        0,  9, 0) \
+    X(acs_0x26,    0x26, irmsavgonesec,    0, 15, 0) \
+    X(acs_0x26,    0x26, vrmsavgonesec,   16, 15, 0) \
+    X(acs_0x27,    0x27, irmsavgonemin,    0, 15, 0) \
+    X(acs_0x27,    0x27, vrmsavgonemin,   16, 15, 0) \
+    X(acs_0x28,    0x28, pactavgonesec,    0, 17, 1) \
+    X(acs_0x29,    0x29, pactavgonemin,    0, 17, 1) \
+    X(acs_0x2A,    0x2A, vcodes,           0, 17, 1) \
+    X(acs_0x2B,    0x2B, icodes,           0, 17, 1) \
+    X(acs_0x2C,    0x2C, pinstant,         0, 32, 1) \
+    X(acs_0x2D,    0x2D, vzerocrossout,    0,  1, 0) \
+    X(acs_0x2D,    0x2D, faultout,         1,  1, 0) \
+    X(acs_0x2D,    0x2D, faultlatched,     2,  1, 0) \
+    X(acs_0x2D,    0x2D, overvoltage,      3,  1, 0) \
+    X(acs_0x2D,    0x2D, undervoltage,     4,  1, 0) \
+    X(acs_0x2D,    0x2D, posangle,         5,  1, 0) \
+    X(acs_0x2D,    0x2D, pospf,            6,  1, 0) \
+    X(acs_0x2F,    0x2F, access_code,      0, 32, 0) \
+    X(acs_0x30,    0x30, customer_access,  0,  1, 0)
+
+/**
+ * @brief EEPROM register fields, positions are within eeprom_data.
+ * X(prefix, address, field, shift, width, is_signed)
+ */
+#define ACS_EEPROM_FIELDS(X)                        \
+    X(eeprom_0x0B, 0x0B, qvo_fine,        10,  9, 1) \
+    X(eeprom_0x0B, 0x0B, sns_fine,        19,  9, 1) \
+    X(eeprom_0x0B, 0x0B, crs_sns,         28,  3, 0) \
+    X(eeprom_0x0B, 0x0B, iavgselen,       31,  1, 0) \
+    X(eeprom_0x0C, 0x0C, rms_avg_2,       16,  9, 0) \
+    X(eeprom_0x0C, 0x0C, rms_avg_1,       25,  7, 0) \
+    X(eeprom_0x0D, 0x0D, squarewave_en,    6,  1, 0) \
+    X(eeprom_0x0D, 0x0D, halfcycle_en,     7,  1, 0) \
+    X(eeprom_0x0D, 0x0D, fltdly,           8,  3, 0) \
+    X(eeprom_0x0D, 0x0D, fault,           11,  8, 0) \
+    X(eeprom_0x0D, 0x0D, chan_del_sel,    20,  3, 0) \
+    X(eeprom_0x0D, 0x0D, ichan_del_en,    24,  1, 0) \
+    X(eeprom_0x0D, 0x0D, pacc_trim,       25,  7, 1) \
+    X(eeprom_0x0E, 0x0E, delaycnt_sel,    11,  1, 0) \
+    X(eeprom_0x0E, 0x0E, undervreg,       12,  6, 0) \
+    X(eeprom_0x0E, 0x0E, overvreg,        18,  6, 0) \
+    X(eeprom_0x0E, 0x0E, vadc_rate_set,   25,  1, 0) \
+    X(eeprom_0x0E, 0x0E, vevent_cycs,     26,  6, 0) \
+    X(eeprom_0x0F, 0x0F, dio_1_sel,       12,  2, 0) \
+    X(eeprom_0x0F, 0x0F, dio_0_sel,       14,  2, 0) \
+    X(eeprom_0x0F, 0x0F, i2c_dis_slv_addr,22,  1, 0) \
+    X(eeprom_0x0F, 0x0F, i2c_slv_addr,    23,  7, 0)
+
+/**
+ * @brief Fields of the raw EEPROM frame in eeprom_reg_t.
+ * X(prefix, address, field, shift, width, is_signed)
+ */
+#define ACS_EEPROM_FRAME_FIELDS(X)                  \
+    X(eeprom_frame, 0x00, EEC,             4,  2, 0) \
+    X(eeprom_frame, 0x00, eeprom_data,     6, 26, 0)
+
+#define ACS_FIELD_MASK(width)  ((uint32_t)(0xFFFFFFFFU >> (32U - (width))))
+#define ACS_FIELD_SIGN(width)  ((uint32_t)1U << ((width) - 1U))
+
+/**
+ * @brief Sign extends the low width bits of value without branching.
+ */
+#define ACS_SIGN_EXTEND(value, width) \
+    ((int32_t)((((uint32_t)(value) & ACS_FIELD_MASK(width)) ^ ACS_FIELD_SIGN(width)) - ACS_FIELD_SIGN(width)))
+
+/**
+ * For every field this generates
+ *   uint32_t <prefix>_<field>_get(uint32_t reg)
+ *   uint32_t <prefix>_<field>_set(uint32_t reg, uint32_t value)
+ * and, for signed fields only,
+ *   int32_t  <prefix>_<field>_sget(uint32_t reg)
+ */
+#define ACS_FIELD_SGET_0(prefix, field, shift, width)
+#define ACS_FIELD_SGET_1(prefix, field, shift, width)               \
+    static inline int32_t prefix##_##field##_sget(uint32_t reg)     \
+    {                                                               \
+        return ACS_SIGN_EXTEND(reg >> (shift), width);              \
+    }
+
+#define ACS_FIELD_ACCESSORS(prefix, address, field, shift, width, is_signed) \
+    _Static_assert((shift) + (width) <= 32, #prefix "." #field " overflows"); \
+    static inline uint32_t prefix##_##field##_get(uint32_t reg)               \
+    {                                                                         \
+        return (reg >> (shift)) & ACS_FIELD_MASK(width);                      \
+    }                                                                         \
+    static inline uint32_t prefix##_##field##_set(uint32_t reg, uint32_t value) \
+    {                                                                         \
+        return (reg & ~(ACS_FIELD_MASK(width) << (shift)))                    \
+             | ((value & ACS_FIELD_MASK(width)) << (shift));                  \
+    }                                                                         \
+    ACS_FIELD_SGET_##is_signed(prefix, field, shift, width)
+
+ACS_VOLATILE_FIELDS(ACS_FIELD_ACCESSORS)
+ACS_EEPROM_FIELDS(ACS_FIELD_ACCESSORS)
+ACS_EEPROM_FRAME_FIELDS(ACS_FIELD_ACCESSORS)
+
+/**
+ * The part of the union layout that is a constant expression: every register
+ * union, and the frame of eeprom_reg_t, is exactly one 32-bit word. Bit
+ * positions are checked at runtime by acs_fields_verify_layout().
+ */
+#define ACS_FIELD_SIZE_CHECK(prefix, address, field, shift, width, is_signed) \
+    _Static_assert(sizeof(prefix##_t) == sizeof(uint32_t), #prefix " is not one word");
+
+ACS_VOLATILE_FIELDS(ACS_FIELD_SIZE_CHECK)
+ACS_EEPROM_FIELDS(ACS_FIELD_SIZE_CHECK)
+_Static_assert(sizeof(((eeprom_reg_t *)0)->frame) == sizeof(uint32_t),
+               "eeprom_reg_t.frame is not one word");
+
+/**
+ * @brief Runtime view of the same tables, for decoders, dumpers and tests.
+ */
+typedef struct
+{
+    const char *reg_name;   // e.g. "acs_0x20"
+    const char *name;       // e.g. "irms"
+    uint8_t     address;
+    uint8_t     shift;
+    uint8_t     width;
+    uint8_t     is_signed;
+    uint8_t     is_eeprom;
+} acs_field_desc_t;
+
+extern const acs_field_desc_t acs_field_table[];
+extern const size_t acs_field_count;
+
+/**
+ * @brief Looks a field up by register address and name.
+ * @return the descriptor, or NULL if there is no such field
+ */
+const acs_field_desc_t *acs_field_find(uint8_t address, const char *name);
+
+/**
+ * @brief Extracts a field described by a descriptor, sign extended if the
+ * field is signed.
+ */
+int32_t acs_field_decode(const acs_field_desc_t *desc, uint32_t reg);
+
+/**
+ * @brief Checks that the tables above agree with the compiler's layout of the
+ * bitfield unions. Bitfield positions are not constant expressions in C, so
+ * this cannot be a _Static_assert, but with optimization enabled the whole
+ * function folds to a constant.
+ * @return ACS_OK, or one plus the index in acs_field_table of the first
+ * field that does not match
+ */
+int acs_fields_verify_layout(void);
+
+#endif // _ACS71020_fields_H_
\ No newline at end of file
@@ -0,0 +1,16 @@
+#include "ACS71020_fixed.h"
+
+void acs_fixed_decode_snapshot(const acs_snapshot_t *snap, acs_fixed_measurement_t *out)
+{
+    const uint32_t *w = snap->words;
+
+    out->irms_ma       = acs_fixed_irms_ma(w[0x20 - ACS_REG_MEAS_FIRST]);
+    out->vrms_mv       = acs_fixed_vrms_mv(w[0x20 - ACS_REG_MEAS_FIRST]);
+    out->pactive_mw    = acs_fixed_pactive_mw(w[0x21 - ACS_REG_MEAS_FIRST]);
+    out->papparent_mva = acs_fixed_papparent_mva(w[0x22 - ACS_REG_MEAS_FIRST]);
+    out->pimag_mvar    = acs_fixed_pimag_mvar(w[0x23 - ACS_REG_MEAS_FIRST]);
+    out->pfactor_milli = acs_fixed_pfactor_milli(w[0x24 - ACS_REG_MEAS_FIRST]);
+    out->vcodes_mv     = acs_fixed_vcodes_mv(w[0x2A - ACS_REG_MEAS_FIRST]);
+    out->icodes_ma     = acs_fixed_icodes_ma(w[0x2B - ACS_REG_MEAS_FIRST]);
+    out->pinstant_mw   = acs_fixed_pinstant_mw(w[0x2C - ACS_REG_MEAS_FIRST]);
+}
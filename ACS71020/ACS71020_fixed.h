@@ -0,0 +1,134 @@
+/**
+ * @file ACS71020_fixed.h
+ * @author Usman Mehmood (usmanmehmood55@gmail.com)
+ * @brief Integer-only conversion of measurement registers to milliamps,
+ * millivolts and milliwatts, for targets without an FPU. The full-scale
+ * values are compile-time constants, so every conversion is a multiply by a
+ * constant, a rounding add and a shift. Results are exactly the field value
+ * times full scale over 2^frac rounded to the nearest integer, halves away
+ * from zero, which is what rounding the double precision path of
+ * ACS71020_decode.h gives.
+ * Set the full scale of the part with -DACS_FS_CURRENT_MA=..., and
+ * -DACS_FS_VOLTAGE_MV=..., the same for every file of the build.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _ACS71020_fixed_H_
+#define _ACS71020_fixed_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include "ACS71020.h"
+
+#ifndef ACS_FS_CURRENT_MA
+#define ACS_FS_CURRENT_MA 30000     // mA
+#endif
+
+#ifndef ACS_FS_VOLTAGE_MV
+#define ACS_FS_VOLTAGE_MV 250000    // mV
+#endif
+
+#ifndef ACS_FS_POWER_MW
+#define ACS_FS_POWER_MW ((int64_t)ACS_FS_CURRENT_MA * ACS_FS_VOLTAGE_MV / 1000)
+#endif
+
+// The largest results are pinstant at 4x and irms at 2x full scale
+_Static_assert(ACS_FS_CURRENT_MA > 0 && ACS_FS_CURRENT_MA <= INT32_MAX / 2,
+               "ACS_FS_CURRENT_MA out of range");
+_Static_assert(ACS_FS_VOLTAGE_MV > 0 && ACS_FS_VOLTAGE_MV <= INT32_MAX / 2,
+               "ACS_FS_VOLTAGE_MV out of range");
+_Static_assert(ACS_FS_POWER_MW > 0 && ACS_FS_POWER_MW <= INT32_MAX / 4,
+               "ACS_FS_POWER_MW out of range");
+
+/**
+ * @brief One snapshot in integer engineering units.
+ */
+typedef struct
+{
+    uint32_t irms_ma;
+    uint32_t vrms_mv;
+    int32_t  pactive_mw;
+    uint32_t papparent_mva;
+    uint32_t pimag_mvar;
+    int32_t  pfactor_milli;     // Power factor times 1000
+    int32_t  vcodes_mv;
+    int32_t  icodes_ma;
+    int32_t  pinstant_mw;
+} acs_fixed_measurement_t;
+
+/**
+ * @brief value * scale / 2^frac, rounded to nearest. The product of a field
+ * of at most 32 bits and a full scale below 2^31 always fits in 64 bits.
+ */
+static inline uint32_t acs_fixed_scale_u(uint32_t value, uint32_t scale, uint32_t frac)
+{
+    return (uint32_t)(((uint64_t)value * scale + ((uint64_t)1U << (frac - 1U))) >> frac);
+}
+
+/**
+ * @brief As acs_fixed_scale_u() for a sign extended field, halves rounded away
+ * from zero so that negative readings mirror positive ones.
+ */
+static inline int32_t acs_fixed_scale_s(int32_t value, uint32_t scale, uint32_t frac)
+{
+    uint32_t magnitude = value < 0 ? 0U - (uint32_t)value : (uint32_t)value;
+    uint32_t r = (uint32_t)(((uint64_t)magnitude * scale + ((uint64_t)1U << (frac - 1U))) >> frac);
+    return value < 0 ? -(int32_t)r : (int32_t)r;
+}
+
+static inline uint32_t acs_fixed_irms_ma(uint32_t reg_0x20)
+{
+    return acs_fixed_scale_u(acs_0x20_irms_get(reg_0x20), ACS_FS_CURRENT_MA, 14U);
+}
+
+static inline uint32_t acs_fixed_vrms_mv(uint32_t reg_0x20)
+{
+    return acs_fixed_scale_u(acs_0x20_vrms_get(reg_0x20), ACS_FS_VOLTAGE_MV, 15U);
+}
+
+static inline int32_t acs_fixed_pactive_mw(uint32_t reg_0x21)
+{
+    return acs_fixed_scale_s(acs_0x21_pactive_sget(reg_0x21), (uint32_t)ACS_FS_POWER_MW, 15U);
+}
+
+static inline uint32_t acs_fixed_papparent_mva(uint32_t reg_0x22)
+{
+    return acs_fixed_scale_u(acs_0x22_papparent_get(reg_0x22), (uint32_t)ACS_FS_POWER_MW, 15U);
+}
+
+static inline uint32_t acs_fixed_pimag_mvar(uint32_t reg_0x23)
+{
+    return acs_fixed_scale_u(acs_0x23_pimag_get(reg_0x23), (uint32_t)ACS_FS_POWER_MW, 15U);
+}
+
+static inline int32_t acs_fixed_pfactor_milli(uint32_t reg_0x24)
+{
+    return acs_fixed_scale_s(acs_0x24_pfactor_sget(reg_0x24), 1000U, 9U);
+}
+
+static inline int32_t acs_fixed_vcodes_mv(uint32_t reg_0x2A)
+{
+    return acs_fixed_scale_s(acs_0x2A_vcodes_sget(reg_0x2A), ACS_FS_VOLTAGE_MV, 16U);
+}
+
+static inline int32_t acs_fixed_icodes_ma(uint32_t reg_0x2B)
+{
+    return acs_fixed_scale_s(acs_0x2B_icodes_sget(reg_0x2B), ACS_FS_CURRENT_MA, 15U);
+}
+
+static inline int32_t acs_fixed_pinstant_mw(uint32_t reg_0x2C)
+{
+    return acs_fixed_scale_s(acs_0x2C_pinstant_sget(reg_0x2C), (uint32_t)ACS_FS_POWER_MW, 29U);
+}
+
+/**
+ * @brief Decodes a single snapshot, the integer counterpart of
+ * acs_decode_snapshot().
+ */
+void acs_fixed_decode_snapshot(const acs_snapshot_t *snap, acs_fixed_measurement_t *out);
+
+#endif // _ACS71020_fixed_H_
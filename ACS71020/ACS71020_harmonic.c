@@ -0,0 +1,142 @@
+#include <math.h>
+#include <string.h>
+#include "ACS71020_harmonic.h"
+
+#define TWO_PI 6.28318530717958647692
+
+uint32_t acs_harmonic_block_len(float sample_rate, float fundamental_hz, uint32_t cycles)
+{
+    if (fundamental_hz <= 0.0f)
+        return 0U;
+    return (uint32_t)lroundf(sample_rate * (float)cycles / fundamental_hz);
+}
+
+float acs_harmonic_estimate_f0(const acs_sample_t *samples, size_t count, float sample_rate)
+{
+    float first = -1.0f;
+    float last = -1.0f;
+    uint32_t crossings = 0;
+
+    for (size_t i = 1; i < count; i++)
+    {
+        int32_t a = samples[i - 1U].vcodes;
+        int32_t b = samples[i].vcodes;
+        if (a >= 0 || b < 0)
+            continue;
+
+        // Linear interpolation of the crossing between sample i-1 and i
+        float t = (float)(i - 1U) + (float)(-a) / (float)(b - a);
+        if (crossings == 0U)
+            first = t;
+        last = t;
+        crossings++;
+    }
+
+    if (crossings < 2U)
+        return 0.0f;
+    return sample_rate * (float)(crossings - 1U) / (last - first);
+}
+
+int acs_harmonic_init(acs_harmonic_t *an, float sample_rate, float fundamental_hz,
+                      uint16_t harmonics, uint32_t block_len)
+{
+    if (an == NULL || sample_rate <= 0.0f || fundamental_hz <= 0.0f ||
+        harmonics == 0U || harmonics > ACS_HARMONIC_MAX || block_len < 2U)
+        return ACS_ERR_PARAM;
+
+    memset(an, 0, sizeof(*an));
+    an->sample_rate    = sample_rate;
+    an->fundamental_hz = fundamental_hz;
+    an->block_len      = block_len;
+
+    uint16_t h;
+    for (h = 1; h <= harmonics; h++)
+    {
+        if ((float)h * fundamental_hz >= sample_rate / 2.0f)
+            break;
+
+        double w = TWO_PI * (double)h * fundamental_hz / sample_rate;
+        an->coeff[h]   = (float)(2.0 * cos(w));
+        an->cos_w[h]   = (float)cos(w);
+        an->sin_w[h]   = (float)sin(w);
+        an->cos_end[h] = (float)cos(w * (double)(block_len - 1U));
+        an->sin_end[h] = (float)sin(w * (double)(block_len - 1U));
+    }
+    an->harmonics = h - 1U;
+
+    return an->harmonics > 0U ? ACS_OK : ACS_ERR_PARAM;
+}
+
+/**
+ * @brief Sample of one channel, vcodes when voltage is set, icodes otherwise.
+ */
+static inline float channel(const acs_sample_t *sample, bool voltage)
+{
+    return (float)(voltage ? sample->vcodes : sample->icodes);
+}
+
+/**
+ * @brief Runs the whole bank over one channel. The loop is harmonic major so
+ * that the inner loop is a tight two-tap recursion over the block.
+ */
+static void analyze_channel(const acs_harmonic_t *an, const acs_sample_t *samples,
+                            bool voltage, acs_harmonic_result_t *out)
+{
+    const uint32_t n = an->block_len;
+    const float norm = 1.41421356f / (float)n;
+
+    double sum_sq = 0.0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        float x = channel(&samples[i], voltage);
+        sum_sq += (double)x * x;
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->rms = (float)sqrt(sum_sq / n);
+
+    float harmonic_sq = 0.0f;
+    for (uint16_t h = 1; h <= an->harmonics; h++)
+    {
+        const float c = an->coeff[h];
+        float s1 = 0.0f;
+        float s2 = 0.0f;
+
+        for (uint32_t i = 0; i < n; i++)
+        {
+            float s0 = channel(&samples[i], voltage) + c * s1 - s2;
+            s2 = s1;
+            s1 = s0;
+        }
+
+        // y = s1 - s2 e^-jw, then X = y e^-jw(N-1)
+        float yr = s1 - s2 * an->cos_w[h];
+        float yi = s2 * an->sin_w[h];
+        float xr = yr * an->cos_end[h] + yi * an->sin_end[h];
+        float xi = yi * an->cos_end[h] - yr * an->sin_end[h];
+
+        out->magnitude[h] = sqrtf(xr * xr + xi * xi) * norm;
+        out->phase[h]     = atan2f(xi, xr);
+
+        if (h > 1U)
+            harmonic_sq += out->magnitude[h] * out->magnitude[h];
+    }
+
+    if (out->magnitude[1] > 0.0f)
+        out->thd = sqrtf(harmonic_sq) / out->magnitude[1];
+}
+
+int acs_harmonic_analyze(const acs_harmonic_t *an, const acs_sample_t *samples,
+                         size_t count, acs_harmonic_result_t *voltage,
+                         acs_harmonic_result_t *current)
+{
+    if (an == NULL || samples == NULL || count != an->block_len)
+        return ACS_ERR_PARAM;
+
+    if (voltage != NULL)
+        analyze_channel(an, samples, true, voltage);
+    if (current != NULL)
+        analyze_channel(an, samples, false, current);
+
+    return ACS_OK;
+}
\ No newline at end of file
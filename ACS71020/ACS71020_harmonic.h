@@ -0,0 +1,85 @@
+/**
+ * @file ACS71020_harmonic.h
+ * @author Usman Mehmood (usmanmehmood55@gmail.com)
+ * @brief Harmonic analysis of captured vcodes / icodes waveforms. A bank of
+ * Goertzel filters, one per harmonic of the line frequency, is run over a
+ * block that spans a whole number of line cycles, so every harmonic falls
+ * exactly on a filter and there is no leakage between them. Coefficients
+ * and phase twiddles are computed once per configuration, the analysis
+ * itself uses no heap and no trigonometry.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _ACS71020_harmonic_H_
+#define _ACS71020_harmonic_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "ACS71020_capture.h"
+
+#define ACS_HARMONIC_MAX 40U    // Highest harmonic order that can be analyzed
+
+/**
+ * @brief Result for one channel. Index 0 is unused, index 1 is the
+ * fundamental. Magnitudes are rms, in codes, multiply by the channel's full
+ * scale and divide by 2^16 (vcodes) or 2^15 (icodes) to get volts or amps.
+ * Phases are in radians, cosine referenced, relative to the first sample of
+ * the block.
+ */
+typedef struct
+{
+    float magnitude[ACS_HARMONIC_MAX + 1U];
+    float phase[ACS_HARMONIC_MAX + 1U];
+    float thd;          // Total harmonic distortion, ratio to the fundamental
+    float rms;          // Total rms of the block, in codes
+} acs_harmonic_result_t;
+
+typedef struct
+{
+    float    sample_rate;
+    float    fundamental_hz;
+    uint16_t harmonics;
+    uint32_t block_len;
+
+    float    coeff[ACS_HARMONIC_MAX + 1U];     // 2 cos(w)
+    float    cos_w[ACS_HARMONIC_MAX + 1U];
+    float    sin_w[ACS_HARMONIC_MAX + 1U];
+    float    cos_end[ACS_HARMONIC_MAX + 1U];   // cos(w (N - 1))
+    float    sin_end[ACS_HARMONIC_MAX + 1U];
+} acs_harmonic_t;
+
+/**
+ * @brief Number of samples covering cycles line cycles as closely as possible.
+ */
+uint32_t acs_harmonic_block_len(float sample_rate, float fundamental_hz, uint32_t cycles);
+
+/**
+ * @brief Estimates the line frequency from rising zero crossings of vcodes,
+ * interpolated between samples.
+ * @return frequency in Hz, or 0 if fewer than two crossings were found
+ */
+float acs_harmonic_estimate_f0(const acs_sample_t *samples, size_t count, float sample_rate);
+
+/**
+ * @brief Precomputes the filter bank. harmonics above the Nyquist frequency
+ * are dropped.
+ * @return ACS_OK or ACS_ERR_PARAM
+ */
+int acs_harmonic_init(acs_harmonic_t *an, float sample_rate, float fundamental_hz,
+                      uint16_t harmonics, uint32_t block_len);
+
+/**
+ * @brief Analyzes one block of an->block_len samples. Either result may be
+ * NULL to skip that channel.
+ * @return ACS_OK, or ACS_ERR_PARAM if count is not an->block_len
+ */
+int acs_harmonic_analyze(const acs_harmonic_t *an, const acs_sample_t *samples,
+                         size_t count, acs_harmonic_result_t *voltage,
+                         acs_harmonic_result_t *current);
+
+#endif // _ACS71020_harmonic_H_
\ No newline at end of file
@@ -0,0 +1,247 @@
+#include <string.h>
+#include "ACS71020_instr.h"
+#include "ACS71020_ecc.h"
+
+#define SUB_BUCKETS (1U << ACS_INSTR_SUB_BITS)
+
+static uint32_t msb64(uint64_t v)
+{
+#if defined(__GNUC__)
+    return 63U - (uint32_t)__builtin_clzll(v);
+#else
+    uint32_t msb = 0U;
+    while ((v >>= 1) != 0U)
+        msb++;
+    return msb;
+#endif
+}
+
+uint32_t acs_instr_bucket(uint64_t ns)
+{
+    if (ns < SUB_BUCKETS)
+        return (uint32_t)ns;
+
+    // Exponent, then the top ACS_INSTR_SUB_BITS + 1 bits as the mantissa
+    uint32_t e = msb64(ns) - ACS_INSTR_SUB_BITS;
+    uint64_t bucket = (uint64_t)e * SUB_BUCKETS + (ns >> e);
+    return bucket < ACS_INSTR_BUCKETS ? (uint32_t)bucket : ACS_INSTR_BUCKETS - 1U;
+}
+
+uint64_t acs_instr_bucket_max(uint32_t bucket)
+{
+    if (bucket < SUB_BUCKETS)
+        return bucket;
+    if (bucket >= ACS_INSTR_BUCKETS - 1U)
+        return UINT64_MAX;
+
+    uint32_t e = bucket / SUB_BUCKETS - 1U;
+    uint64_t m = bucket % SUB_BUCKETS + SUB_BUCKETS;
+    return ((m + 1U) << e) - 1U;
+}
+
+uint64_t acs_instr_percentile(const acs_instr_hist_t *hist, float p)
+{
+    if (hist->total == 0U)
+        return 0U;
+
+    uint64_t target = (uint64_t)(p * (float)hist->total + 0.5f);
+    if (target == 0U)
+        target = 1U;
+
+    uint64_t seen = 0U;
+    for (uint32_t b = 0; b < ACS_INSTR_BUCKETS; b++)
+    {
+        seen += hist->counts[b];
+        if (seen >= target)
+        {
+            uint64_t max = acs_instr_bucket_max(b);
+            return max < hist->max_ns ? max : hist->max_ns;
+        }
+    }
+    return hist->max_ns;
+}
+
+#if ACS_INSTRUMENT
+
+static uint64_t now_ns(const acs_instr_t *instr)
+{
+    return instr->clock != NULL ? instr->clock(instr->clock_ctx) : 0U;
+}
+
+static void record_latency(acs_instr_t *instr, acs_instr_op_t op, uint64_t start_ns)
+{
+    acs_instr_hist_t *h = &instr->stats.latency[op];
+
+    instr->stats.transactions[op]++;
+    if (instr->clock == NULL)
+        return;
+
+    uint64_t ns = now_ns(instr) - start_ns;
+    h->counts[acs_instr_bucket(ns)]++;
+    if (h->total == 0U || ns < h->min_ns)
+        h->min_ns = ns;
+    if (ns > h->max_ns)
+        h->max_ns = ns;
+    h->sum_ns += ns;
+    h->total++;
+}
+
+static void record_error(acs_instr_t *instr, int ret)
+{
+    if (ret == ACS_ERR_NAK)
+        instr->stats.naks++;
+    else if (ret == ACS_ERR_BUS)
+        instr->stats.bus_errors++;
+    else if (ret != ACS_OK)
+        instr->stats.other_errors++;
+}
+
+static bool retryable(int ret)
+{
+    return ret == ACS_ERR_NAK || ret == ACS_ERR_BUS;
+}
+
+static void record_read(acs_instr_t *instr, uint8_t reg_addr, const uint32_t *words, uint8_t count)
+{
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint8_t reg = (uint8_t)(reg_addr + i);
+        instr->stats.reads[reg]++;
+
+        if (reg < ACS_REG_EEPROM_FIRST || reg > ACS_REG_EEPROM_LAST)
+            continue;
+
+        acs_eec_t eec = acs_ecc_reported(words[i]);
+        if (eec == ACS_EEC_CORRECTED)
+            instr->stats.eec_corrected++;
+        else if (eec == ACS_EEC_UNCORRECTABLE)
+            instr->stats.eec_uncorrectable++;
+    }
+}
+
+static int instr_read(void *ctx, uint8_t dev_addr, uint8_t reg_addr,
+                      uint32_t *words, uint8_t count)
+{
+    acs_instr_t *instr = ctx;
+    const acs_transport_t *t = instr->inner;
+    int ret;
+
+    for (uint8_t attempt = 0; ; attempt++)
+    {
+        uint64_t start = now_ns(instr);
+        ret = t->read(t->ctx, dev_addr, reg_addr, words, count);
+        record_latency(instr, ACS_INSTR_READ, start);
+        record_error(instr, ret);
+
+        if (!retryable(ret) || attempt >= instr->retries)
+            break;
+        instr->stats.retries++;
+    }
+
+    if (ret == ACS_OK)
+        record_read(instr, reg_addr, words, count);
+    return ret;
+}
+
+/**
+ * @brief Writes are never retried. A write that failed may still have taken
+ * effect, and writing again is not harmless for the EEPROM or for
+ * faultlatched, which a second 1 would clear after it latched again.
+ */
+static int instr_write(void *ctx, uint8_t dev_addr, uint8_t reg_addr,
+                       const uint32_t *words, uint8_t count)
+{
+    acs_instr_t *instr = ctx;
+    const acs_transport_t *t = instr->inner;
+
+    uint64_t start = now_ns(instr);
+    int ret = t->write(t->ctx, dev_addr, reg_addr, words, count);
+    record_latency(instr, ACS_INSTR_WRITE, start);
+    record_error(instr, ret);
+
+    if (ret == ACS_OK)
+        for (uint8_t i = 0; i < count; i++)
+            instr->stats.writes[(uint8_t)(reg_addr + i)]++;
+    return ret;
+}
+
+/**
+ * @brief The batch is timed as a whole. Reads that failed in it are retried
+ * one at a time, each timed as a single read.
+ */
+static int instr_read_multi(void *ctx, acs_xfer_t *xfers, uint8_t count)
+{
+    acs_instr_t *instr = ctx;
+    const acs_transport_t *t = instr->inner;
+
+    uint64_t start = now_ns(instr);
+    int ret = acs_transport_read_multi(t, xfers, count);
+    record_latency(instr, ACS_INSTR_READ_MULTI, start);
+    if (ret != ACS_OK)
+    {
+        record_error(instr, ret);
+        return ret;
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        acs_xfer_t *x = &xfers[i];
+
+        record_error(instr, x->status);
+        for (uint8_t attempt = 0; retryable(x->status) && attempt < instr->retries; attempt++)
+        {
+            instr->stats.retries++;
+            start = now_ns(instr);
+            x->status = t->read(t->ctx, x->dev_addr, x->reg_addr, x->words, x->count);
+            record_latency(instr, ACS_INSTR_READ, start);
+            record_error(instr, x->status);
+        }
+
+        if (x->status == ACS_OK)
+            record_read(instr, x->reg_addr, x->words, x->count);
+    }
+    return ACS_OK;
+}
+
+void acs_transport_instr_init(acs_transport_t *transport, acs_instr_t *instr,
+                              const acs_transport_t *inner, acs_clock_ns_fn_t clock,
+                              void *clock_ctx, uint8_t retries)
+{
+    memset(instr, 0, sizeof(*instr));
+    instr->inner     = inner;
+    instr->clock     = clock;
+    instr->clock_ctx = clock_ctx;
+    instr->retries   = retries;
+
+    transport->read       = instr_read;
+    transport->write      = instr_write;
+    transport->read_multi = instr_read_multi;
+    transport->ctx        = instr;
+}
+
+#else
+
+void acs_transport_instr_init(acs_transport_t *transport, acs_instr_t *instr,
+                              const acs_transport_t *inner, acs_clock_ns_fn_t clock,
+                              void *clock_ctx, uint8_t retries)
+{
+    (void)clock;
+    (void)clock_ctx;
+    (void)retries;
+
+    memset(instr, 0, sizeof(*instr));
+    instr->inner = inner;
+    *transport   = *inner;
+}
+
+#endif // ACS_INSTRUMENT
+
+void acs_instr_snapshot(const acs_instr_t *instr, acs_instr_stats_t *stats)
+{
+    memcpy(stats, &instr->stats, sizeof(*stats));
+}
+
+void acs_instr_reset(acs_instr_t *instr)
+{
+    memset(&instr->stats, 0, sizeof(instr->stats));
+}
\ No newline at end of file
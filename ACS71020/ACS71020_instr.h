@@ -0,0 +1,126 @@
+/**
+ * @file ACS71020_instr.h
+ * @author Usman Mehmood (usmanmehmood55@gmail.com)
+ * @brief Bus instrumentation. A transport is wrapped by another that counts
+ * reads and writes per register, times every transaction into log-linear
+ * latency histograms, counts NAKs, bus errors and retries, and counts
+ * EEPROM words the device flagged through their EEC bits. Only reads are
+ * retried; a failed write is reported as is.
+ * Building with ACS_INSTRUMENT defined to 0 turns the wrapper into a copy of
+ * the inner transport: calls go straight to it, nothing is counted and
+ * nothing is retried.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _ACS71020_instr_H_
+#define _ACS71020_instr_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "ACS71020.h"
+
+#ifndef ACS_INSTRUMENT
+#define ACS_INSTRUMENT 1
+#endif
+
+/**
+ * @brief Histogram resolution. Each power of two is split into
+ * 2^ACS_INSTR_SUB_BITS buckets, so a bucket is at most 12.5 % wide, and the
+ * last bucket collects everything from about 17 s up.
+ */
+#define ACS_INSTR_SUB_BITS  3U
+#define ACS_INSTR_BUCKETS   256U
+
+typedef enum
+{
+    ACS_INSTR_READ,
+    ACS_INSTR_WRITE,
+    ACS_INSTR_READ_MULTI,
+    ACS_INSTR_OPS,
+} acs_instr_op_t;
+
+/**
+ * @brief Latency histogram in nanoseconds.
+ */
+typedef struct
+{
+    uint32_t counts[ACS_INSTR_BUCKETS];
+    uint32_t total;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    uint64_t sum_ns;
+} acs_instr_hist_t;
+
+typedef struct
+{
+    uint32_t         reads[256];        // Per register, every word of a block counts
+    uint32_t         writes[256];
+    uint32_t         transactions[ACS_INSTR_OPS];
+
+    uint32_t         naks;
+    uint32_t         bus_errors;
+    uint32_t         other_errors;
+    uint32_t         retries;
+    uint32_t         eec_corrected;     // EEPROM words read with a corrected error
+    uint32_t         eec_uncorrectable;
+
+    acs_instr_hist_t latency[ACS_INSTR_OPS];
+} acs_instr_stats_t;
+
+/**
+ * @brief Monotonic time source in nanoseconds.
+ */
+typedef uint64_t (*acs_clock_ns_fn_t)(void *ctx);
+
+typedef struct
+{
+    const acs_transport_t *inner;
+    acs_clock_ns_fn_t      clock;
+    void                  *clock_ctx;
+    uint8_t                retries;     // Extra read attempts after a NAK or bus error
+
+    acs_instr_stats_t      stats;
+} acs_instr_t;
+
+/**
+ * @brief Builds transport as an instrumented view of inner.
+ * @param clock may be NULL, latencies are then not recorded
+ * @param retries extra attempts for a read that failed with a NAK or a bus
+ * error
+ */
+void acs_transport_instr_init(acs_transport_t *transport, acs_instr_t *instr,
+                              const acs_transport_t *inner, acs_clock_ns_fn_t clock,
+                              void *clock_ctx, uint8_t retries);
+
+/**
+ * @brief Copies the statistics. Not synchronized, call it from the thread
+ * that owns the transport.
+ */
+void acs_instr_snapshot(const acs_instr_t *instr, acs_instr_stats_t *stats);
+
+void acs_instr_reset(acs_instr_t *instr);
+
+/**
+ * @brief Bucket a latency falls in.
+ */
+uint32_t acs_instr_bucket(uint64_t ns);
+
+/**
+ * @brief Largest latency that falls in bucket.
+ */
+uint64_t acs_instr_bucket_max(uint32_t bucket);
+
+/**
+ * @brief Latency below which a fraction p of the transactions completed, as
+ * the upper bound of the bucket that crosses p.
+ * @param p 0.0 to 1.0
+ * @return nanoseconds, 0 for an empty histogram
+ */
+uint64_t acs_instr_percentile(const acs_instr_hist_t *hist, float p);
+
+#endif // _ACS71020_instr_H_
\ No newline at end of file
@@ -0,0 +1,642 @@
+#if defined(__linux__)
+
+#define _GNU_SOURCE
+
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <linux/spi/spidev.h>
+#include "ACS71020_linux.h"
+
+#define ACS_SPI_READ_BIT 0x80U
+#define BLOCK_BYTES      (1U + 4U * ACS_TRANSPORT_MAX_WORDS)
+
+static void words_to_bytes(const uint32_t *words, uint8_t count, uint8_t *bytes)
+{
+    for (uint8_t i = 0; i < count; i++)
+    {
+        bytes[4U * i + 0U] = (uint8_t)(words[i]);
+        bytes[4U * i + 1U] = (uint8_t)(words[i] >> 8);
+        bytes[4U * i + 2U] = (uint8_t)(words[i] >> 16);
+        bytes[4U * i + 3U] = (uint8_t)(words[i] >> 24);
+    }
+}
+
+static void bytes_to_words(const uint8_t *bytes, uint8_t count, uint32_t *words)
+{
+    for (uint8_t i = 0; i < count; i++)
+    {
+        words[i] = (uint32_t)bytes[4U * i + 0U]
+                 | (uint32_t)bytes[4U * i + 1U] << 8
+                 | (uint32_t)bytes[4U * i + 2U] << 16
+                 | (uint32_t)bytes[4U * i + 3U] << 24;
+    }
+}
+
+/* ----------------------------------------------------------------------- */
+/* System calls                                                             */
+/* ----------------------------------------------------------------------- */
+
+static int sys_open(void *ctx, const char *path)
+{
+    (void)ctx;
+    int fd = open(path, O_RDWR | O_CLOEXEC);
+    return fd < 0 ? -errno : fd;
+}
+
+static void sys_close(void *ctx, int fd)
+{
+    (void)ctx;
+    close(fd);
+}
+
+static int sys_ioctl(void *ctx, int fd, unsigned long request, void *arg)
+{
+    (void)ctx;
+    int ret;
+    do
+    {
+        ret = ioctl(fd, request, arg);
+    } while (ret < 0 && errno == EINTR);
+    return ret < 0 ? -errno : 0;
+}
+
+const acs_linux_ops_t acs_linux_default_ops = { sys_open, sys_close, sys_ioctl, NULL };
+
+/**
+ * @brief An address NAK shows up as ENXIO or EREMOTEIO depending on the
+ * adapter driver.
+ */
+static int map_errno(int err)
+{
+    return (err == -ENXIO || err == -EREMOTEIO) ? ACS_ERR_NAK : ACS_ERR_BUS;
+}
+
+static int port_ioctl(acs_linux_t *port, unsigned long request, void *arg)
+{
+    port->ioctls++;
+    int ret = port->ops->ioctl(port->ops->ctx, port->fd, request, arg);
+    if (ret < 0)
+    {
+        port->errors++;
+        return map_errno(ret);
+    }
+    return ACS_OK;
+}
+
+static bool block_valid(const uint32_t *words, uint8_t count)
+{
+    return words != NULL && count > 0U && count <= ACS_TRANSPORT_MAX_WORDS;
+}
+
+/* ----------------------------------------------------------------------- */
+/* I2C                                                                      */
+/* ----------------------------------------------------------------------- */
+
+static int i2c_read(void *ctx, uint8_t dev_addr, uint8_t reg_addr,
+                    uint32_t *words, uint8_t count)
+{
+    acs_linux_t *port = ctx;
+    uint8_t rx[4U * ACS_TRANSPORT_MAX_WORDS];
+
+    if (!block_valid(words, count))
+        return ACS_ERR_PARAM;
+
+    struct i2c_msg msgs[2] =
+    {
+        { dev_addr, 0U, 1U, &reg_addr },
+        { dev_addr, I2C_M_RD, (uint16_t)(4U * count), rx },
+    };
+    struct i2c_rdwr_ioctl_data data = { msgs, 2U };
+
+    int ret = port_ioctl(port, I2C_RDWR, &data);
+    if (ret != ACS_OK)
+        return ret;
+
+    bytes_to_words(rx, count, words);
+    return ACS_OK;
+}
+
+static int i2c_write(void *ctx, uint8_t dev_addr, uint8_t reg_addr,
+                     const uint32_t *words, uint8_t count)
+{
+    acs_linux_t *port = ctx;
+    uint8_t tx[BLOCK_BYTES];
+
+    if (!block_valid(words, count))
+        return ACS_ERR_PARAM;
+
+    tx[0] = reg_addr;
+    words_to_bytes(words, count, &tx[1]);
+
+    struct i2c_msg msg = { dev_addr, 0U, (uint16_t)(1U + 4U * count), tx };
+    struct i2c_rdwr_ioctl_data data = { &msg, 1U };
+    return port_ioctl(port, I2C_RDWR, &data);
+}
+
+/**
+ * @brief Up to ACS_LINUX_I2C_BATCH blocks in one I2C_RDWR. The kernel reports
+ * a single result for the whole message list, so when it fails the blocks
+ * are retried one by one to find out which of them failed.
+ */
+static void i2c_read_batch(acs_linux_t *port, acs_xfer_t *xfers, uint8_t count)
+{
+    struct i2c_msg msgs[2U * ACS_LINUX_I2C_BATCH];
+    uint8_t rx[ACS_LINUX_I2C_BATCH][4U * ACS_TRANSPORT_MAX_WORDS];
+    uint8_t n = 0U;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (!block_valid(xfers[i].words, xfers[i].count))
+        {
+            xfers[i].status = ACS_ERR_PARAM;
+            continue;
+        }
+        msgs[2U * n]      = (struct i2c_msg){ xfers[i].dev_addr, 0U, 1U, &xfers[i].reg_addr };
+        msgs[2U * n + 1U] = (struct i2c_msg){ xfers[i].dev_addr, I2C_M_RD,
+                                              (uint16_t)(4U * xfers[i].count), rx[i] };
+        n++;
+    }
+    if (n == 0U)
+        return;
+
+    struct i2c_rdwr_ioctl_data data = { msgs, 2U * n };
+    if (port_ioctl(port, I2C_RDWR, &data) != ACS_OK)
+    {
+        for (uint8_t i = 0; i < count; i++)
+            if (block_valid(xfers[i].words, xfers[i].count))
+                xfers[i].status = i2c_read(port, xfers[i].dev_addr, xfers[i].reg_addr,
+                                           xfers[i].words, xfers[i].count);
+        return;
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (!block_valid(xfers[i].words, xfers[i].count))
+            continue;
+        bytes_to_words(rx[i], xfers[i].count, xfers[i].words);
+        xfers[i].status = ACS_OK;
+    }
+}
+
+/* ----------------------------------------------------------------------- */
+/* SPI                                                                      */
+/* ----------------------------------------------------------------------- */
+
+static int spi_transfer(acs_linux_t *port, struct spi_ioc_transfer *tr, uint8_t count)
+{
+    return port_ioctl(port, SPI_IOC_MESSAGE(count), tr);
+}
+
+static void spi_fill(struct spi_ioc_transfer *tr, const uint8_t *tx, uint8_t *rx,
+                     uint32_t len, uint32_t speed_hz)
+{
+    memset(tr, 0, sizeof(*tr));
+    tr->tx_buf        = (uintptr_t)tx;
+    tr->rx_buf        = (uintptr_t)rx;
+    tr->len           = len;
+    tr->speed_hz      = speed_hz;
+    tr->bits_per_word = 8U;
+}
+
+static int spi_read(void *ctx, uint8_t dev_addr, uint8_t reg_addr,
+                    uint32_t *words, uint8_t count)
+{
+    acs_linux_t *port = ctx;
+    uint8_t tx[BLOCK_BYTES] = { 0 };
+    uint8_t rx[BLOCK_BYTES];
+    struct spi_ioc_transfer tr;
+    (void)dev_addr;
+
+    if (!block_valid(words, count))
+        return ACS_ERR_PARAM;
+
+    tx[0] = reg_addr | ACS_SPI_READ_BIT;
+    spi_fill(&tr, tx, rx, 1U + 4U * count, port->spi_speed_hz);
+
+    int ret = spi_transfer(port, &tr, 1U);
+    if (ret != ACS_OK)
+        return ret;
+
+    bytes_to_words(&rx[1], count, words);
+    return ACS_OK;
+}
+
+static int spi_write(void *ctx, uint8_t dev_addr, uint8_t reg_addr,
+                     const uint32_t *words, uint8_t count)
+{
+    acs_linux_t *port = ctx;
+    uint8_t tx[BLOCK_BYTES];
+    struct spi_ioc_transfer tr;
+    (void)dev_addr;
+
+    if (!block_valid(words, count))
+        return ACS_ERR_PARAM;
+
+    tx[0] = reg_addr & (uint8_t)~ACS_SPI_READ_BIT;
+    words_to_bytes(words, count, &tx[1]);
+    spi_fill(&tr, tx, NULL, 1U + 4U * count, port->spi_speed_hz);
+    return spi_transfer(port, &tr, 1U);
+}
+
+/**
+ * @brief Up to ACS_LINUX_SPI_BATCH blocks in one SPI_IOC_MESSAGE, chip select
+ * released between blocks.
+ */
+static void spi_read_batch(acs_linux_t *port, acs_xfer_t *xfers, uint8_t count)
+{
+    struct spi_ioc_transfer tr[ACS_LINUX_SPI_BATCH];
+    uint8_t tx[ACS_LINUX_SPI_BATCH][BLOCK_BYTES];
+    uint8_t rx[ACS_LINUX_SPI_BATCH][BLOCK_BYTES];
+    uint8_t n = 0U;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (!block_valid(xfers[i].words, xfers[i].count))
+        {
+            xfers[i].status = ACS_ERR_PARAM;
+            continue;
+        }
+        memset(tx[i], 0, sizeof(tx[i]));
+        tx[i][0] = xfers[i].reg_addr | ACS_SPI_READ_BIT;
+        spi_fill(&tr[n], tx[i], rx[i], 1U + 4U * xfers[i].count, port->spi_speed_hz);
+        tr[n].cs_change = 1U;
+        n++;
+    }
+    if (n == 0U)
+        return;
+
+    // On the last transfer cs_change would keep chip select asserted
+    tr[n - 1U].cs_change = 0U;
+
+    int ret = spi_transfer(port, tr, n);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (!block_valid(xfers[i].words, xfers[i].count))
+            continue;
+        if (ret == ACS_OK)
+            bytes_to_words(&rx[i][1], xfers[i].count, xfers[i].words);
+        xfers[i].status = ret;
+    }
+}
+
+/* ----------------------------------------------------------------------- */
+/* Transport                                                                */
+/* ----------------------------------------------------------------------- */
+
+static int linux_read_multi(void *ctx, acs_xfer_t *xfers, uint8_t count)
+{
+    acs_linux_t *port = ctx;
+    uint8_t batch = port->bus == ACS_LINUX_I2C ? ACS_LINUX_I2C_BATCH : ACS_LINUX_SPI_BATCH;
+
+    if (xfers == NULL)
+        return ACS_ERR_PARAM;
+
+    for (uint8_t first = 0; first < count; first += batch)
+    {
+        uint8_t n = (uint8_t)(count - first < batch ? count - first : batch);
+        if (port->bus == ACS_LINUX_I2C)
+            i2c_read_batch(port, &xfers[first], n);
+        else
+            spi_read_batch(port, &xfers[first], n);
+    }
+    return ACS_OK;
+}
+
+static int port_open(acs_linux_t *port, const char *path, const acs_linux_ops_t *ops,
+                     acs_linux_bus_t bus)
+{
+    memset(port, 0, sizeof(*port));
+    port->ops = ops != NULL ? ops : &acs_linux_default_ops;
+    port->bus = bus;
+    port->fd  = port->ops->open(port->ops->ctx, path);
+    if (port->fd < 0)
+    {
+        port->fd = -1;
+        return ACS_ERR_BUS;
+    }
+    return ACS_OK;
+}
+
+int acs_linux_open_i2c(acs_linux_t *port, const char *path, const acs_linux_ops_t *ops)
+{
+    if (port == NULL || path == NULL)
+        return ACS_ERR_PARAM;
+
+    return port_open(port, path, ops, ACS_LINUX_I2C);
+}
+
+int acs_linux_open_spi(acs_linux_t *port, const char *path, uint32_t speed_hz,
+                       const acs_linux_ops_t *ops)
+{
+    uint8_t mode = SPI_MODE_3;
+    uint8_t bits = 8U;
+
+    if (port == NULL || path == NULL || speed_hz == 0U)
+        return ACS_ERR_PARAM;
+
+    int ret = port_open(port, path, ops, ACS_LINUX_SPI);
+    if (ret != ACS_OK)
+        return ret;
+
+    port->spi_speed_hz = speed_hz;
+    if (port_ioctl(port, SPI_IOC_WR_MODE, &mode) != ACS_OK ||
+        port_ioctl(port, SPI_IOC_WR_BITS_PER_WORD, &bits) != ACS_OK ||
+        port_ioctl(port, SPI_IOC_WR_MAX_SPEED_HZ, &port->spi_speed_hz) != ACS_OK)
+    {
+        acs_linux_close(port);
+        return ACS_ERR_BUS;
+    }
+    return ACS_OK;
+}
+
+void acs_linux_close(acs_linux_t *port)
+{
+    if (port->fd >= 0)
+        port->ops->close(port->ops->ctx, port->fd);
+    port->fd = -1;
+}
+
+void acs_transport_linux_init(acs_transport_t *transport, acs_linux_t *port)
+{
+    transport->read       = port->bus == ACS_LINUX_I2C ? i2c_read : spi_read;
+    transport->write      = port->bus == ACS_LINUX_I2C ? i2c_write : spi_write;
+    transport->read_multi = linux_read_multi;
+    transport->ctx        = port;
+}
+
+/* ----------------------------------------------------------------------- */
+/* Fake kernel                                                              */
+/* ----------------------------------------------------------------------- */
+
+#define FAKE_FD 3
+
+static int fake_open(void *ctx, const char *path)
+{
+    acs_linux_fake_t *fake = ctx;
+    (void)path;
+    fake->opens++;
+    return FAKE_FD;
+}
+
+static void fake_close(void *ctx, int fd)
+{
+    acs_linux_fake_t *fake = ctx;
+    (void)fd;
+    fake->closes++;
+}
+
+static int fake_status(int ret)
+{
+    if (ret == ACS_OK)
+        return 0;
+    return ret == ACS_ERR_NAK ? -ENXIO : -EIO;
+}
+
+/**
+ * @brief A one byte write followed by a read is a register read, a longer
+ * write on its own is a register write. Stops at the first failing message,
+ * like an adapter would.
+ */
+static int fake_i2c_rdwr(acs_linux_fake_t *fake, const struct i2c_rdwr_ioctl_data *data)
+{
+    const acs_transport_t *t = fake->target;
+    uint32_t words[ACS_TRANSPORT_MAX_WORDS];
+
+    for (uint32_t i = 0; i < data->nmsgs; i++)
+    {
+        const struct i2c_msg *m = &data->msgs[i];
+        int ret;
+
+        fake->messages++;
+        if ((m->flags & I2C_M_RD) != 0U || m->len < 1U)
+            return -EINVAL;
+
+        if (m->len == 1U)
+        {
+            const struct i2c_msg *r = &data->msgs[i + 1U];
+            if (i + 1U >= data->nmsgs || (r->flags & I2C_M_RD) == 0U || r->addr != m->addr ||
+                r->len % 4U != 0U || r->len / 4U > ACS_TRANSPORT_MAX_WORDS)
+                return -EINVAL;
+
+            fake->messages++;
+            ret = t->read(t->ctx, (uint8_t)m->addr, m->buf[0], words, (uint8_t)(r->len / 4U));
+            if (ret == ACS_OK)
+                words_to_bytes(words, (uint8_t)(r->len / 4U), r->buf);
+            i++;
+        }
+        else
+        {
+            if ((m->len - 1U) % 4U != 0U || (m->len - 1U) / 4U > ACS_TRANSPORT_MAX_WORDS)
+                return -EINVAL;
+
+            bytes_to_words(&m->buf[1], (uint8_t)((m->len - 1U) / 4U), words);
+            ret = t->write(t->ctx, (uint8_t)m->addr, m->buf[0], words, (uint8_t)((m->len - 1U) / 4U));
+        }
+
+        if (ret != ACS_OK)
+            return fake_status(ret);
+    }
+    return 0;
+}
+
+static int fake_spi_message(acs_linux_fake_t *fake, const struct spi_ioc_transfer *tr, uint32_t count)
+{
+    const acs_transport_t *t = fake->target;
+    uint32_t words[ACS_TRANSPORT_MAX_WORDS];
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const uint8_t *tx = (const uint8_t *)(uintptr_t)tr[i].tx_buf;
+        uint8_t       *rx = (uint8_t *)(uintptr_t)tr[i].rx_buf;
+        uint8_t        n  = (uint8_t)((tr[i].len - 1U) / 4U);
+        int            ret;
+
+        fake->messages++;
+        if (tx == NULL || tr[i].len < 5U || (tr[i].len - 1U) % 4U != 0U || n > ACS_TRANSPORT_MAX_WORDS)
+            return -EINVAL;
+
+        if ((tx[0] & ACS_SPI_READ_BIT) != 0U)
+        {
+            ret = t->read(t->ctx, fake->spi_dev_addr, tx[0] & (uint8_t)~ACS_SPI_READ_BIT, words, n);
+            if (ret == ACS_OK && rx != NULL)
+            {
+                rx[0] = 0U;
+                words_to_bytes(words, n, &rx[1]);
+            }
+        }
+        else
+        {
+            bytes_to_words(&tx[1], n, words);
+            ret = t->write(t->ctx, fake->spi_dev_addr, tx[0], words, n);
+        }
+
+        if (ret != ACS_OK)
+            return fake_status(ret);
+    }
+    return 0;
+}
+
+static int fake_ioctl(void *ctx, int fd, unsigned long request, void *arg)
+{
+    acs_linux_fake_t *fake = ctx;
+
+    fake->ioctls++;
+    if (fd != FAKE_FD)
+        return -EBADF;
+
+    if (fake->fail_errno != 0)
+    {
+        int err = fake->fail_errno;
+        fake->fail_errno = 0;
+        return -err;
+    }
+
+    if (request == I2C_RDWR)
+        return fake_i2c_rdwr(fake, arg);
+
+    if (request == SPI_IOC_WR_MODE || request == SPI_IOC_WR_BITS_PER_WORD ||
+        request == SPI_IOC_WR_MAX_SPEED_HZ)
+        return 0;
+
+    if (_IOC_TYPE(request) == SPI_IOC_MAGIC && _IOC_NR(request) == 0U)
+        return fake_spi_message(fake, arg, _IOC_SIZE(request) / sizeof(struct spi_ioc_transfer));
+
+    return -ENOTTY;
+}
+
+void acs_linux_fake_ops(acs_linux_ops_t *ops, acs_linux_fake_t *fake,
+                        const acs_transport_t *target)
+{
+    memset(fake, 0, sizeof(*fake));
+    fake->target = target;
+
+    ops->open  = fake_open;
+    ops->close = fake_close;
+    ops->ioctl = fake_ioctl;
+    ops->ctx   = fake;
+}
+
+/* ----------------------------------------------------------------------- */
+/* Polling thread                                                           */
+/* ----------------------------------------------------------------------- */
+
+static uint64_t timespec_us(const struct timespec *ts)
+{
+    return (uint64_t)ts->tv_sec * 1000000U + (uint64_t)ts->tv_nsec / 1000U;
+}
+
+static void timespec_add_us(struct timespec *ts, uint32_t us)
+{
+    ts->tv_nsec += (long)(us % 1000000U) * 1000L;
+    ts->tv_sec  += (time_t)(us / 1000000U);
+    if (ts->tv_nsec >= 1000000000L)
+    {
+        ts->tv_nsec -= 1000000000L;
+        ts->tv_sec++;
+    }
+}
+
+static void *poller_main(void *arg)
+{
+    acs_linux_poller_t *poller = arg;
+    struct timespec next;
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    while (!atomic_load(&poller->stop))
+    {
+        (void)acs_transport_read_multi(poller->transport, poller->xfers, poller->count);
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (poller->callback != NULL)
+            poller->callback(poller->user, poller->xfers, poller->count, timespec_us(&now));
+        atomic_fetch_add(&poller->cycles, 1U);
+
+        // Late batches are not caught up on, the schedule restarts from now
+        timespec_add_us(&next, poller->period_us);
+        if (timespec_us(&now) >= timespec_us(&next))
+        {
+            atomic_fetch_add(&poller->overruns, 1U);
+            next = now;
+            continue;
+        }
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) == EINTR)
+            ;
+    }
+    return NULL;
+}
+
+void acs_linux_poller_init(acs_linux_poller_t *poller)
+{
+    memset(poller, 0, sizeof(*poller));
+    atomic_init(&poller->stop, false);
+    atomic_init(&poller->cycles, 0U);
+    atomic_init(&poller->overruns, 0U);
+}
+
+int acs_linux_poller_start(acs_linux_poller_t *poller, const acs_transport_t *transport,
+                           acs_xfer_t *xfers, uint8_t count, uint32_t period_us,
+                           int priority, acs_linux_poll_callback_t callback, void *user)
+{
+    pthread_attr_t attr;
+
+    if (poller == NULL || transport == NULL || xfers == NULL || count == 0U || period_us == 0U)
+        return ACS_ERR_PARAM;
+    if (poller->running)
+        return ACS_ERR_BUSY;
+
+    poller->transport = transport;
+    poller->xfers     = xfers;
+    poller->count     = count;
+    poller->period_us = period_us;
+    poller->callback  = callback;
+    poller->user      = user;
+    poller->realtime  = false;
+    atomic_store(&poller->stop, false);
+    atomic_store(&poller->cycles, 0U);
+    atomic_store(&poller->overruns, 0U);
+
+    int ret = -1;
+    if (priority > 0 && pthread_attr_init(&attr) == 0)
+    {
+        struct sched_param param = { .sched_priority = priority };
+        if (pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED) == 0 &&
+            pthread_attr_setschedpolicy(&attr, SCHED_FIFO) == 0 &&
+            pthread_attr_setschedparam(&attr, &param) == 0)
+            ret = pthread_create(&poller->thread, &attr, poller_main, poller);
+        pthread_attr_destroy(&attr);
+        poller->realtime = ret == 0;
+    }
+
+    // Realtime needs CAP_SYS_NICE or an rtprio limit, run without it otherwise
+    if (ret != 0)
+        ret = pthread_create(&poller->thread, NULL, poller_main, poller);
+    if (ret != 0)
+        return ACS_ERR_PARAM;
+
+    poller->running = true;
+    return ACS_OK;
+}
+
+void acs_linux_poller_stop(acs_linux_poller_t *poller)
+{
+    if (!poller->running)
+        return;
+
+    atomic_store(&poller->stop, true);
+    pthread_join(poller->thread, NULL);
+    poller->running = false;
+}
+
+#else
+
+typedef int acs_linux_unused_t; // ISO C forbids an empty translation unit
+
+#endif // __linux__
\ No newline at end of file
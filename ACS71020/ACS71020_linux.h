@@ -0,0 +1,161 @@
+/**
+ * @file ACS71020_linux.h
+ * @author Usman Mehmood (usmanmehmood55@gmail.com)
+ * @brief Linux transport over i2c-dev and spidev. The bus device is opened
+ * once and its file descriptor kept for every transfer. A read_multi batch
+ * goes to the kernel as a single ioctl: one I2C_RDWR with an address write
+ * and a data read message per block, or one SPI_IOC_MESSAGE with a transfer
+ * per block. Every system call goes through acs_linux_ops_t, so a fake file
+ * descriptor layer can stand in for the kernel. An optional polling thread
+ * repeats a batch at a fixed period, with realtime priority if allowed.
+ * Only built on Linux.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _ACS71020_linux_H_
+#define _ACS71020_linux_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "ACS71020.h"
+
+/**
+ * @brief Blocks per ioctl. I2C_RDWR takes at most 42 messages, two per block.
+ */
+#define ACS_LINUX_I2C_BATCH 21U
+#define ACS_LINUX_SPI_BATCH 16U
+
+/**
+ * @brief System calls used by the backend. Each returns a file descriptor or
+ * 0 on success, and a negative errno on failure.
+ */
+typedef struct
+{
+    int  (*open)(void *ctx, const char *path);
+    void (*close)(void *ctx, int fd);
+    int  (*ioctl)(void *ctx, int fd, unsigned long request, void *arg);
+    void  *ctx;
+} acs_linux_ops_t;
+
+/**
+ * @brief The real system calls.
+ */
+extern const acs_linux_ops_t acs_linux_default_ops;
+
+typedef enum
+{
+    ACS_LINUX_I2C,
+    ACS_LINUX_SPI,
+} acs_linux_bus_t;
+
+typedef struct
+{
+    const acs_linux_ops_t *ops;
+    acs_linux_bus_t        bus;
+    int                    fd;
+    uint32_t               spi_speed_hz;
+
+    uint32_t               ioctls;
+    uint32_t               errors;
+} acs_linux_t;
+
+/**
+ * @brief Opens an i2c-dev node such as "/dev/i2c-1". Device addresses are
+ * carried by each message, so one descriptor serves every device on the bus.
+ * @param ops NULL for acs_linux_default_ops
+ * @return ACS_OK or ACS_ERR_BUS
+ */
+int acs_linux_open_i2c(acs_linux_t *port, const char *path, const acs_linux_ops_t *ops);
+
+/**
+ * @brief Opens a spidev node such as "/dev/spidev0.0" and sets SPI mode 3,
+ * 8 bit words and the clock. One node is one chip select, dev_addr is ignored.
+ * @param ops NULL for acs_linux_default_ops
+ * @return ACS_OK or ACS_ERR_BUS
+ */
+int acs_linux_open_spi(acs_linux_t *port, const char *path, uint32_t speed_hz,
+                       const acs_linux_ops_t *ops);
+
+void acs_linux_close(acs_linux_t *port);
+
+/**
+ * @brief Builds a transport, with read_multi, on an open port.
+ */
+void acs_transport_linux_init(acs_transport_t *transport, acs_linux_t *port);
+
+/**
+ * @brief Fake kernel for acs_linux_ops_t. Descriptors are accepted for any
+ * path and the I2C_RDWR and SPI_IOC_MESSAGE ioctls are carried out, message
+ * by message, on the register files behind target, e.g. a fake bus.
+ */
+typedef struct
+{
+    const acs_transport_t *target;
+    uint8_t                spi_dev_addr;    // Address the SPI node maps to
+
+    uint32_t               opens;
+    uint32_t               closes;
+    uint32_t               ioctls;
+    uint32_t               messages;
+
+    int                    fail_errno;      // When not 0, the next ioctl fails once with it
+} acs_linux_fake_t;
+
+void acs_linux_fake_ops(acs_linux_ops_t *ops, acs_linux_fake_t *fake,
+                        const acs_transport_t *target);
+
+/**
+ * @brief Called by the polling thread after every batch, from the thread.
+ */
+typedef void (*acs_linux_poll_callback_t)(void *user, const acs_xfer_t *xfers,
+                                          uint8_t count, uint64_t now_us);
+
+typedef struct
+{
+    const acs_transport_t    *transport;
+    acs_xfer_t               *xfers;
+    uint8_t                   count;
+    uint32_t                  period_us;
+    acs_linux_poll_callback_t callback;
+    void                     *user;
+
+    pthread_t                 thread;
+    atomic_bool               stop;
+    bool                      running;
+    bool                      realtime;     // SCHED_FIFO was granted
+
+    _Atomic uint32_t          cycles;
+    _Atomic uint32_t          overruns;     // Periods missed because a batch ran late
+} acs_linux_poller_t;
+
+/**
+ * @brief Puts a poller in the stopped state. Must be called once before the
+ * first acs_linux_poller_start(), the poller may then be started and stopped
+ * any number of times.
+ */
+void acs_linux_poller_init(acs_linux_poller_t *poller);
+
+/**
+ * @brief Starts a thread that issues the batch every period_us. The poller
+ * must have been through acs_linux_poller_init().
+ * @param priority SCHED_FIFO priority, or 0 for normal scheduling. Falls back
+ * to normal scheduling when realtime is not permitted.
+ * @return ACS_OK, ACS_ERR_PARAM or ACS_ERR_BUSY if already running
+ */
+int acs_linux_poller_start(acs_linux_poller_t *poller, const acs_transport_t *transport,
+                           acs_xfer_t *xfers, uint8_t count, uint32_t period_us,
+                           int priority, acs_linux_poll_callback_t callback, void *user);
+
+/**
+ * @brief Stops the thread and waits for it to exit.
+ */
+void acs_linux_poller_stop(acs_linux_poller_t *poller);
+
+#endif // _ACS71020_linux_H_
\ No newline at end of file
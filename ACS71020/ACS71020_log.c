@@ -0,0 +1,215 @@
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200112L
+#define _DEFAULT_SOURCE         // madvise
+#endif
+
+#include <string.h>
+#include "ACS71020_log.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ACS_LOG_MMAP 1
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+static bool header_valid(const acs_log_header_t *h)
+{
+    return memcmp(h->magic, ACS_LOG_MAGIC, sizeof(h->magic)) == 0 &&
+           h->version == ACS_LOG_VERSION &&
+           h->header_size == sizeof(acs_log_header_t) &&
+           h->record_size == sizeof(acs_log_record_t) &&
+           h->byte_order == ACS_LOG_BYTE_ORDER;
+}
+
+int acs_log_create(acs_log_writer_t *writer, const char *path,
+                   const acs_full_scale_t *fs, const uint32_t *eeprom)
+{
+    acs_log_header_t h;
+
+    if (writer == NULL || path == NULL || fs == NULL)
+        return ACS_ERR_PARAM;
+
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, ACS_LOG_MAGIC, sizeof(h.magic));
+    h.version            = ACS_LOG_VERSION;
+    h.header_size        = sizeof(acs_log_header_t);
+    h.record_size        = sizeof(acs_log_record_t);
+    h.byte_order         = ACS_LOG_BYTE_ORDER;
+    h.full_scale_current = fs->current;
+    h.full_scale_voltage = fs->voltage;
+    h.full_scale_power   = fs->power;
+    if (eeprom != NULL)
+        memcpy(h.eeprom, eeprom, sizeof(h.eeprom));
+
+    writer->records = 0U;
+    writer->file = fopen(path, "wb");
+    if (writer->file == NULL)
+        return ACS_ERR_IO;
+
+    if (fwrite(&h, sizeof(h), 1U, writer->file) != 1U)
+    {
+        fclose(writer->file);
+        writer->file = NULL;
+        return ACS_ERR_IO;
+    }
+    return ACS_OK;
+}
+
+int acs_log_open_append(acs_log_writer_t *writer, const char *path)
+{
+    acs_log_header_t h;
+
+    if (writer == NULL || path == NULL)
+        return ACS_ERR_PARAM;
+
+    writer->records = 0U;
+    writer->file = fopen(path, "r+b");
+    if (writer->file == NULL)
+        return ACS_ERR_IO;
+
+    int ret = ACS_ERR_PARAM;
+    if (fread(&h, sizeof(h), 1U, writer->file) == 1U && header_valid(&h) &&
+        fseek(writer->file, 0L, SEEK_END) == 0)
+    {
+        long size = ftell(writer->file);
+        if (size >= (long)sizeof(h))
+        {
+            writer->records = (uint64_t)(size - (long)sizeof(h)) / sizeof(acs_log_record_t);
+            long end = (long)sizeof(h) + (long)(writer->records * sizeof(acs_log_record_t));
+            ret = fseek(writer->file, end, SEEK_SET) == 0 ? ACS_OK : ACS_ERR_IO;
+        }
+    }
+
+    if (ret != ACS_OK)
+    {
+        fclose(writer->file);
+        writer->file = NULL;
+    }
+    return ret;
+}
+
+int acs_log_append(acs_log_writer_t *writer, uint8_t dev_addr,
+                   uint64_t timestamp_us, const acs_snapshot_t *snap)
+{
+    acs_log_record_t r;
+
+    if (writer == NULL || writer->file == NULL || snap == NULL)
+        return ACS_ERR_PARAM;
+
+    memset(&r, 0, sizeof(r));
+    r.timestamp_us = timestamp_us;
+    r.snap         = *snap;
+    r.dev_addr     = dev_addr;
+
+    if (fwrite(&r, sizeof(r), 1U, writer->file) != 1U)
+        return ACS_ERR_IO;
+
+    writer->records++;
+    return ACS_OK;
+}
+
+int acs_log_flush(acs_log_writer_t *writer)
+{
+    if (writer == NULL || writer->file == NULL)
+        return ACS_ERR_PARAM;
+
+    return fflush(writer->file) == 0 ? ACS_OK : ACS_ERR_IO;
+}
+
+int acs_log_close(acs_log_writer_t *writer)
+{
+    if (writer == NULL)
+        return ACS_ERR_PARAM;
+    if (writer->file == NULL)
+        return ACS_OK;
+
+    int ret = fclose(writer->file) == 0 ? ACS_OK : ACS_ERR_IO;
+    writer->file = NULL;
+    return ret;
+}
+
+int acs_log_open_buffer(acs_log_reader_t *reader, const void *data, size_t size)
+{
+    if (reader == NULL)
+        return ACS_ERR_PARAM;
+    memset(reader, 0, sizeof(*reader));
+
+    if (data == NULL || size < sizeof(acs_log_header_t) || ((uintptr_t)data & 7U) != 0U)
+        return ACS_ERR_PARAM;
+
+    const acs_log_header_t *h = data;
+    if (!header_valid(h))
+        return ACS_ERR_PARAM;
+
+    reader->header  = h;
+    reader->records = (const acs_log_record_t *)((const uint8_t *)data + sizeof(*h));
+    reader->count   = (size - sizeof(*h)) / sizeof(acs_log_record_t);
+    return ACS_OK;
+}
+
+int acs_log_open(acs_log_reader_t *reader, const char *path)
+{
+#if defined(ACS_LOG_MMAP)
+    struct stat st;
+
+    if (reader == NULL || path == NULL)
+        return ACS_ERR_PARAM;
+    memset(reader, 0, sizeof(*reader));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return ACS_ERR_IO;
+
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return ACS_ERR_IO;
+    }
+    if (st.st_size < (off_t)sizeof(acs_log_header_t))
+    {
+        close(fd);
+        return ACS_ERR_PARAM;
+    }
+
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return ACS_ERR_IO;
+
+    // Records are walked front to back
+    (void)madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    int ret = acs_log_open_buffer(reader, map, (size_t)st.st_size);
+    if (ret != ACS_OK)
+    {
+        munmap(map, (size_t)st.st_size);
+        return ret;
+    }
+
+    reader->map      = map;
+    reader->map_size = (size_t)st.st_size;
+    return ACS_OK;
+#else
+    (void)reader;
+    (void)path;
+    return ACS_ERR_PARAM;
+#endif
+}
+
+void acs_log_close_reader(acs_log_reader_t *reader)
+{
+#if defined(ACS_LOG_MMAP)
+    if (reader->map != NULL)
+        munmap(reader->map, reader->map_size);
+#endif
+    memset(reader, 0, sizeof(*reader));
+}
+
+void acs_log_full_scale(const acs_log_reader_t *reader, acs_full_scale_t *fs)
+{
+    fs->current = reader->header->full_scale_current;
+    fs->voltage = reader->header->full_scale_voltage;
+    fs->power   = reader->header->full_scale_power;
+}
\ No newline at end of file
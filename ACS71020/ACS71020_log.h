@@ -0,0 +1,125 @@
+/**
+ * @file ACS71020_log.h
+ * @author Usman Mehmood (usmanmehmood55@gmail.com)
+ * @brief Binary snapshot log. A file is one fixed header, holding the
+ * full-scale multipliers and the EEPROM configuration the data was taken
+ * with, followed by fixed size records of raw 0x20 to 0x2D words with a
+ * timestamp and device address. Records are appended with stdio and read
+ * back in place from a memory mapping, without parsing or copying.
+ * All fields are stored in the host's byte order, which the header records;
+ * files are only readable on hosts of the same byte order.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _ACS71020_log_H_
+#define _ACS71020_log_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "ACS71020.h"
+#include "ACS71020_decode.h"
+
+#define ACS_LOG_MAGIC       "ACS71LOG"
+#define ACS_LOG_VERSION     1U
+#define ACS_LOG_BYTE_ORDER  0x01020304U
+
+typedef struct
+{
+    char     magic[8];
+    uint16_t version;
+    uint16_t header_size;
+    uint32_t record_size;
+    uint32_t byte_order;
+    uint32_t eeprom[ACS_EEPROM_WORDS];          // 0x0B to 0x0F
+    double   full_scale_current;
+    double   full_scale_voltage;
+    double   full_scale_power;
+} acs_log_header_t;
+
+typedef struct
+{
+    uint64_t       timestamp_us;
+    acs_snapshot_t snap;
+    uint8_t        dev_addr;
+    uint8_t        reserved[7];
+} acs_log_record_t;
+
+_Static_assert(sizeof(acs_log_header_t) == 64U, "log header layout changed");
+_Static_assert(sizeof(acs_log_record_t) == 72U, "log record layout changed");
+
+typedef struct
+{
+    FILE    *file;
+    uint64_t records;
+} acs_log_writer_t;
+
+typedef struct
+{
+    const acs_log_header_t *header;
+    const acs_log_record_t *records;
+    size_t                  count;
+
+    void                   *map;
+    size_t                  map_size;
+} acs_log_reader_t;
+
+/**
+ * @brief Creates or truncates a log file and writes its header.
+ * @param eeprom the five EEPROM words 0x0B to 0x0F, may be NULL
+ * @return ACS_OK, ACS_ERR_PARAM or ACS_ERR_IO if the file cannot be created
+ * or written
+ */
+int acs_log_create(acs_log_writer_t *writer, const char *path,
+                   const acs_full_scale_t *fs, const uint32_t *eeprom);
+
+/**
+ * @brief Opens an existing log to append to it. A partially written last
+ * record is overwritten.
+ * @return ACS_OK, ACS_ERR_PARAM if the file is not a compatible log, or
+ * ACS_ERR_IO if it cannot be opened or read
+ */
+int acs_log_open_append(acs_log_writer_t *writer, const char *path);
+
+/**
+ * @brief Appends one record. Buffered, use acs_log_flush() to force it out.
+ * @return ACS_OK, ACS_ERR_PARAM if the writer is not open, or ACS_ERR_IO
+ */
+int acs_log_append(acs_log_writer_t *writer, uint8_t dev_addr,
+                   uint64_t timestamp_us, const acs_snapshot_t *snap);
+
+int acs_log_flush(acs_log_writer_t *writer);
+
+int acs_log_close(acs_log_writer_t *writer);
+
+/**
+ * @brief Maps a log file read-only. Records can then be walked directly in
+ * reader->records.
+ * @return ACS_OK, ACS_ERR_PARAM if the file is not a compatible log, or
+ * ACS_ERR_IO if it cannot be opened or read
+ */
+int acs_log_open(acs_log_reader_t *reader, const char *path);
+
+/**
+ * @brief Reads a log from a buffer already in memory. The buffer must be 8
+ * byte aligned and outlive the reader.
+ * @return ACS_OK or ACS_ERR_PARAM
+ */
+int acs_log_open_buffer(acs_log_reader_t *reader, const void *data, size_t size);
+
+/**
+ * @brief Unmaps the file, if it was mapped.
+ */
+void acs_log_close_reader(acs_log_reader_t *reader);
+
+/**
+ * @brief Full-scale multipliers stored in the header.
+ */
+void acs_log_full_scale(const acs_log_reader_t *reader, acs_full_scale_t *fs);
+
+#endif // _ACS71020_log_H_
\ No newline at end of file
@@ -0,0 +1,290 @@
+#include <string.h>
+#include "ACS71020_pack.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#define LANE_VALUES (ACS_PACK_BLOCK / ACS_PACK_LANES)
+
+static inline uint32_t zigzag(uint32_t d)
+{
+    return (d << 1) ^ (0U - (d >> 31));
+}
+
+static inline uint32_t unzigzag(uint32_t u)
+{
+    return (u >> 1) ^ (0U - (u & 1U));
+}
+
+size_t acs_pack_encode_block(const int32_t *values, uint32_t count, uint8_t *out)
+{
+    uint32_t zz[ACS_PACK_BLOCK] = { 0 };
+    uint32_t packed[ACS_PACK_BLOCK] = { 0 };
+    acs_pack_header_t h;
+
+    if (count == 0U || count > ACS_PACK_BLOCK)
+        return 0U;
+
+    // Differences wrap modulo 2^32 so any int32_t stream round trips
+    uint32_t prev = (uint32_t)values[0];
+    uint32_t any  = 0U;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        zz[i] = zigzag((uint32_t)values[i] - prev);
+        prev  = (uint32_t)values[i];
+        any  |= zz[i];
+    }
+
+    uint8_t width = 0U;
+    while (width < 32U && (any >> width) != 0U)
+        width++;
+
+    // Value 4j + l goes to lane l at bit j * width of that lane
+    for (uint32_t j = 0; j < LANE_VALUES; j++)
+    {
+        uint32_t bit = j * width;
+        uint32_t k   = bit >> 5;
+        uint32_t o   = bit & 31U;
+
+        for (uint32_t l = 0; l < ACS_PACK_LANES; l++)
+        {
+            uint32_t v = zz[j * ACS_PACK_LANES + l];
+            packed[k * ACS_PACK_LANES + l] |= v << o;
+            if (o + width > 32U)
+                packed[(k + 1U) * ACS_PACK_LANES + l] |= v >> (32U - o);
+        }
+    }
+
+    h.first    = values[0];
+    h.width    = width;
+    h.reserved = 0U;
+    h.count    = (uint16_t)count;
+
+    memcpy(out, &h, sizeof(h));
+    memcpy(out + sizeof(h), packed, (size_t)width * ACS_PACK_LANES * sizeof(uint32_t));
+    return acs_pack_block_bytes(width);
+}
+
+/**
+ * @brief Unpacks all ACS_PACK_BLOCK differences of a block and integrates
+ * them, four values per step.
+ */
+static void unpack_block(const uint32_t *p, uint8_t width, int32_t first, int32_t *values)
+{
+    const uint32_t mask = width == 32U ? 0xFFFFFFFFU : (1U << width) - 1U;
+
+#if defined(__SSE2__)
+    const __m128i vmask = _mm_set1_epi32((int)mask);
+    const __m128i one   = _mm_set1_epi32(1);
+    const __m128i zero  = _mm_setzero_si128();
+    __m128i carry = _mm_set1_epi32(first);
+
+    for (uint32_t j = 0; j < LANE_VALUES; j++)
+    {
+        uint32_t bit = j * width;
+        uint32_t k   = bit >> 5;
+        uint32_t o   = bit & 31U;
+
+        __m128i v = _mm_srl_epi32(_mm_loadu_si128((const __m128i *)&p[k * ACS_PACK_LANES]),
+                                  _mm_cvtsi32_si128((int)o));
+        if (o + width > 32U)
+            v = _mm_or_si128(v, _mm_sll_epi32(_mm_loadu_si128((const __m128i *)&p[(k + 1U) * ACS_PACK_LANES]),
+                                              _mm_cvtsi32_si128((int)(32U - o))));
+        v = _mm_and_si128(v, vmask);
+
+        __m128i d = _mm_xor_si128(_mm_srli_epi32(v, 1), _mm_sub_epi32(zero, _mm_and_si128(v, one)));
+        d = _mm_add_epi32(d, _mm_slli_si128(d, 4));
+        d = _mm_add_epi32(d, _mm_slli_si128(d, 8));
+
+        __m128i x = _mm_add_epi32(d, carry);
+        _mm_storeu_si128((__m128i *)&values[j * ACS_PACK_LANES], x);
+        carry = _mm_shuffle_epi32(x, 0xFF);
+    }
+#elif defined(__ARM_NEON)
+    const uint32x4_t vmask = vdupq_n_u32(mask);
+    const uint32x4_t one   = vdupq_n_u32(1U);
+    const uint32x4_t zero  = vdupq_n_u32(0U);
+    uint32x4_t carry = vdupq_n_u32((uint32_t)first);
+
+    for (uint32_t j = 0; j < LANE_VALUES; j++)
+    {
+        uint32_t bit = j * width;
+        uint32_t k   = bit >> 5;
+        uint32_t o   = bit & 31U;
+
+        uint32x4_t v = vshlq_u32(vld1q_u32(&p[k * ACS_PACK_LANES]), vdupq_n_s32(-(int32_t)o));
+        if (o + width > 32U)
+            v = vorrq_u32(v, vshlq_u32(vld1q_u32(&p[(k + 1U) * ACS_PACK_LANES]),
+                                       vdupq_n_s32((int32_t)(32U - o))));
+        v = vandq_u32(v, vmask);
+
+        uint32x4_t d = veorq_u32(vshrq_n_u32(v, 1), vsubq_u32(zero, vandq_u32(v, one)));
+        d = vaddq_u32(d, vextq_u32(zero, d, 3));
+        d = vaddq_u32(d, vextq_u32(zero, d, 2));
+
+        uint32x4_t x = vaddq_u32(d, carry);
+        vst1q_s32(&values[j * ACS_PACK_LANES], vreinterpretq_s32_u32(x));
+        carry = vdupq_n_u32(vgetq_lane_u32(x, 3));
+    }
+#else
+    uint32_t acc = (uint32_t)first;
+
+    for (uint32_t j = 0; j < LANE_VALUES; j++)
+    {
+        uint32_t bit = j * width;
+        uint32_t k   = bit >> 5;
+        uint32_t o   = bit & 31U;
+
+        for (uint32_t l = 0; l < ACS_PACK_LANES; l++)
+        {
+            uint32_t v = p[k * ACS_PACK_LANES + l] >> o;
+            if (o + width > 32U)
+                v |= p[(k + 1U) * ACS_PACK_LANES + l] << (32U - o);
+
+            acc += unzigzag(v & mask);
+            values[j * ACS_PACK_LANES + l] = (int32_t)acc;
+        }
+    }
+#endif
+}
+
+size_t acs_pack_decode_block(const uint8_t *in, size_t size, int32_t *values, uint32_t *count)
+{
+    uint32_t packed[ACS_PACK_BLOCK];
+    acs_pack_header_t h;
+
+    if (in == NULL || values == NULL || count == NULL || size < sizeof(h))
+        return 0U;
+
+    memcpy(&h, in, sizeof(h));
+    if (h.width > 32U || h.count == 0U || h.count > ACS_PACK_BLOCK)
+        return 0U;
+
+    size_t bytes = acs_pack_block_bytes(h.width);
+    if (size < bytes)
+        return 0U;
+
+    *count = h.count;
+    if (h.width == 0U)
+    {
+        for (uint32_t i = 0; i < ACS_PACK_BLOCK; i++)
+            values[i] = h.first;
+        return bytes;
+    }
+
+    memcpy(packed, in + sizeof(h), bytes - sizeof(h));
+    unpack_block(packed, h.width, h.first, values);
+    return bytes;
+}
+
+int acs_pack_stream_init(acs_pack_stream_t *stream, uint8_t *out, size_t capacity,
+                         uint32_t *index, uint32_t index_capacity)
+{
+    if (stream == NULL || out == NULL || index == NULL)
+        return ACS_ERR_PARAM;
+
+    memset(stream, 0, sizeof(*stream));
+    stream->out            = out;
+    stream->capacity       = capacity;
+    stream->index          = index;
+    stream->index_capacity = index_capacity;
+    return ACS_OK;
+}
+
+static int flush_block(acs_pack_stream_t *stream)
+{
+    uint8_t block[ACS_PACK_MAX_BLOCK_BYTES];
+
+    if (stream->blocks >= stream->index_capacity)
+        return ACS_ERR_FULL;
+
+    size_t bytes = acs_pack_encode_block(stream->pending, stream->pending_count, block);
+    if (bytes > stream->capacity - stream->used)
+        return ACS_ERR_FULL;
+
+    memcpy(stream->out + stream->used, block, bytes);
+    stream->index[stream->blocks++] = (uint32_t)stream->used;
+    stream->used         += bytes;
+    stream->values       += stream->pending_count;
+    stream->pending_count = 0U;
+    return ACS_OK;
+}
+
+int acs_pack_stream_push(acs_pack_stream_t *stream, const int32_t *values, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        stream->pending[stream->pending_count++] = values[i];
+        if (stream->pending_count == ACS_PACK_BLOCK)
+        {
+            int ret = flush_block(stream);
+            if (ret != ACS_OK)
+            {
+                stream->pending_count--;
+                return ret;
+            }
+        }
+    }
+    return ACS_OK;
+}
+
+int acs_pack_stream_push_samples(acs_pack_stream_t *vcodes, acs_pack_stream_t *icodes,
+                                 const acs_sample_t *samples, uint32_t count)
+{
+    int32_t v[ACS_PACK_BLOCK];
+    int32_t c[ACS_PACK_BLOCK];
+    acs_pack_stream_t vsaved;
+    acs_pack_stream_t isaved;
+
+    while (count > 0U)
+    {
+        uint32_t n = count < ACS_PACK_BLOCK ? count : ACS_PACK_BLOCK;
+        for (uint32_t i = 0; i < n; i++)
+        {
+            v[i] = samples[i].vcodes;
+            c[i] = samples[i].icodes;
+        }
+
+        // The encoded size of a block is only known once it is packed, so
+        // both streams are put back if either one runs out of room
+        vsaved = *vcodes;
+        isaved = *icodes;
+
+        int ret = acs_pack_stream_push(vcodes, v, n);
+        if (ret == ACS_OK)
+            ret = acs_pack_stream_push(icodes, c, n);
+        if (ret != ACS_OK)
+        {
+            *vcodes = vsaved;
+            *icodes = isaved;
+            return ret;
+        }
+
+        samples += n;
+        count   -= n;
+    }
+    return ACS_OK;
+}
+
+int acs_pack_stream_finish(acs_pack_stream_t *stream)
+{
+    if (stream->pending_count == 0U)
+        return ACS_OK;
+    return flush_block(stream);
+}
+
+uint32_t acs_pack_stream_block(const uint8_t *data, size_t size, const uint32_t *index,
+                               uint32_t blocks, uint32_t block, int32_t *values)
+{
+    uint32_t count = 0U;
+
+    if (data == NULL || index == NULL || block >= blocks || index[block] >= size)
+        return 0U;
+
+    if (acs_pack_decode_block(data + index[block], size - index[block], values, &count) == 0U)
+        return 0U;
+    return count;
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+/**
+ * @file ACS71020_pack.h
+ * @author Usman Mehmood (usmanmehmood55@gmail.com)
+ * @brief Compression of sample streams such as vcodes, icodes and pactive.
+ * A stream is cut into blocks of ACS_PACK_BLOCK values. Each block stores its
+ * first value, then the zigzag encoded differences between neighbours packed
+ * at the smallest bit width that fits them all. Values are dealt round-robin
+ * into four 32-bit lanes, so the decoder unpacks four values per step with
+ * SIMD. Blocks are independent; with the block index kept by the stream
+ * writer any block can be decoded on its own.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _ACS71020_pack_H_
+#define _ACS71020_pack_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "ACS71020.h"
+#include "ACS71020_capture.h"
+
+#define ACS_PACK_BLOCK      128U
+#define ACS_PACK_LANES      4U
+
+typedef struct
+{
+    int32_t  first;
+    uint8_t  width;     // Bits per packed difference, 0 to 32
+    uint8_t  reserved;
+    uint16_t count;     // Values in the block, 1 to ACS_PACK_BLOCK
+} acs_pack_header_t;
+
+_Static_assert(sizeof(acs_pack_header_t) == 8U, "pack header layout changed");
+
+/**
+ * @brief Largest encoded block, for sizing buffers.
+ */
+#define ACS_PACK_MAX_BLOCK_BYTES (sizeof(acs_pack_header_t) + ACS_PACK_BLOCK * 4U)
+
+/**
+ * @brief Encoded size of a block with the given width.
+ */
+static inline size_t acs_pack_block_bytes(uint8_t width)
+{
+    return sizeof(acs_pack_header_t) + (size_t)width * ACS_PACK_LANES * sizeof(uint32_t);
+}
+
+/**
+ * @brief Streaming encoder. Encoded blocks are written back to back into out,
+ * and the byte offset of each block into index.
+ */
+typedef struct
+{
+    uint8_t  *out;
+    size_t    capacity;
+    size_t    used;
+
+    uint32_t *index;
+    uint32_t  index_capacity;
+    uint32_t  blocks;
+
+    int32_t   pending[ACS_PACK_BLOCK];
+    uint32_t  pending_count;
+    uint64_t  values;
+} acs_pack_stream_t;
+
+/**
+ * @brief Encodes one block.
+ * @param count 1 to ACS_PACK_BLOCK values
+ * @param out at least ACS_PACK_MAX_BLOCK_BYTES
+ * @return bytes written, 0 if count is out of range
+ */
+size_t acs_pack_encode_block(const int32_t *values, uint32_t count, uint8_t *out);
+
+/**
+ * @brief Decodes one block.
+ * @param values room for ACS_PACK_BLOCK values, even for a shorter block
+ * @param count number of values in the block
+ * @return bytes consumed, 0 if the block is malformed or longer than size
+ */
+size_t acs_pack_decode_block(const uint8_t *in, size_t size, int32_t *values, uint32_t *count);
+
+/**
+ * @brief Initializes a stream over caller provided storage.
+ * @return ACS_OK or ACS_ERR_PARAM
+ */
+int acs_pack_stream_init(acs_pack_stream_t *stream, uint8_t *out, size_t capacity,
+                         uint32_t *index, uint32_t index_capacity);
+
+/**
+ * @brief Adds values to the stream, encoding every block that fills up.
+ * @return ACS_OK, or ACS_ERR_FULL if out or index ran out of room, in which
+ * case the values that did not fit are dropped
+ */
+int acs_pack_stream_push(acs_pack_stream_t *stream, const int32_t *values, uint32_t count);
+
+/**
+ * @brief Adds the vcodes and icodes of captured samples to two streams.
+ * Samples go in ACS_PACK_BLOCK at a time; if either stream runs out of room,
+ * that group is dropped from both, so the streams always hold the same
+ * samples.
+ * @return ACS_OK or ACS_ERR_FULL
+ */
+int acs_pack_stream_push_samples(acs_pack_stream_t *vcodes, acs_pack_stream_t *icodes,
+                                 const acs_sample_t *samples, uint32_t count);
+
+/**
+ * @brief Encodes the remaining values as a final, shorter block.
+ * @return ACS_OK or ACS_ERR_FULL
+ */
+int acs_pack_stream_finish(acs_pack_stream_t *stream);
+
+/**
+ * @brief Decodes block number block of an encoded stream.
+ * @return number of values written, 0 on error
+ */
+uint32_t acs_pack_stream_block(const uint8_t *data, size_t size, const uint32_t *index,
+                               uint32_t blocks, uint32_t block, int32_t *values);
+
+#endif // _ACS71020_pack_H_
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include <math.h>
+#include "ACS71020_phase.h"
+#include "ACS71020_config.h"
+
+#define RAD_TO_DEG 57.2957795130823208768
+
+static int32_t channel_mean(const acs_sample_t *samples, size_t count, bool voltage)
+{
+    int64_t sum = 0;
+
+    for (size_t n = 0; n < count; n++)
+        sum += voltage ? samples[n].vcodes : samples[n].icodes;
+    return (int32_t)(sum / (int64_t)count);
+}
+
+/**
+ * @brief Circular correlation, mean of (v[n] - vm) * (i[n + k] - im) with
+ * n + k wrapped around the block. Over a whole number of line cycles every
+ * lag sees the same signal, so there is no bias from the ends of the
+ * capture. The sum stays exact in 64 bits for any capture that fits in
+ * memory.
+ */
+static double correlate(const acs_sample_t *samples, size_t count, int32_t vm, int32_t im, int32_t k)
+{
+    size_t shift = k < 0 ? count - (size_t)-k : (size_t)k;
+    int64_t sum = 0;
+
+    for (size_t n = 0; n < count; n++)
+    {
+        size_t m = n + shift;
+        if (m >= count)
+            m -= count;
+        sum += (int64_t)(samples[n].vcodes - vm) * (samples[m].icodes - im);
+    }
+    return (double)sum / (double)count;
+}
+
+int acs_phase_lag(const acs_sample_t *samples, size_t count, uint32_t max_lag, float *lag)
+{
+    if (samples == NULL || lag == NULL || max_lag == 0U || count < 4U * (size_t)max_lag)
+        return ACS_ERR_PARAM;
+
+    int32_t vm = channel_mean(samples, count, true);
+    int32_t im = channel_mean(samples, count, false);
+    int32_t span = (int32_t)max_lag;
+    int32_t best = -span;
+    double r_best = correlate(samples, count, vm, im, -span);
+
+    for (int32_t k = -span + 1; k <= span; k++)
+    {
+        double r = correlate(samples, count, vm, im, k);
+        if (r > r_best)
+        {
+            r_best = r;
+            best   = k;
+        }
+    }
+
+    *lag = (float)best;
+    if (best == -span || best == span)
+        return ACS_ERR_RANGE;
+
+    // Near its peak the correlation of a line-frequency signal is a cosine
+    // many samples wide, a parabola through three points locates it well
+    double r_prev = correlate(samples, count, vm, im, best - 1);
+    double r_next = correlate(samples, count, vm, im, best + 1);
+    double curve  = r_prev - 2.0 * r_best + r_next;
+    if (curve < 0.0)
+        *lag += (float)(0.5 * (r_prev - r_next) / curve);
+
+    return ACS_OK;
+}
+
+int acs_phase_solve(const acs_sample_t *samples, size_t count, float sample_rate,
+                    uint32_t reg_0x0D, uint32_t reg_0x0E, acs_phase_result_t *result)
+{
+    double adc_rate = acs_adc_rate_hz(reg_0x0E);
+
+    if (result == NULL || !(sample_rate > 0.0f) || sample_rate > adc_rate)
+        return ACS_ERR_PARAM;
+
+    // Search twice the correctable range so that a lag just beyond it is
+    // still found and reported as out of range rather than misread
+    double step_us = acs_chan_del_step_ns(reg_0x0E) * 1e-3;
+    uint32_t max_lag = (uint32_t)ceil(2.0 * (ACS_PHASE_DELAY_MAX + 1U) * step_us * 1e-6 * sample_rate) + 1U;
+
+    float lag;
+    int ret = acs_phase_lag(samples, count, max_lag, &lag);
+    if (ret != ACS_OK && ret != ACS_ERR_RANGE)
+        return ret;
+
+    double in_effect = eeprom_0x0D_chan_del_sel_get(reg_0x0D) * step_us;
+    double lag_us = lag * 1e6 / sample_rate;
+
+    // A delayed voltage channel hides current lag, a delayed current adds to it
+    double sensor_us = eeprom_0x0D_ichan_del_en_get(reg_0x0D) ? lag_us - in_effect
+                                                               : lag_us + in_effect;
+
+    long steps = lround(fabs(sensor_us) / step_us);
+    if (steps > (long)ACS_PHASE_DELAY_MAX)
+    {
+        steps = ACS_PHASE_DELAY_MAX;
+        ret   = ACS_ERR_RANGE;
+    }
+
+    result->lag_us        = (float)lag_us;
+    result->sensor_lag_us = (float)sensor_us;
+    result->chan_del_sel  = (uint8_t)steps;
+    result->ichan_del_en  = (steps != 0 && sensor_us < 0.0) ? 1U : 0U;
+    result->residual_us   = (float)(result->ichan_del_en ? sensor_us + steps * step_us
+                                                         : sensor_us - steps * step_us);
+    return ret;
+}
+
+int acs_phase_apply(const acs_phase_result_t *result, acs_shadow_t *shadow)
+{
+    acs_config_t config;
+
+    acs_config_init(&config);
+    acs_config_set_chan_del_sel(&config, result->chan_del_sel);
+    acs_config_set_ichan_del_en(&config, result->ichan_del_en);
+    return acs_config_apply(&config, shadow, NULL);
+}
+
+int acs_phase_verify(const acs_device_t *dev, const acs_phase_result_t *result,
+                     float line_hz, uint32_t reads, acs_phase_check_t *check)
+{
+    if (dev == NULL || result == NULL || check == NULL || reads == 0U)
+        return ACS_ERR_PARAM;
+
+    double sum = 0.0;
+    check->posangle = 0U;
+    check->reads    = reads;
+
+    for (uint32_t n = 0; n < reads; n++)
+    {
+        uint32_t pf, status;
+        int ret = acs_read_register(dev, 0x24, &pf);
+        if (ret == ACS_OK)
+            ret = acs_read_register(dev, 0x2D, &status);
+        if (ret != ACS_OK)
+            return ret;
+
+        sum += acs_0x24_pfactor_sget(pf) / 512.0;
+        check->posangle += acs_0x2D_posangle_get(status);
+    }
+
+    double pf = sum / reads;
+    if (pf > 1.0)
+        pf = 1.0;
+    if (pf < -1.0)
+        pf = -1.0;
+
+    check->pfactor      = (float)pf;
+    check->angle_deg    = (float)(acos(pf) * RAD_TO_DEG);
+    check->expected_deg = (float)(360.0 * line_hz * fabs(result->residual_us) * 1e-6);
+
+    // One pfactor LSB below unity
+    double tolerance = acos(1.0 - 1.0 / 512.0) * RAD_TO_DEG;
+    return check->angle_deg <= check->expected_deg + tolerance ? ACS_OK : ACS_ERR_RANGE;
+}
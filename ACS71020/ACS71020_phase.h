@@ -0,0 +1,91 @@
+/**
+ * @file ACS71020_phase.h
+ * @author Usman Mehmood (usmanmehmood55@gmail.com)
+ * @brief Phase-delay tuning. With a resistive reference load, any lag of
+ * icodes behind vcodes is the sensor's own, so a capture of 0x2A / 0x2B is
+ * cross-correlated over the small range of lags chan_del_sel can correct,
+ * the peak is interpolated to a fraction of a sample, and the delay setting
+ * that cancels it follows directly. chan_del_sel delays one channel in 7
+ * steps of 31.25 us at 32 kHz, up to 218.75 us, or of 125 us at 4 kHz, up to
+ * 875 us, see acs_chan_del_step_ns(); ichan_del_en selects the current
+ * channel instead of the voltage one. The new setting is written through the shadow cache and
+ * checked against pfactor, with posangle giving the sign of what is left.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _ACS71020_phase_H_
+#define _ACS71020_phase_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "ACS71020.h"
+#include "ACS71020_capture.h"
+#include "ACS71020_shadow.h"
+
+#define ACS_PHASE_DELAY_MAX 7U      // Largest chan_del_sel, in delay steps
+
+typedef struct
+{
+    float   lag_us;         // Lag of current behind voltage in the capture, negative when leading
+    float   sensor_lag_us;  // The same with the delay in effect taken out
+    float   residual_us;    // Lag left after the new delay
+    uint8_t chan_del_sel;
+    uint8_t ichan_del_en;
+} acs_phase_result_t;
+
+typedef struct
+{
+    float    pfactor;       // Mean of the pfactor readings
+    float    angle_deg;     // acos(pfactor)
+    float    expected_deg;  // Angle the residual lag accounts for
+    uint32_t posangle;      // Readings with posangle set
+    uint32_t reads;
+} acs_phase_check_t;
+
+/**
+ * @brief Lag of icodes behind vcodes, by cross-correlating the two channels
+ * with their means removed, circularly, over lags -max_lag to max_lag and
+ * fitting a parabola through the peak. samples must be evenly spaced and
+ * should span a whole number of line cycles, see acs_harmonic_block_len().
+ * @param lag in samples, positive when the current lags, the end of the
+ * range when the peak lies there
+ * @return ACS_OK, ACS_ERR_PARAM, or ACS_ERR_RANGE if the peak lies at the end
+ * of the searched range
+ */
+int acs_phase_lag(const acs_sample_t *samples, size_t count, uint32_t max_lag, float *lag);
+
+/**
+ * @brief Measures the lag of a capture taken with a resistive load and picks
+ * the delay that cancels it.
+ * @param sample_rate rate of the capture, at most the ADC rate
+ * @param reg_0x0D the 0x0D word in effect during the capture
+ * @param reg_0x0E the 0x0E word in effect, for the ADC rate
+ * @return ACS_OK, ACS_ERR_PARAM, or ACS_ERR_RANGE if the lag is beyond what
+ * chan_del_sel corrects, in which case result holds the largest delay
+ */
+int acs_phase_solve(const acs_sample_t *samples, size_t count, float sample_rate,
+                    uint32_t reg_0x0D, uint32_t reg_0x0E, acs_phase_result_t *result);
+
+/**
+ * @brief Writes chan_del_sel and ichan_del_en, only if they changed.
+ * @return as acs_config_apply()
+ */
+int acs_phase_apply(const acs_phase_result_t *result, acs_shadow_t *shadow);
+
+/**
+ * @brief Reads pfactor (0x24) and posangle (0x2D) reads times, still under the
+ * resistive load, and compares the angle with what the residual lag of
+ * result accounts for at line_hz. pfactor resolves about 3.6 degrees near
+ * unity, which is the tolerance.
+ * @return ACS_OK, ACS_ERR_RANGE if the angle is larger than expected, or a
+ * transport error
+ */
+int acs_phase_verify(const acs_device_t *dev, const acs_phase_result_t *result,
+                     float line_hz, uint32_t reads, acs_phase_check_t *check);
+
+#endif // _ACS71020_phase_H_
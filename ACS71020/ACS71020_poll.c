@@ -0,0 +1,222 @@
+#include <math.h>
+#include <string.h>
+#include "ACS71020_poll.h"
+
+// 0x20 to 0x29 are refreshed at the end of a window, 0x2A to 0x2D change on
+// every sample and say nothing about windows
+#define CYCLE_WORDS (0x29U - ACS_REG_MEAS_FIRST + 1U)
+
+static uint32_t acquire_budget(const acs_poll_t *poll)
+{
+    return (uint32_t)(2.0 * poll->window_us / poll->guard_us) + 2U;
+}
+
+static void start_acquire(acs_poll_t *poll, uint64_t now_us)
+{
+    poll->state        = ACS_POLL_ACQUIRE;
+    poll->retries_left = acquire_budget(poll);
+    poll->next_us      = now_us + poll->guard_us;
+    poll->stepping     = true;
+    poll->acquisitions++;
+}
+
+void acs_poll_init(acs_poll_t *poll, const acs_device_t *dev, uint32_t reg_0x0E,
+                   float nominal_hz, uint32_t guard_us, uint32_t read_us,
+                   acs_poll_callback_t callback, void *user)
+{
+    if (guard_us < read_us)
+        guard_us = read_us;
+
+    memset(poll, 0, sizeof(*poll));
+    poll->dev         = dev;
+    poll->callback    = callback;
+    poll->user        = user;
+    poll->adc_rate_hz = acs_adc_rate_hz(reg_0x0E);
+    poll->guard_us    = guard_us > 0U ? guard_us : 1U;
+    poll->window_us   = 1e6 / (nominal_hz > 0.0f ? nominal_hz : 50.0f);
+    poll->saturated   = true;
+
+    start_acquire(poll, 0U);
+    poll->next_us = 0U;
+}
+
+/**
+ * @brief A window ended at edge_us, give or take half a guard_us. Without
+ * numptsout the period is the spacing of such ends over the whole windows
+ * between them, which averages the location error away.
+ */
+static void located_edge(acs_poll_t *poll, uint64_t edge_us)
+{
+    if (poll->saturated && poll->has_edge)
+    {
+        double span = (double)(edge_us - poll->edge_us);
+        double windows = floor(span / poll->window_us + 0.5);
+        if (windows >= 1.0)
+            poll->window_us += (span / windows - poll->window_us) / 2.0;
+    }
+
+    poll->edge_us     = edge_us;
+    poll->has_edge    = true;
+    poll->anchor_us   = edge_us;
+    poll->state       = ACS_POLL_TRACK;
+    poll->until_probe = ACS_POLL_PROBE_EVERY;
+}
+
+/**
+ * @brief Plans the read for the window after anchor_us. Every
+ * ACS_POLL_PROBE_EVERY windows the read is a probe placed guard_us before
+ * the expected end instead of after it, which should return unchanged data
+ * and so locate the end on the retry.
+ */
+static void schedule(acs_poll_t *poll, uint64_t now_us)
+{
+    uint64_t window = (uint64_t)llround(poll->window_us);
+
+    poll->probing = --poll->until_probe == 0U;
+    if (poll->probing)
+    {
+        poll->until_probe = ACS_POLL_PROBE_EVERY;
+        poll->probes++;
+        poll->next_us = poll->anchor_us + window - poll->guard_us;
+    }
+    else
+    {
+        poll->next_us = poll->anchor_us + window + poll->guard_us;
+    }
+    poll->stepping = false;
+
+    // Windows that went by while the caller was late
+    while (poll->next_us <= now_us)
+    {
+        poll->anchor_us += window;
+        poll->next_us   += window;
+    }
+    poll->retries_left = ACS_POLL_RETRIES;
+}
+
+static void on_stale(acs_poll_t *poll, uint64_t now_us)
+{
+    poll->stale++;
+    if (poll->retries_left > 0U)
+    {
+        poll->retries_left--;
+        poll->next_us  = now_us + poll->guard_us;
+        poll->stepping = true;
+        return;
+    }
+
+    // Nothing changed for longer than expected, the load is steady enough
+    // for windows to repeat exactly. Carry on from the prediction.
+    if (poll->state == ACS_POLL_ACQUIRE)
+    {
+        poll->state       = ACS_POLL_TRACK;
+        poll->anchor_us   = now_us;
+        poll->until_probe = ACS_POLL_PROBE_EVERY;
+    }
+    else
+    {
+        poll->anchor_us += (uint64_t)llround(poll->window_us);
+    }
+
+    // A probe that only saw repeats located nothing. Probe the next window
+    // rather than the one ACS_POLL_PROBE_EVERY on, where repeats that recur
+    // at a divisor of it would be met again.
+    if (poll->probing)
+        poll->until_probe = 1U;
+    schedule(poll, now_us);
+}
+
+int acs_poll_run(acs_poll_t *poll, uint64_t now_us)
+{
+    acs_snapshot_t snap;
+
+    if (now_us < poll->next_us)
+        return 0;
+
+    int ret = acs_read_snapshot(poll->dev, &snap);
+    if (ret != ACS_OK)
+    {
+        poll->bus_errors++;
+        poll->next_us = now_us + poll->guard_us;
+        return ret;
+    }
+    poll->reads++;
+
+    bool fresh = !poll->has_last ||
+                 memcmp(snap.words, poll->last.words, CYCLE_WORDS * sizeof(uint32_t)) != 0;
+    uint64_t prev_read  = poll->last_read_us;
+    bool     bracketed  = poll->last_stale && poll->stepping;
+    poll->last_read_us  = now_us;
+    poll->last_stale    = !fresh;
+
+    if (!fresh)
+    {
+        on_stale(poll, now_us);
+        return 0;
+    }
+    poll->fresh++;
+
+    // A window is a whole number of samples, so when the period is not, the
+    // count alternates between neighbours and only its average is the period
+    uint32_t points = acs_0x25_numptsout_get(snap.regs.reg_0x25.register_value);
+    bool was_saturated = poll->saturated;
+    poll->saturated = points == 0U || points >= ACS_POLL_NUMPTS_MAX;
+    if (!poll->saturated)
+    {
+        double window = points * 1e6 / poll->adc_rate_hz;
+        poll->window_us = was_saturated ? window : poll->window_us + (window - poll->window_us) / 8.0;
+    }
+
+    bool had_last = poll->has_last;
+    poll->last     = snap;
+    poll->has_last = true;
+
+    if (had_last && bracketed)
+    {
+        // The window ended between the previous read, which was unchanged,
+        // and this one, guard_us later
+        located_edge(poll, prev_read + (now_us - prev_read) / 2U);
+        schedule(poll, now_us);
+    }
+    else if (poll->state == ACS_POLL_ACQUIRE)
+    {
+        if (poll->retries_left > 0U)
+        {
+            poll->retries_left--;
+            poll->next_us = now_us + poll->guard_us;
+        }
+        else
+        {
+            poll->state       = ACS_POLL_TRACK;
+            poll->anchor_us   = now_us;
+            poll->until_probe = ACS_POLL_PROBE_EVERY;
+            schedule(poll, now_us);
+        }
+    }
+    else if (poll->probing)
+    {
+        // The window ended before the probe, earlier than expected. Assume
+        // it ended just before and probe again on the next window, each
+        // probe that still finds new data moves the estimate further back.
+        poll->anchor_us   = now_us - poll->guard_us;
+        poll->until_probe = 1U;
+        schedule(poll, now_us);
+    }
+    else
+    {
+        // The end lies between the previous read and this one, keep the
+        // prediction unless it falls outside
+        uint64_t predicted = poll->anchor_us + (uint64_t)llround(poll->window_us);
+        if (predicted < prev_read)
+            predicted = prev_read;
+        if (predicted > now_us)
+            predicted = now_us;
+        poll->anchor_us = predicted;
+        schedule(poll, now_us);
+    }
+
+    if (poll->callback != NULL)
+        poll->callback(poll->user, &snap);
+
+    return 1;
+}
@@ -0,0 +1,128 @@
+/**
+ * @file ACS71020_poll.h
+ * @author Usman Mehmood (usmanmehmood55@gmail.com)
+ * @brief Adaptive polling without DIO0. The rms and power registers change
+ * once per line cycle, and numptsout (0x25) says how many ADC samples the
+ * last cycle had, so numptsout over the ADC rate is the line period. The
+ * poller keeps an estimate of when the current window ends and reads the
+ * snapshot just after it, so every read returns new data and nothing is
+ * read in between.
+ * At 32 kHz a 50 or 60 Hz cycle has more points than numptsout's 9 bits can
+ * hold, it then reads 511 and the period is instead measured between window
+ * ends located by the poller itself. A window end is located by reading
+ * every guard_us from just before it until the data changes, which is done
+ * once at start and then every ACS_POLL_PROBE_EVERY windows to follow drift in
+ * frequency and phase. If a window ends with exactly the same data as the
+ * one before, which a steady load can produce, ACS_POLL_RETRIES more reads
+ * are spent before the poller moves on to the next window, and a probe
+ * that met such a repeat is made again on it.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _ACS71020_poll_H_
+#define _ACS71020_poll_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "ACS71020.h"
+
+#define ACS_POLL_NUMPTS_MAX 511U    // numptsout saturates here
+
+#ifndef ACS_POLL_PROBE_EVERY
+#define ACS_POLL_PROBE_EVERY 16U
+#endif
+
+// Reads, guard_us apart, after an expected window end returned unchanged
+// data before the window is taken to have repeated exactly
+#ifndef ACS_POLL_RETRIES
+#define ACS_POLL_RETRIES 3U
+#endif
+
+/**
+ * @brief Called with every snapshot that differs from the previous one.
+ */
+typedef void (*acs_poll_callback_t)(void *user, const acs_snapshot_t *snap);
+
+typedef enum
+{
+    ACS_POLL_ACQUIRE,   // Reading every guard_us to find a window end
+    ACS_POLL_TRACK,     // Reading once per window, just after its end
+} acs_poll_state_t;
+
+typedef struct
+{
+    const acs_device_t *dev;
+    acs_poll_callback_t callback;
+    void               *user;
+
+    uint32_t            adc_rate_hz;
+    uint32_t            guard_us;       // Margin after a window end, and retry step
+    acs_poll_state_t    state;
+
+    double              window_us;      // Estimated line period
+    bool                saturated;      // numptsout could not give the period
+    uint64_t            anchor_us;      // Estimated end of the last window
+    uint64_t            edge_us;        // Last window end located to within guard_us
+    bool                has_edge;
+    uint64_t            next_us;        // Time of the next read
+    uint64_t            last_read_us;
+    bool                last_stale;     // Previous read returned unchanged data
+    bool                stepping;       // Next read is guard_us after the previous one
+    bool                probing;        // Current read is an early probe
+    uint32_t            retries_left;
+    uint32_t            until_probe;
+
+    acs_snapshot_t      last;
+    bool                has_last;
+
+    uint32_t            reads;
+    uint32_t            fresh;
+    uint32_t            stale;          // Reads that returned unchanged data
+    uint32_t            probes;
+    uint32_t            acquisitions;
+    uint32_t            bus_errors;
+} acs_poll_t;
+
+/**
+ * @brief Starts in acquisition, the first read is due at once.
+ * @param reg_0x0E the device's 0x0E word, for the ADC rate
+ * @param nominal_hz line frequency to assume until the device tells. When
+ * numptsout saturates it must be within a few percent, the measured spacing
+ * of window ends is only resolved to whole windows around it.
+ * @param guard_us margin after a window end and step between reads while
+ * locating one, to cover the caller's timing jitter
+ * @param read_us bus time of one snapshot read, about 1.4 ms on I2C at
+ * 400 kHz. guard_us is raised to it: the registers are only sampled
+ * somewhere within a read, so a window end cannot be located any finer, and
+ * a shorter guard biases the period measured from window ends.
+ */
+void acs_poll_init(acs_poll_t *poll, const acs_device_t *dev, uint32_t reg_0x0E,
+                   float nominal_hz, uint32_t guard_us, uint32_t read_us,
+                   acs_poll_callback_t callback, void *user);
+
+/**
+ * @brief Reads the snapshot if a read is due at now_us, otherwise returns
+ * without touching the bus. now_us must not go backwards.
+ * @return 1 if new data was delivered, 0 if nothing new, or a transport error
+ */
+int acs_poll_run(acs_poll_t *poll, uint64_t now_us);
+
+static inline uint64_t acs_poll_next_due(const acs_poll_t *poll)
+{
+    return poll->next_us;
+}
+
+/**
+ * @brief Line frequency estimate in Hz.
+ */
+static inline float acs_poll_line_hz(const acs_poll_t *poll)
+{
+    return (float)(1e6 / poll->window_us);
+}
+
+#endif // _ACS71020_poll_H_
@@ -0,0 +1,88 @@
+#include <string.h>
+#include "ACS71020_publish.h"
+
+void acs_publish_init(acs_publish_t *pub)
+{
+    atomic_init(&pub->seq, 0U);
+    for (uint32_t i = 0; i < ACS_PUBLISH_WORDS; i++)
+        atomic_init(&pub->words[i], 0U);
+}
+
+void acs_publish(acs_publish_t *pub, const acs_snapshot_t *snap, uint64_t timestamp_us)
+{
+    uint32_t seq = atomic_load_explicit(&pub->seq, memory_order_relaxed);
+
+    // 0 stays reserved for nothing published, the counter wraps to 2
+    uint32_t next = seq + 2U;
+    if (next == 0U)
+        next = 2U;
+
+    // Odd while writing. The fence keeps the payload stores from moving
+    // ahead of the counter.
+    atomic_store_explicit(&pub->seq, seq + 1U, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    for (uint32_t i = 0; i < ACS_SNAPSHOT_WORDS; i++)
+        atomic_store_explicit(&pub->words[i], snap->words[i], memory_order_relaxed);
+    atomic_store_explicit(&pub->words[ACS_SNAPSHOT_WORDS], (uint32_t)timestamp_us,
+                          memory_order_relaxed);
+    atomic_store_explicit(&pub->words[ACS_SNAPSHOT_WORDS + 1U], (uint32_t)(timestamp_us >> 32),
+                          memory_order_relaxed);
+
+    atomic_store_explicit(&pub->seq, next, memory_order_release);
+}
+
+/**
+ * @brief One attempt at a consistent copy.
+ * @return the even sequence number the copy belongs to, or an odd number if
+ * it overlapped a publish and has to be repeated
+ */
+static uint32_t try_copy(acs_publish_t *pub, uint32_t *words)
+{
+    uint32_t before = atomic_load_explicit(&pub->seq, memory_order_acquire);
+    if (before & 1U)
+        return before;
+
+    for (uint32_t i = 0; i < ACS_PUBLISH_WORDS; i++)
+        words[i] = atomic_load_explicit(&pub->words[i], memory_order_relaxed);
+
+    // The fence keeps the payload loads from moving past the second check
+    atomic_thread_fence(memory_order_acquire);
+    uint32_t after = atomic_load_explicit(&pub->seq, memory_order_relaxed);
+
+    return after == before ? before : (before | 1U);
+}
+
+int acs_publish_read(const acs_publish_t *pub, acs_snapshot_t *snap,
+                     uint64_t *timestamp_us, uint32_t *generation)
+{
+    acs_publish_t *p = (acs_publish_t *)pub;
+    uint32_t words[ACS_PUBLISH_WORDS];
+    uint32_t seq;
+
+    do
+    {
+        seq = try_copy(p, words);
+    } while (seq & 1U);
+
+    if (seq == 0U)
+        return ACS_ERR_EMPTY;
+
+    memcpy(snap->words, words, sizeof(snap->words));
+    if (timestamp_us != NULL)
+        *timestamp_us = (uint64_t)words[ACS_SNAPSHOT_WORDS] |
+                        ((uint64_t)words[ACS_SNAPSHOT_WORDS + 1U] << 32);
+    if (generation != NULL)
+        *generation = seq / 2U;
+
+    return ACS_OK;
+}
+
+int acs_publish_read_newer(const acs_publish_t *pub, uint32_t *generation,
+                           acs_snapshot_t *snap, uint64_t *timestamp_us)
+{
+    if (acs_publish_generation(pub) == *generation)
+        return ACS_ERR_EMPTY;
+
+    return acs_publish_read(pub, snap, timestamp_us, generation);
+}
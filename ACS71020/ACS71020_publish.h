@@ -0,0 +1,75 @@
+/**
+ * @file ACS71020_publish.h
+ * @author Usman Mehmood (usmanmehmood55@gmail.com)
+ * @brief Snapshot publication from one acquisition thread to any number of
+ * readers, as a seqlock. The writer bumps a sequence counter to odd, stores
+ * the snapshot, and bumps it back to even; a reader copies the snapshot
+ * between two loads of the counter and starts over if they differ or were
+ * odd. The writer never waits for readers and readers never take a lock,
+ * a reader only repeats its copy if it overlapped a publish, which takes a
+ * few dozen stores. The even counter divided by two is the generation, it
+ * tells a reader whether anything new arrived without copying. Generation 0
+ * means nothing was published yet, after 2^31 - 1 publishes the generation
+ * wraps to 1.
+ * The payload is kept as relaxed atomic words so that the racing copy is
+ * well defined C11, on common targets these compile to plain loads and
+ * stores.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _ACS71020_publish_H_
+#define _ACS71020_publish_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "ACS71020.h"
+
+// Snapshot words followed by the timestamp, low word first
+#define ACS_PUBLISH_WORDS (ACS_SNAPSHOT_WORDS + 2U)
+
+typedef struct
+{
+    _Atomic uint32_t seq;
+    _Atomic uint32_t words[ACS_PUBLISH_WORDS];
+} acs_publish_t;
+
+void acs_publish_init(acs_publish_t *pub);
+
+/**
+ * @brief Writer side, one writer only. Never blocks.
+ */
+void acs_publish(acs_publish_t *pub, const acs_snapshot_t *snap, uint64_t timestamp_us);
+
+/**
+ * @brief Generation of the latest snapshot, 0 before the first publish.
+ * A single load, cheap enough to poll.
+ */
+static inline uint32_t acs_publish_generation(const acs_publish_t *pub)
+{
+    return atomic_load_explicit(&((acs_publish_t *)pub)->seq, memory_order_acquire) / 2U;
+}
+
+/**
+ * @brief Reader side, safe from any number of threads at once. Copies the
+ * latest snapshot as one consistent set.
+ * @param timestamp_us may be NULL
+ * @param generation may be NULL, receives the generation of the copy
+ * @return ACS_OK, or ACS_ERR_EMPTY if nothing was published yet
+ */
+int acs_publish_read(const acs_publish_t *pub, acs_snapshot_t *snap,
+                     uint64_t *timestamp_us, uint32_t *generation);
+
+/**
+ * @brief Copies the latest snapshot only if its generation differs from
+ * *generation, which is then updated.
+ * @return ACS_OK, or ACS_ERR_EMPTY if there is nothing newer
+ */
+int acs_publish_read_newer(const acs_publish_t *pub, uint32_t *generation,
+                           acs_snapshot_t *snap, uint64_t *timestamp_us);
+
+#endif // _ACS71020_publish_H_
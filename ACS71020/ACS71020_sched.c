@@ -0,0 +1,171 @@
+#include <string.h>
+#include "ACS71020_sched.h"
+
+int acs_sched_init(acs_sched_t *sched, const acs_transport_t *bus,
+                   acs_sched_slot_t *slots, uint8_t capacity,
+                   acs_sched_policy_t policy, uint8_t max_batch)
+{
+    if (sched == NULL || bus == NULL || slots == NULL || capacity == 0U ||
+        max_batch == 0U || max_batch > ACS_SCHED_MAX_BATCH)
+        return ACS_ERR_PARAM;
+
+    memset(sched, 0, sizeof(*sched));
+    sched->bus       = bus;
+    sched->slots     = slots;
+    sched->capacity  = capacity;
+    sched->policy    = policy;
+    sched->max_batch = max_batch;
+    return ACS_OK;
+}
+
+void acs_sched_set_callback(acs_sched_t *sched, acs_sched_callback_t callback,
+                            void *user)
+{
+    sched->callback = callback;
+    sched->user     = user;
+}
+
+int acs_sched_add(acs_sched_t *sched, const acs_device_t *dev,
+                  uint32_t period_us, uint8_t priority)
+{
+    if (dev == NULL || dev->transport != sched->bus || period_us == 0U)
+        return ACS_ERR_PARAM;
+    if (sched->count >= sched->capacity)
+        return ACS_ERR_FULL;
+
+    acs_sched_slot_t *slot = &sched->slots[sched->count];
+    memset(slot, 0, sizeof(*slot));
+    slot->dev       = dev;
+    slot->period_us = period_us;
+    slot->priority  = priority;
+
+    return sched->count++;
+}
+
+/**
+ * @brief Whether slot a should be served before slot b under the priority
+ * policy.
+ */
+static int before(const acs_sched_slot_t *a, const acs_sched_slot_t *b)
+{
+    if (a->priority != b->priority)
+        return a->priority > b->priority;
+    return a->next_due_us < b->next_due_us;
+}
+
+static uint8_t collect_due(acs_sched_t *sched, uint64_t now_us, uint8_t *picked)
+{
+    uint8_t n = 0;
+
+    for (uint8_t k = 0; k < sched->count; k++)
+    {
+        uint8_t i = (uint8_t)((sched->rr_next + k) % sched->count);
+        if (sched->slots[i].next_due_us > now_us)
+            continue;
+
+        if (sched->policy == ACS_SCHED_ROUND_ROBIN)
+        {
+            if (n < sched->max_batch)
+                picked[n++] = i;
+            continue;
+        }
+
+        // Keep the best max_batch candidates with an insertion sort
+        uint8_t pos = n < sched->max_batch ? n++ : sched->max_batch;
+        while (pos > 0U && before(&sched->slots[i], &sched->slots[picked[pos - 1U]]))
+        {
+            if (pos < sched->max_batch)
+                picked[pos] = picked[pos - 1U];
+            pos--;
+        }
+        if (pos < sched->max_batch)
+            picked[pos] = i;
+    }
+
+    return n;
+}
+
+int acs_sched_run(acs_sched_t *sched, uint64_t now_us)
+{
+    uint8_t picked[ACS_SCHED_MAX_BATCH];
+    acs_xfer_t xfers[ACS_SCHED_MAX_BATCH];
+    acs_snapshot_t snaps[ACS_SCHED_MAX_BATCH];
+
+    if (sched->count == 0U)
+        return 0;
+
+    uint8_t n = collect_due(sched, now_us, picked);
+    if (n == 0U)
+        return 0;
+
+    for (uint8_t k = 0; k < n; k++)
+    {
+        xfers[k].dev_addr = sched->slots[picked[k]].dev->address;
+        xfers[k].reg_addr = ACS_REG_MEAS_FIRST;
+        xfers[k].count    = (uint8_t)ACS_SNAPSHOT_WORDS;
+        xfers[k].status   = ACS_OK;
+        xfers[k].words    = snaps[k].words;
+    }
+
+    int ret = acs_transport_read_multi(sched->bus, xfers, n);
+    if (ret != ACS_OK)
+        return ret;
+    sched->batches++;
+
+    for (uint8_t k = 0; k < n; k++)
+    {
+        acs_sched_slot_t *slot = &sched->slots[picked[k]];
+
+        if (xfers[k].status == ACS_OK)
+        {
+            slot->snap = snaps[k];
+            if (slot->reads++ == 0U)
+                slot->first_us = now_us;
+            slot->last_us = now_us;
+        }
+        else
+        {
+            slot->errors++;
+        }
+
+        if (slot->next_due_us != 0U && now_us >= slot->next_due_us + slot->period_us)
+            slot->late++;
+
+        // Stay on the original grid unless too far behind to catch up
+        slot->next_due_us += slot->period_us;
+        if (slot->next_due_us <= now_us)
+            slot->next_due_us = now_us + slot->period_us;
+
+        if (sched->callback != NULL)
+            sched->callback(sched->user, picked[k], &slot->snap, xfers[k].status);
+    }
+
+    // Next round starts after the last device served, so nobody starves
+    sched->rr_next = (uint8_t)((picked[n - 1U] + 1U) % sched->count);
+    return n;
+}
+
+uint64_t acs_sched_next_due(const acs_sched_t *sched)
+{
+    uint64_t next = UINT64_MAX;
+
+    for (uint8_t i = 0; i < sched->count; i++)
+    {
+        if (sched->slots[i].next_due_us < next)
+            next = sched->slots[i].next_due_us;
+    }
+    return next;
+}
+
+void acs_sched_stats(const acs_sched_t *sched, uint8_t slot, acs_sched_stats_t *stats)
+{
+    const acs_sched_slot_t *s = &sched->slots[slot];
+
+    stats->reads   = s->reads;
+    stats->errors  = s->errors;
+    stats->late    = s->late;
+    stats->rate_hz = 0.0f;
+
+    if (s->reads > 1U && s->last_us > s->first_us)
+        stats->rate_hz = (float)(s->reads - 1U) * 1e6f / (float)(s->last_us - s->first_us);
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+/**
+ * @file ACS71020_sched.h
+ * @author Usman Mehmood (usmanmehmood55@gmail.com)
+ * @brief Snapshot scheduler for several ACS71020s sharing one bus, up to 15
+ * on I2C (i2c_slv_addr 96 to 110). Each device has its own poll period and
+ * priority. On every call the due devices are collected and read as one
+ * acs_transport_read_multi() batch, so a transport that supports batching
+ * can run the address phases back to back without returning in between.
+ * Time is passed in by the caller, the scheduler has no clock of its own.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _ACS71020_sched_H_
+#define _ACS71020_sched_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include "ACS71020.h"
+
+#define ACS_SCHED_MAX_BATCH 16U
+
+typedef enum
+{
+    ACS_SCHED_ROUND_ROBIN,  // Due devices in rotating order
+    ACS_SCHED_PRIORITY,     // Due devices by priority, then by lateness
+} acs_sched_policy_t;
+
+/**
+ * @brief Called for every completed read, successful or not.
+ */
+typedef void (*acs_sched_callback_t)(void *user, uint8_t slot,
+                                     const acs_snapshot_t *snap, int status);
+
+typedef struct
+{
+    const acs_device_t *dev;
+    uint32_t            period_us;
+    uint8_t             priority;   // Higher is served first
+    uint64_t            next_due_us;
+
+    acs_snapshot_t      snap;       // Last successful snapshot
+
+    uint32_t            reads;
+    uint32_t            errors;
+    uint32_t            late;       // Reads served a full period or more late
+    uint64_t            first_us;
+    uint64_t            last_us;
+} acs_sched_slot_t;
+
+typedef struct
+{
+    const acs_transport_t *bus;
+    acs_sched_slot_t      *slots;
+    uint8_t                capacity;
+    uint8_t                count;
+    uint8_t                max_batch;   // Reads per batch, at most ACS_SCHED_MAX_BATCH
+    uint8_t                rr_next;
+    acs_sched_policy_t     policy;
+
+    acs_sched_callback_t   callback;
+    void                  *user;
+
+    uint32_t               batches;
+} acs_sched_t;
+
+/**
+ * @brief Achieved throughput of one slot.
+ */
+typedef struct
+{
+    uint32_t reads;
+    uint32_t errors;
+    uint32_t late;
+    float    rate_hz;   // Measured between the first and last read
+} acs_sched_stats_t;
+
+/**
+ * @brief All devices added later must use bus as their transport.
+ * @return ACS_OK or ACS_ERR_PARAM
+ */
+int acs_sched_init(acs_sched_t *sched, const acs_transport_t *bus,
+                   acs_sched_slot_t *slots, uint8_t capacity,
+                   acs_sched_policy_t policy, uint8_t max_batch);
+
+void acs_sched_set_callback(acs_sched_t *sched, acs_sched_callback_t callback,
+                            void *user);
+
+/**
+ * @brief Adds a device, due immediately.
+ * @return slot index, ACS_ERR_FULL or ACS_ERR_PARAM
+ */
+int acs_sched_add(acs_sched_t *sched, const acs_device_t *dev,
+                  uint32_t period_us, uint8_t priority);
+
+/**
+ * @brief Reads every device that is due at now_us, up to max_batch of them,
+ * in one batch.
+ * @return number of devices read, or a negative acs_err_t if the batch could
+ * not be issued at all
+ */
+int acs_sched_run(acs_sched_t *sched, uint64_t now_us);
+
+/**
+ * @brief Time of the earliest due device, for sleeping until then.
+ */
+uint64_t acs_sched_next_due(const acs_sched_t *sched);
+
+void acs_sched_stats(const acs_sched_t *sched, uint8_t slot, acs_sched_stats_t *stats);
+
+#endif // _ACS71020_sched_H_
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include <string.h>
+#include "ACS71020_shadow.h"
+#include "ACS71020_ecc.h"
+
+static bool is_eeprom(uint8_t address)
+{
+    return address >= ACS_REG_EEPROM_FIRST && address <= ACS_REG_EEPROM_LAST;
+}
+
+void acs_shadow_init(acs_shadow_t *shadow, const acs_device_t *dev)
+{
+    memset(shadow, 0, sizeof(*shadow));
+    shadow->dev = dev;
+}
+
+int acs_shadow_load(acs_shadow_t *shadow)
+{
+    const acs_transport_t *t = shadow->dev->transport;
+    uint32_t words[ACS_EEPROM_WORDS];
+
+    int ret = t->read(t->ctx, shadow->dev->address, ACS_REG_EEPROM_FIRST,
+                      words, (uint8_t)ACS_EEPROM_WORDS);
+    if (ret != ACS_OK)
+        return ret;
+
+    uint8_t status[ACS_EEPROM_WORDS];
+    size_t  bad = acs_ecc_reported_batch(words, ACS_EEPROM_WORDS, status);
+
+    // Keep only the data bits, so that the cache compares equal to what a
+    // flush would write
+    shadow->uncorrectable = 0U;
+    for (uint8_t i = 0; i < ACS_EEPROM_WORDS; i++)
+    {
+        shadow->cache.words[i] = acs_ecc_wire_frame(words[i] >> ACS_EEPROM_DATA_SHIFT);
+        if (status[i] == ACS_EEC_UNCORRECTABLE)
+            shadow->uncorrectable |= (uint8_t)(1U << i);
+    }
+
+    shadow->dirty  = 0U;
+    shadow->loaded = true;
+    return bad != 0U ? ACS_ERR_ECC : ACS_OK;
+}
+
+int acs_shadow_write(acs_shadow_t *shadow, uint8_t address, uint32_t word)
+{
+    // Without a load the rest of the word is unknown, writing it back would
+    // zero every other field, factory trims included
+    if (!shadow->loaded || !is_eeprom(address))
+        return ACS_ERR_PARAM;
+
+    uint8_t index = address - ACS_REG_EEPROM_FIRST;
+    if (shadow->cache.words[index] != word)
+    {
+        shadow->cache.words[index] = word;
+        shadow->dirty |= (uint8_t)(1U << index);
+    }
+    return ACS_OK;
+}
+
+uint32_t acs_shadow_read(const acs_shadow_t *shadow, uint8_t address)
+{
+    if (!is_eeprom(address))
+        return 0U;
+
+    return shadow->cache.words[address - ACS_REG_EEPROM_FIRST];
+}
+
+int acs_shadow_flush(acs_shadow_t *shadow)
+{
+    if (!shadow->loaded)
+        return ACS_ERR_PARAM;
+    if (shadow->dirty == 0U)
+        return ACS_OK;
+
+    int ret = acs_unlock(shadow->dev);
+    if (ret != ACS_OK)
+        return ret;
+
+    for (uint8_t i = 0; i < ACS_EEPROM_WORDS; i++)
+    {
+        if ((shadow->dirty & (1U << i)) == 0U)
+            continue;
+
+        uint32_t frame = acs_ecc_wire_frame(shadow->cache.words[i] >> ACS_EEPROM_DATA_SHIFT);
+        ret = acs_write_register(shadow->dev, ACS_REG_EEPROM_FIRST + i, frame);
+        if (ret != ACS_OK)
+            return ret;
+
+        shadow->dirty         &= (uint8_t)~(1U << i);
+        shadow->uncorrectable &= (uint8_t)~(1U << i);
+        shadow->words_written++;
+    }
+
+    shadow->flushes++;
+    return ACS_OK;
+}
\ No newline at end of file
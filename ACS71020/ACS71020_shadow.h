@@ -0,0 +1,107 @@
+/**
+ * @file ACS71020_shadow.h
+ * @author Usman Mehmood (usmanmehmood55@gmail.com)
+ * @brief Write-back cache of the EEPROM configuration registers 0x0B to 0x0F.
+ * Field setters only touch the host copy and mark the word dirty, a flush
+ * then unlocks the device once and writes only the words that changed.
+ * Every EEPROM word holds several fields, so the cache has to be loaded from
+ * the device before anything can be set or flushed.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _ACS71020_shadow_H_
+#define _ACS71020_shadow_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "ACS71020.h"
+
+typedef struct
+{
+    const acs_device_t *dev;
+
+    union
+    {
+        uint32_t words[ACS_EEPROM_WORDS];
+        struct
+        {
+            eeprom_0x0B_t reg_0x0B;
+            eeprom_0x0C_t reg_0x0C;
+            eeprom_0x0D_t reg_0x0D;
+            eeprom_0x0E_t reg_0x0E;
+            eeprom_0x0F_t reg_0x0F;
+        } regs;
+    } cache;
+
+    uint8_t  dirty;         // Bit n set when word 0x0B + n differs from device
+    uint8_t  uncorrectable; // Bit n set when word 0x0B + n loaded uncorrectable
+    bool     loaded;
+
+    uint32_t flushes;
+    uint32_t words_written;
+} acs_shadow_t;
+
+void acs_shadow_init(acs_shadow_t *shadow, const acs_device_t *dev);
+
+/**
+ * @brief Fills the cache from the device in one burst read and clears all
+ * dirty bits. Only the 26 data bits of each frame are kept, words the device
+ * flagged as uncorrectable are recorded in uncorrectable. On a transport
+ * error the cache is left as it was.
+ * @return ACS_OK, ACS_ERR_ECC if the device flagged any word as
+ * uncorrectable (the cache is still filled), or a transport error
+ */
+int acs_shadow_load(acs_shadow_t *shadow);
+
+/**
+ * @brief Replaces a whole cached word. Marks it dirty only if it changed.
+ * @return ACS_OK, or ACS_ERR_PARAM if address is not 0x0B to 0x0F or the
+ * cache was never loaded
+ */
+int acs_shadow_write(acs_shadow_t *shadow, uint8_t address, uint32_t word);
+
+/**
+ * @brief Returns a cached word, or 0 for addresses outside 0x0B to 0x0F.
+ */
+uint32_t acs_shadow_read(const acs_shadow_t *shadow, uint8_t address);
+
+/**
+ * @brief Unlocks the device and writes every dirty word, in address order,
+ * as frames with the EEC and reserved bits clear, and clears their
+ * uncorrectable bits. Nothing is sent on the bus when the cache is clean. Words that were
+ * written successfully are marked clean even if a later one fails.
+ * @return ACS_OK, ACS_ERR_PARAM if the cache was never loaded,
+ * ACS_ERR_LOCKED or a transport error
+ */
+int acs_shadow_flush(acs_shadow_t *shadow);
+
+static inline bool acs_shadow_is_dirty(const acs_shadow_t *shadow)
+{
+    return shadow->dirty != 0U;
+}
+
+/**
+ * For every EEPROM field this generates
+ *   uint32_t acs_shadow_get_<field>(const acs_shadow_t *shadow)
+ *   int      acs_shadow_set_<field>(acs_shadow_t *shadow, uint32_t value)
+ * the setter returning as acs_shadow_write().
+ */
+#define ACS_SHADOW_ACCESSORS(prefix, address, field, shift, width, is_signed)      \
+    static inline uint32_t acs_shadow_get_##field(const acs_shadow_t *shadow)     \
+    {                                                                             \
+        return prefix##_##field##_get(shadow->cache.words[(address) - ACS_REG_EEPROM_FIRST]); \
+    }                                                                             \
+    static inline int acs_shadow_set_##field(acs_shadow_t *shadow, uint32_t value) \
+    {                                                                             \
+        uint32_t word = shadow->cache.words[(address) - ACS_REG_EEPROM_FIRST];    \
+        return acs_shadow_write(shadow, (address), prefix##_##field##_set(word, value)); \
+    }
+
+ACS_EEPROM_FIELDS(ACS_SHADOW_ACCESSORS)
+
+#endif // _ACS71020_shadow_H_
\ No newline at end of file
@@ -0,0 +1,415 @@
+#include <math.h>
+#include <string.h>
+#include "ACS71020_sim.h"
+#include "ACS71020_calib.h"
+
+#define TWO_PI 6.28318530717958647692
+
+#define VCODES_ONE  65536.0     // vcodes Q16, 1.0 is voltage full scale
+#define ICODES_ONE  32768.0     // icodes Q15, 1.0 is current full scale
+#define CODES_MAX   65535
+#define CODES_MIN   (-65536)
+
+void acs_sim_default_config(acs_sim_config_t *config)
+{
+    memset(config, 0, sizeof(*config));
+    config->line_hz           = 50.0f;
+    config->voltage.amplitude = 0.7f;
+    config->current.amplitude = 0.5f;
+    config->bus               = ACS_SIM_BUS_I2C;
+    config->bus_hz            = 400000U;
+    config->overhead_ns       = 0U;
+    config->dev_addr          = 96U;
+}
+
+void acs_sim_init(acs_sim_t *sim, const acs_sim_config_t *config)
+{
+    memset(sim, 0, sizeof(*sim));
+    sim->config = *config;
+
+    uint32_t r0x0F = 0U;
+    r0x0F = eeprom_0x0F_i2c_slv_addr_set(r0x0F, config->dev_addr);
+    sim->regs[0x0F] = r0x0F;
+
+    sim->factory_crs = (int8_t)eeprom_0x0B_crs_sns_get(sim->regs[0x0B]);
+}
+
+void acs_sim_set_dio_callback(acs_sim_t *sim, acs_sim_dio_callback_t callback, void *user)
+{
+    sim->dio_callback = callback;
+    sim->dio_user     = user;
+}
+
+/* ----------------------------------------------------------------------- */
+/* Signal path                                                              */
+/* ----------------------------------------------------------------------- */
+
+static double wave(const acs_sim_wave_t *w, double wt)
+{
+    double x = w->dc + w->amplitude * sin(wt + w->phase);
+
+    for (uint32_t k = 0; k < ACS_SIM_HARMONICS; k++)
+    {
+        if (w->harmonic[k] != 0.0f)
+            x += w->amplitude * w->harmonic[k] * sin((double)(k + 2U) * wt + w->harmonic_phase[k]);
+    }
+    return x;
+}
+
+static int32_t clamp_codes(double x)
+{
+    if (x > CODES_MAX)
+        return CODES_MAX;
+    if (x < CODES_MIN)
+        return CODES_MIN;
+    return (int32_t)lround(x);
+}
+
+static uint32_t clamp_u(double x, uint32_t max)
+{
+    if (x <= 0.0)
+        return 0U;
+    if (x >= max)
+        return max;
+    return (uint32_t)lround(x);
+}
+
+static int32_t clamp_s(double x, int32_t min, int32_t max)
+{
+    if (x <= min)
+        return min;
+    if (x >= max)
+        return max;
+    return (int32_t)lround(x);
+}
+
+static void set_dio0(acs_sim_t *sim, bool level)
+{
+    if (level == sim->dio0)
+        return;
+
+    sim->dio0 = level;
+    if (sim->dio_callback != NULL)
+        sim->dio_callback(sim->dio_user, level);
+}
+
+static void update_dio0(acs_sim_t *sim)
+{
+    uint32_t status = sim->regs[0x2D];
+    bool level;
+
+    switch (eeprom_0x0F_dio_0_sel_get(sim->regs[0x0F]))
+    {
+    case 0:  level = acs_0x2D_vzerocrossout_get(status); break;
+    case 1:  level = acs_0x2D_overvoltage_get(status); break;
+    case 2:  level = acs_0x2D_undervoltage_get(status); break;
+    default: level = acs_0x2D_overvoltage_get(status) || acs_0x2D_undervoltage_get(status); break;
+    }
+    set_dio0(sim, level);
+}
+
+static void zero_crossing(acs_sim_t *sim)
+{
+    uint32_t r0x0D = sim->regs[0x0D];
+
+    if (eeprom_0x0D_squarewave_en_get(r0x0D))
+    {
+        uint32_t zc = acs_0x2D_vzerocrossout_get(sim->regs[0x2D]);
+        sim->regs[0x2D] = acs_0x2D_vzerocrossout_set(sim->regs[0x2D], !zc);
+    }
+    else
+    {
+        uint64_t width = eeprom_0x0E_delaycnt_sel_get(sim->regs[0x0E]) ? 256000U : 32000U;
+        sim->zc_pulse_end_ns = sim->now_ns + width;
+        sim->regs[0x2D] = acs_0x2D_vzerocrossout_set(sim->regs[0x2D], 1U);
+    }
+}
+
+static void averaging(acs_sim_t *sim, uint32_t irms, uint32_t vrms, int32_t pactive)
+{
+    uint32_t r0x0B = sim->regs[0x0B];
+    uint32_t r0x0C = sim->regs[0x0C];
+    bool current = eeprom_0x0B_iavgselen_get(r0x0B) != 0U;
+    uint32_t n1 = eeprom_0x0C_rms_avg_1_get(r0x0C);
+    uint32_t n2 = eeprom_0x0C_rms_avg_2_get(r0x0C);
+
+    sim->avg1_rms += current ? irms : vrms;
+    sim->avg1_p   += pactive;
+    if (++sim->avg1_count < (n1 ? n1 : 1U))
+        return;
+
+    double rms1 = sim->avg1_rms / sim->avg1_count;
+    double p1   = sim->avg1_p / sim->avg1_count;
+    sim->avg1_rms = sim->avg1_p = 0.0;
+    sim->avg1_count = 0U;
+
+    uint32_t r0x26 = 0U;
+    if (current)
+        r0x26 = acs_0x26_irmsavgonesec_set(r0x26, clamp_u(rms1, 0x7FFFU));
+    else
+        r0x26 = acs_0x26_vrmsavgonesec_set(r0x26, clamp_u(rms1, 0x7FFFU));
+    sim->regs[0x26] = r0x26;
+    sim->regs[0x28] = acs_0x28_pactavgonesec_set(0U, (uint32_t)clamp_s(p1, CODES_MIN, CODES_MAX));
+
+    sim->avg2_rms += rms1;
+    sim->avg2_p   += p1;
+    if (++sim->avg2_count < (n2 ? n2 : 1U))
+        return;
+
+    double rms2 = sim->avg2_rms / sim->avg2_count;
+    double p2   = sim->avg2_p / sim->avg2_count;
+    sim->avg2_rms = sim->avg2_p = 0.0;
+    sim->avg2_count = 0U;
+
+    uint32_t r0x27 = 0U;
+    if (current)
+        r0x27 = acs_0x27_irmsavgonemin_set(r0x27, clamp_u(rms2, 0x7FFFU));
+    else
+        r0x27 = acs_0x27_vrmsavgonemin_set(r0x27, clamp_u(rms2, 0x7FFFU));
+    sim->regs[0x27] = r0x27;
+    sim->regs[0x29] = acs_0x29_pactavgonemin_set(0U, (uint32_t)clamp_s(p2, CODES_MIN, CODES_MAX));
+}
+
+/**
+ * @brief Closes one line cycle and publishes the rms and power registers.
+ */
+static void end_of_cycle(acs_sim_t *sim)
+{
+    double n = sim->points;
+    double vrms = sqrt(sim->sum_vv / n) / VCODES_ONE;   // fraction of full scale
+    double irms = sqrt(sim->sum_ii / n) / ICODES_ONE;
+    double p    = sim->sum_vi / n / (VCODES_ONE * ICODES_ONE);
+    double s    = vrms * irms;
+    double q    = s * s > p * p ? sqrt(s * s - p * p) : 0.0;
+
+    uint32_t vrms_code = clamp_u(vrms * 32768.0, 0x7FFFU);
+    uint32_t irms_code = clamp_u(irms * 16384.0, 0x7FFFU);
+    int32_t  pacc_trim = eeprom_0x0D_pacc_trim_sget(sim->regs[0x0D]);
+    int32_t  pactive   = clamp_s((p + sim->config.power_offset) * 32768.0 + 6.0 * pacc_trim,
+                                 CODES_MIN, CODES_MAX);
+
+    sim->regs[0x20] = acs_0x20_vrms_set(acs_0x20_irms_set(0U, irms_code), vrms_code);
+    sim->regs[0x21] = acs_0x21_pactive_set(0U, (uint32_t)pactive);
+    sim->regs[0x22] = acs_0x22_papparent_set(0U, clamp_u(s * 32768.0, 0xFFFFU));
+    sim->regs[0x23] = acs_0x23_pimag_set(0U, clamp_u(q * 32768.0, 0xFFFFU));
+    sim->regs[0x24] = acs_0x24_pfactor_set(0U, (uint32_t)clamp_s(s > 0.0 ? p / s * 512.0 : 0.0, -1024, 1023));
+    // numptsout is 9 bits, a 50 Hz cycle at 32 kHz does not fit and saturates
+    sim->regs[0x25] = acs_0x25_numptsout_set(0U, sim->points > 511U ? 511U : sim->points);
+
+    uint32_t status = sim->regs[0x2D];
+    status = acs_0x2D_posangle_set(status, sim->sum_q > 0.0);
+    status = acs_0x2D_pospf_set(status, pactive >= 0);
+
+    // Over / undervoltage, thresholds span the whole vrms range in 64 steps
+    uint32_t r0x0E = sim->regs[0x0E];
+    uint32_t ov = eeprom_0x0E_overvreg_get(r0x0E) << 9;
+    uint32_t uv = eeprom_0x0E_undervreg_get(r0x0E) << 9;
+    uint32_t cycles = eeprom_0x0E_vevent_cycs_get(r0x0E) + 1U;
+
+    sim->ov_cycles = (ov != 0U && vrms_code > ov) ? sim->ov_cycles + 1U : 0U;
+    sim->uv_cycles = (uv != 0U && vrms_code < uv) ? sim->uv_cycles + 1U : 0U;
+    status = acs_0x2D_overvoltage_set(status, sim->ov_cycles >= cycles);
+    status = acs_0x2D_undervoltage_set(status, sim->uv_cycles >= cycles);
+    sim->regs[0x2D] = status;
+
+    averaging(sim, irms_code, vrms_code, pactive);
+}
+
+/**
+ * @brief A delay line tap half_samples half samples back, the mean of the
+ * two neighbouring samples for an odd count.
+ */
+static int32_t delay_tap(const int32_t *hist, uint32_t half_samples)
+{
+    const int32_t *h = &hist[half_samples / 2U];
+    return (half_samples & 1U) != 0U ? (int32_t)(((int64_t)h[0] + h[1]) / 2) : h[0];
+}
+
+/**
+ * @brief One ADC sample of both channels.
+ */
+static void sample(acs_sim_t *sim)
+{
+    const acs_sim_config_t *c = &sim->config;
+    double t = (double)sim->now_ns * 1e-9;
+    double w = TWO_PI * c->line_hz;
+
+    uint32_t r0x0B = sim->regs[0x0B];
+    uint32_t r0x0D = sim->regs[0x0D];
+    uint32_t r0x0E = sim->regs[0x0E];
+
+    // Current path: offset trim first, then coarse and fine gain
+    double crs  = acs_crs_sns_gain[eeprom_0x0B_crs_sns_get(r0x0B)] / acs_crs_sns_gain[sim->factory_crs];
+    double fine = 1.0 + eeprom_0x0B_sns_fine_sget(r0x0B) / 512.0;
+    double qvo  = eeprom_0x0B_qvo_fine_sget(r0x0B) * 64.0;
+
+    double v = wave(&c->voltage, w * t) * VCODES_ONE;
+    double i = wave(&c->current, w * (t - c->current_lag_us * 1e-6)) * (1.0 + c->current_gain_error);
+    i = (i + c->current_offset) * ICODES_ONE * crs;
+    i = (i + qvo) * fine;
+
+    memmove(&sim->v_hist[1], &sim->v_hist[0], sizeof(sim->v_hist) - sizeof(sim->v_hist[0]));
+    memmove(&sim->i_hist[1], &sim->i_hist[0], sizeof(sim->i_hist) - sizeof(sim->i_hist[0]));
+    sim->v_hist[0] = clamp_codes(v);
+    sim->i_hist[0] = clamp_codes(i);
+
+    // Delays in half samples, a step is two of them at 32 kHz and one at 4 kHz
+    uint32_t delay = eeprom_0x0D_chan_del_sel_get(r0x0D) * 2U * acs_chan_del_step_ns(r0x0E) /
+                     (1000000000U / acs_adc_rate_hz(r0x0E));
+    bool delay_current = eeprom_0x0D_ichan_del_en_get(r0x0D) != 0U;
+    uint32_t dv = delay_current ? 0U : delay;
+    uint32_t di = delay_current ? delay : 0U;
+    int32_t vc = delay_tap(sim->v_hist, dv);
+    int32_t ic = delay_tap(sim->i_hist, di);
+
+    sim->regs[0x2A] = acs_0x2A_vcodes_set(0U, (uint32_t)vc);
+    sim->regs[0x2B] = acs_0x2B_icodes_set(0U, (uint32_t)ic);
+    sim->regs[0x2C] = (uint32_t)(int32_t)(((int64_t)vc * ic) >> 2);
+
+    // Overcurrent, threshold from 50 % to 175 % of full scale
+    double fault = (0.5 + 1.25 * eeprom_0x0D_fault_get(r0x0D) / 255.0) * ICODES_ONE;
+    bool over = fabs((double)ic) > fault;
+    uint32_t status = sim->regs[0x2D];
+    status = acs_0x2D_faultout_set(status, over);
+    if (over)
+        status = acs_0x2D_faultlatched_set(status, 1U);
+    if (sim->zc_pulse_end_ns != 0U && sim->now_ns >= sim->zc_pulse_end_ns)
+    {
+        status = acs_0x2D_vzerocrossout_set(status, 0U);
+        sim->zc_pulse_end_ns = 0U;
+    }
+    sim->regs[0x2D] = status;
+
+    bool rising  = sim->prev_v < 0 && vc >= 0;
+    bool falling = sim->prev_v >= 0 && vc < 0 && sim->sample_index > 0U;
+    sim->prev_v = vc;
+
+    if (rising || (falling && eeprom_0x0D_halfcycle_en_get(r0x0D)))
+        zero_crossing(sim);
+
+    if (rising)
+    {
+        if (sim->cycle_started && sim->points > 0U)
+            end_of_cycle(sim);
+        sim->sum_vv = sim->sum_ii = sim->sum_vi = sim->sum_q = 0.0;
+        sim->points = 0U;
+        sim->cycle_started = true;
+    }
+
+    sim->sum_vv += (double)vc * vc;
+    sim->sum_ii += (double)ic * ic;
+    sim->sum_vi += (double)vc * ic;
+    sim->sum_q  += (double)delay_tap(sim->v_hist, dv + 2U) * ic - (double)vc * delay_tap(sim->i_hist, di + 2U);
+    sim->points++;
+    sim->sample_index++;
+
+    update_dio0(sim);
+}
+
+void acs_sim_advance(acs_sim_t *sim, uint64_t ns)
+{
+    uint64_t end = sim->now_ns + ns;
+    uint64_t period = 1000000000U / acs_adc_rate_hz(sim->regs[0x0E]);
+
+    while (sim->next_sample_ns <= end)
+    {
+        sim->now_ns = sim->next_sample_ns;
+        sample(sim);
+        sim->next_sample_ns += period;
+    }
+    sim->now_ns = end;
+}
+
+/* ----------------------------------------------------------------------- */
+/* Bus                                                                      */
+/* ----------------------------------------------------------------------- */
+
+uint64_t acs_sim_transaction_ns(const acs_sim_t *sim, uint8_t count, bool read)
+{
+    uint64_t bits;
+
+    if (sim->config.bus == ACS_SIM_BUS_SPI)
+        bits = 8U * (1U + 4U * count);
+    else if (read)
+        bits = 9U * (3U + 4U * count) + 3U;     // start, repeated start, stop
+    else
+        bits = 9U * (2U + 4U * count) + 2U;
+
+    return bits * 1000000000U / sim->config.bus_hz + sim->config.overhead_ns;
+}
+
+static bool addressed(acs_sim_t *sim, uint8_t dev_addr)
+{
+    return sim->config.bus == ACS_SIM_BUS_SPI || dev_addr == sim->config.dev_addr;
+}
+
+static int sim_read(void *ctx, uint8_t dev_addr, uint8_t reg_addr,
+                    uint32_t *words, uint8_t count)
+{
+    acs_sim_t *sim = ctx;
+
+    if (words == NULL || count == 0U || (unsigned)reg_addr + count > 256U)
+        return ACS_ERR_PARAM;
+
+    acs_sim_advance(sim, acs_sim_transaction_ns(sim, count, true));
+    sim->transactions++;
+    if (!addressed(sim, dev_addr))
+        return ACS_ERR_NAK;
+
+    memcpy(words, &sim->regs[reg_addr], sizeof(uint32_t) * count);
+    return ACS_OK;
+}
+
+static void write_one(acs_sim_t *sim, uint8_t reg_addr, uint32_t value)
+{
+    bool unlocked = acs_0x30_customer_access_get(sim->regs[0x30]) != 0U;
+
+    if (reg_addr >= ACS_REG_EEPROM_FIRST && reg_addr <= ACS_REG_EEPROM_LAST)
+    {
+        if (!unlocked)
+        {
+            sim->rejected_writes++;
+            return;
+        }
+        // Stored without the EEC and reserved low bits
+        sim->regs[reg_addr] = value & ~0x3FU;
+        sim->eeprom_writes[reg_addr - ACS_REG_EEPROM_FIRST]++;
+    }
+    else if (reg_addr == 0x2DU)
+    {
+        // faultlatched is cleared by writing a 1, everything else is read only
+        if (acs_0x2D_faultlatched_get(value))
+            sim->regs[0x2D] = acs_0x2D_faultlatched_set(sim->regs[0x2D], 0U);
+    }
+    else if (reg_addr == ACS_REG_ACCESS_CODE)
+    {
+        sim->regs[ACS_REG_ACCESS_CODE] = value;
+        sim->regs[ACS_REG_CUSTOMER_ACCESS] = value == ACS_CUSTOMER_CODE ? 1U : 0U;
+    }
+}
+
+static int sim_write(void *ctx, uint8_t dev_addr, uint8_t reg_addr,
+                     const uint32_t *words, uint8_t count)
+{
+    acs_sim_t *sim = ctx;
+
+    if (words == NULL || count == 0U || (unsigned)reg_addr + count > 256U)
+        return ACS_ERR_PARAM;
+
+    acs_sim_advance(sim, acs_sim_transaction_ns(sim, count, false));
+    sim->transactions++;
+    if (!addressed(sim, dev_addr))
+        return ACS_ERR_NAK;
+
+    for (uint8_t i = 0; i < count; i++)
+        write_one(sim, (uint8_t)(reg_addr + i), words[i]);
+    return ACS_OK;
+}
+
+void acs_transport_sim_init(acs_transport_t *transport, acs_sim_t *sim)
+{
+    transport->read       = sim_read;
+    transport->write      = sim_write;
+    transport->read_multi = NULL;
+    transport->ctx        = sim;
+}
\ No newline at end of file
@@ -0,0 +1,148 @@
+/**
+ * @file ACS71020_sim.h
+ * @author Usman Mehmood (usmanmehmood55@gmail.com)
+ * @brief Simulated ACS71020, a stand-in for hardware on a plain host. It
+ * holds the whole register file, synthesizes vcodes and icodes from
+ * configurable waveforms one ADC sample at a time, and computes the rms,
+ * power, averaging, zero-crossing and fault registers once per line cycle
+ * the way the datasheet describes. The EEPROM is only writable after the
+ * access code has been written, and every bus transaction advances the
+ * simulated clock by the time it would take on a real bus, so burst reads,
+ * schedulers and capture can be measured against realistic timing.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _ACS71020_sim_H_
+#define _ACS71020_sim_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "ACS71020.h"
+
+#define ACS_SIM_HARMONICS 8U
+
+/**
+ * @brief One channel's waveform, in fractions of the channel's full scale.
+ * harmonic[k] is the amplitude of harmonic k + 2 relative to the fundamental.
+ */
+typedef struct
+{
+    float amplitude;                        // Peak, 1.0 is full scale
+    float phase;                            // Radians
+    float dc;                               // Offset, fraction of full scale
+    float harmonic[ACS_SIM_HARMONICS];
+    float harmonic_phase[ACS_SIM_HARMONICS];
+} acs_sim_wave_t;
+
+typedef enum
+{
+    ACS_SIM_BUS_I2C,
+    ACS_SIM_BUS_SPI,
+} acs_sim_bus_t;
+
+/**
+ * @brief Called on every DIO0 level change, as a GPIO edge source.
+ */
+typedef void (*acs_sim_dio_callback_t)(void *user, bool level);
+
+typedef struct
+{
+    float           line_hz;
+    acs_sim_wave_t  voltage;
+    acs_sim_wave_t  current;
+    float           current_lag_us;     // Sensor phase error of the current path
+    float           current_gain_error; // Untrimmed sensor gain error, 0.0 is exact
+    float           current_offset;     // Untrimmed sensor offset, fraction of full scale
+    float           power_offset;       // Active power offset, fraction of full scale
+
+    acs_sim_bus_t   bus;
+    uint32_t        bus_hz;             // SCL or SCLK frequency
+    uint32_t        overhead_ns;        // Fixed cost per transaction
+
+    uint8_t         dev_addr;
+} acs_sim_config_t;
+
+typedef struct
+{
+    acs_sim_config_t config;
+    uint32_t        regs[256];
+
+    uint64_t        now_ns;
+    uint64_t        next_sample_ns;
+    uint64_t        sample_index;
+
+    // Channel delay lines for chan_del_sel, newest first: 7 samples at
+    // 32 kHz, 3.5 at 4 kHz, and one extra sample for the quadrature sum
+    int32_t         v_hist[9];
+    int32_t         i_hist[9];
+
+    // Current cycle
+    int32_t         prev_v;
+    double          sum_vv;
+    double          sum_ii;
+    double          sum_vi;
+    double          sum_q;              // Sign gives leading or lagging
+    uint32_t        points;
+    bool            cycle_started;
+
+    // Averaging stages
+    double          avg1_rms;
+    double          avg1_p;
+    uint32_t        avg1_count;
+    double          avg2_rms;
+    double          avg2_p;
+    uint32_t        avg2_count;
+
+    // Flags
+    uint32_t        ov_cycles;
+    uint32_t        uv_cycles;
+    uint64_t        zc_pulse_end_ns;
+    bool            dio0;
+    int8_t          factory_crs;
+
+    acs_sim_dio_callback_t dio_callback;
+    void           *dio_user;
+
+    // Statistics
+    uint32_t        transactions;
+    uint32_t        eeprom_writes[ACS_EEPROM_WORDS];
+    uint32_t        rejected_writes;    // EEPROM writes while locked
+} acs_sim_t;
+
+/**
+ * @brief Fills a configuration with a 50 Hz, 70 % voltage, 50 % current,
+ * in-phase load on a 400 kHz I2C bus at address 96.
+ */
+void acs_sim_default_config(acs_sim_config_t *config);
+
+void acs_sim_init(acs_sim_t *sim, const acs_sim_config_t *config);
+
+void acs_sim_set_dio_callback(acs_sim_t *sim, acs_sim_dio_callback_t callback, void *user);
+
+/**
+ * @brief Runs the device forward by ns nanoseconds of simulated time.
+ */
+void acs_sim_advance(acs_sim_t *sim, uint64_t ns);
+
+static inline uint64_t acs_sim_now_us(const acs_sim_t *sim)
+{
+    return sim->now_ns / 1000U;
+}
+
+/**
+ * @brief Bus time of one transaction moving count words, in nanoseconds.
+ */
+uint64_t acs_sim_transaction_ns(const acs_sim_t *sim, uint8_t count, bool read);
+
+/**
+ * @brief Builds a transport around the simulator. Every transaction first
+ * advances the simulated time by its bus time, then takes effect.
+ */
+void acs_transport_sim_init(acs_transport_t *transport, acs_sim_t *sim);
+
+#endif // _ACS71020_sim_H_
\ No newline at end of file
@@ -0,0 +1,234 @@
+#include <string.h>
+#include "ACS71020_stats.h"
+
+static const uint64_t window_us[ACS_STAT_WINDOWS] =
+{
+    [ACS_STAT_1S]    = 1000000U,
+    [ACS_STAT_10S]   = 10000000U,
+    [ACS_STAT_1MIN]  = 60000000U,
+    [ACS_STAT_15MIN] = 900000000U,
+};
+
+// No slot has this epoch until 584 thousand years of uptime
+#define EPOCH_NONE UINT64_MAX
+
+/**
+ * @brief Range of an unsigned field, given the all-ones code its getter
+ * returns, with frac fractional bits.
+ */
+static void unsigned_range(acs_stats_t *stats, acs_stat_channel_t channel, uint32_t ones,
+                           int frac, double full_scale)
+{
+    stats->lo[channel] = 0.0f;
+    stats->hi[channel] = (float)(ones * full_scale / (double)(1UL << frac));
+}
+
+/**
+ * @brief Range of a two's complement field of the same width.
+ */
+static void signed_range(acs_stats_t *stats, acs_stat_channel_t channel, uint32_t ones,
+                         int frac, double full_scale)
+{
+    double lsb = full_scale / (double)(1UL << frac);
+
+    stats->lo[channel] = (float)(-(double)(ones / 2U + 1U) * lsb);
+    stats->hi[channel] = (float)((double)(ones / 2U) * lsb);
+}
+
+void acs_stats_init(acs_stats_t *stats, const acs_full_scale_t *fs)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->fs = *fs;
+
+    // Everything each register can report, the widths from the getters
+    unsigned_range(stats, ACS_STAT_IRMS, acs_0x20_irms_get(UINT32_MAX),
+                   ACS_IRMS_FRAC, fs->current);
+    unsigned_range(stats, ACS_STAT_VRMS, acs_0x20_vrms_get(UINT32_MAX),
+                   ACS_VRMS_FRAC, fs->voltage);
+    signed_range(stats, ACS_STAT_PACTIVE, acs_0x21_pactive_get(UINT32_MAX),
+                 ACS_PACTIVE_FRAC, fs->power);
+    unsigned_range(stats, ACS_STAT_PAPPARENT, acs_0x22_papparent_get(UINT32_MAX),
+                   ACS_PAPPARENT_FRAC, fs->power);
+    unsigned_range(stats, ACS_STAT_PIMAG, acs_0x23_pimag_get(UINT32_MAX),
+                   ACS_PIMAG_FRAC, fs->power);
+    signed_range(stats, ACS_STAT_PFACTOR, acs_0x24_pfactor_get(UINT32_MAX),
+                 ACS_PFACTOR_FRAC, 1.0);
+
+    for (uint8_t w = 0; w < ACS_STAT_WINDOWS; w++)
+    {
+        stats->windows[w].slot_us = window_us[w] / ACS_STATS_SLOTS;
+        for (uint8_t s = 0; s < ACS_STATS_SLOTS; s++)
+            stats->windows[w].epoch[s] = EPOCH_NONE;
+    }
+}
+
+int acs_stats_set_range(acs_stats_t *stats, acs_stat_channel_t channel, float lo, float hi)
+{
+    if ((unsigned)channel >= ACS_STAT_CHANNELS || !(hi > lo))
+        return ACS_ERR_PARAM;
+
+    if (lo == stats->lo[channel] && hi == stats->hi[channel])
+        return ACS_OK;
+
+    // Bins counted against the old range would be read against the new one
+    for (uint8_t w = 0; w < ACS_STAT_WINDOWS; w++)
+        memset(stats->windows[w].slots[channel], 0, sizeof(stats->windows[w].slots[channel]));
+
+    stats->lo[channel] = lo;
+    stats->hi[channel] = hi;
+    return ACS_OK;
+}
+
+static uint32_t bin_of(const acs_stats_t *stats, uint8_t channel, float value)
+{
+    float pos = (value - stats->lo[channel]) / (stats->hi[channel] - stats->lo[channel]);
+    if (!(pos > 0.0f))
+        return 0U;
+    if (pos >= 1.0f)
+        return ACS_STATS_BINS - 1U;
+    return (uint32_t)(pos * (float)ACS_STATS_BINS);
+}
+
+void acs_stats_update(acs_stats_t *stats, const acs_measurement_t *m, uint64_t now_us)
+{
+    const float values[ACS_STAT_CHANNELS] =
+    {
+        m->irms, m->vrms, m->pactive, m->papparent, m->pimag, m->pfactor,
+    };
+    uint32_t bins[ACS_STAT_CHANNELS];
+
+    for (uint8_t c = 0; c < ACS_STAT_CHANNELS; c++)
+        bins[c] = bin_of(stats, c, values[c]);
+
+    for (uint8_t w = 0; w < ACS_STAT_WINDOWS; w++)
+    {
+        acs_stats_window_t *win = &stats->windows[w];
+        uint64_t epoch = now_us / win->slot_us;
+        uint32_t index = (uint32_t)(epoch % ACS_STATS_SLOTS);
+
+        // The slot last held data one full window ago, start it over
+        bool fresh = win->epoch[index] != epoch;
+        win->epoch[index] = epoch;
+
+        for (uint8_t c = 0; c < ACS_STAT_CHANNELS; c++)
+        {
+            acs_stats_slot_t *slot = &win->slots[c][index];
+            float v = values[c];
+
+            // A channel's slots are also emptied by a range change
+            if (fresh || slot->count == 0U)
+            {
+                memset(slot, 0, sizeof(*slot));
+                slot->min = v;
+                slot->max = v;
+            }
+            else
+            {
+                if (v < slot->min)
+                    slot->min = v;
+                if (v > slot->max)
+                    slot->max = v;
+            }
+            slot->sum += v;
+            slot->count++;
+            slot->bins[bins[c]]++;
+        }
+    }
+}
+
+void acs_stats_update_snapshot(acs_stats_t *stats, const acs_snapshot_t *snap, uint64_t now_us)
+{
+    acs_measurement_t m;
+
+    acs_decode_snapshot(snap, &stats->fs, &m);
+    acs_stats_update(stats, &m, now_us);
+}
+
+static bool slot_live(const acs_stats_window_t *win, uint8_t s, uint64_t now_epoch)
+{
+    uint64_t e = win->epoch[s];
+    return e != EPOCH_NONE && e <= now_epoch && now_epoch - e < ACS_STATS_SLOTS;
+}
+
+int acs_stats_query(const acs_stats_t *stats, acs_stat_window_t window,
+                    acs_stat_channel_t channel, uint64_t now_us, acs_stats_result_t *out)
+{
+    if ((unsigned)window >= ACS_STAT_WINDOWS || (unsigned)channel >= ACS_STAT_CHANNELS)
+        return ACS_ERR_PARAM;
+
+    const acs_stats_window_t *win = &stats->windows[window];
+    uint64_t now_epoch = now_us / win->slot_us;
+    double   sum = 0.0;
+
+    memset(out, 0, sizeof(*out));
+    for (uint8_t s = 0; s < ACS_STATS_SLOTS; s++)
+    {
+        const acs_stats_slot_t *slot = &win->slots[channel][s];
+        if (!slot_live(win, s, now_epoch) || slot->count == 0U)
+            continue;
+
+        if (out->count == 0U || slot->min < out->min)
+            out->min = slot->min;
+        if (out->count == 0U || slot->max > out->max)
+            out->max = slot->max;
+        sum        += slot->sum;
+        out->count += slot->count;
+    }
+
+    if (out->count == 0U)
+        return ACS_ERR_EMPTY;
+
+    out->mean = (float)(sum / (double)out->count);
+    return ACS_OK;
+}
+
+int acs_stats_percentile(const acs_stats_t *stats, acs_stat_window_t window,
+                         acs_stat_channel_t channel, uint64_t now_us, float p, float *out)
+{
+    acs_stats_result_t r;
+    uint32_t bins[ACS_STATS_BINS] = { 0 };
+
+    int ret = acs_stats_query(stats, window, channel, now_us, &r);
+    if (ret != ACS_OK)
+        return ret;
+
+    const acs_stats_window_t *win = &stats->windows[window];
+    uint64_t now_epoch = now_us / win->slot_us;
+    for (uint8_t s = 0; s < ACS_STATS_SLOTS; s++)
+    {
+        if (!slot_live(win, s, now_epoch))
+            continue;
+        for (uint32_t b = 0; b < ACS_STATS_BINS; b++)
+            bins[b] += win->slots[channel][s].bins[b];
+    }
+
+    if (p < 0.0f)
+        p = 0.0f;
+    if (p > 1.0f)
+        p = 1.0f;
+
+    float target = p * (float)r.count;
+    float width  = (stats->hi[channel] - stats->lo[channel]) / (float)ACS_STATS_BINS;
+    uint32_t seen = 0U;
+    float value = r.max;
+
+    for (uint32_t b = 0; b < ACS_STATS_BINS; b++)
+    {
+        if (bins[b] == 0U || (float)(seen + bins[b]) < target)
+        {
+            seen += bins[b];
+            continue;
+        }
+
+        float frac = (target - (float)seen) / (float)bins[b];
+        value = stats->lo[channel] + ((float)b + frac) * width;
+        break;
+    }
+
+    if (value < r.min)
+        value = r.min;
+    if (value > r.max)
+        value = r.max;
+    *out = value;
+    return ACS_OK;
+}
\ No newline at end of file
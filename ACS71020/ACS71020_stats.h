@@ -0,0 +1,134 @@
+/**
+ * @file ACS71020_stats.h
+ * @author Usman Mehmood (usmanmehmood55@gmail.com)
+ * @brief Rolling power-quality statistics over 1 s, 10 s, 1 min and 15 min
+ * for irms, vrms, pactive, papparent, pimag and pfactor, all at once.
+ * Every window is a ring of ACS_STATS_SLOTS time slots. A slot keeps the
+ * min, max, sum, count and a fixed-bin histogram of the values that arrived
+ * during it, so adding a snapshot touches one slot per window and channel,
+ * and a slot that falls out of its window is simply reused. Queries combine
+ * the slots of a window, so windows slide in steps of one slot, a tenth of
+ * the window by default. Min, max and mean are exact, percentiles are
+ * interpolated within a histogram bin.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _ACS71020_stats_H_
+#define _ACS71020_stats_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "ACS71020.h"
+#include "ACS71020_decode.h"
+
+#ifndef ACS_STATS_SLOTS
+#define ACS_STATS_SLOTS 10U
+#endif
+
+#ifndef ACS_STATS_BINS
+#define ACS_STATS_BINS  64U
+#endif
+
+typedef enum
+{
+    ACS_STAT_IRMS,
+    ACS_STAT_VRMS,
+    ACS_STAT_PACTIVE,
+    ACS_STAT_PAPPARENT,
+    ACS_STAT_PIMAG,
+    ACS_STAT_PFACTOR,
+    ACS_STAT_CHANNELS,
+} acs_stat_channel_t;
+
+typedef enum
+{
+    ACS_STAT_1S,
+    ACS_STAT_10S,
+    ACS_STAT_1MIN,
+    ACS_STAT_15MIN,
+    ACS_STAT_WINDOWS,
+} acs_stat_window_t;
+
+typedef struct
+{
+    float    min;
+    float    max;
+    double   sum;
+    uint32_t count;
+    uint32_t bins[ACS_STATS_BINS];
+} acs_stats_slot_t;
+
+typedef struct
+{
+    uint64_t         slot_us;
+    uint64_t         epoch[ACS_STATS_SLOTS];   // now_us / slot_us of each slot's data
+    acs_stats_slot_t slots[ACS_STAT_CHANNELS][ACS_STATS_SLOTS];
+} acs_stats_window_t;
+
+typedef struct
+{
+    acs_full_scale_t   fs;
+    float              lo[ACS_STAT_CHANNELS];   // Histogram range, values outside
+    float              hi[ACS_STAT_CHANNELS];   // it land in the end bins
+    acs_stats_window_t windows[ACS_STAT_WINDOWS];
+} acs_stats_t;
+
+typedef struct
+{
+    float    min;
+    float    max;
+    float    mean;
+    uint32_t count;
+} acs_stats_result_t;
+
+/**
+ * @brief Clears all windows and sets each channel's histogram range to all
+ * the values its register can hold: 0 to 2 full scale for irms, apparent and
+ * reactive power, 0 to full scale for vrms, plus and minus 2 full scale for
+ * active power, -2 to 2 for pfactor. Narrow them with acs_stats_set_range()
+ * for finer bins.
+ */
+void acs_stats_init(acs_stats_t *stats, const acs_full_scale_t *fs);
+
+/**
+ * @brief Narrows a channel's histogram range for finer percentiles. The
+ * channel's data is cleared from every window, so its statistics only cover
+ * values added afterwards. Setting the current range again keeps the data.
+ * @return ACS_OK or ACS_ERR_PARAM
+ */
+int acs_stats_set_range(acs_stats_t *stats, acs_stat_channel_t channel, float lo, float hi);
+
+/**
+ * @brief Adds one decoded measurement taken at now_us. Timestamps must not go
+ * backwards.
+ */
+void acs_stats_update(acs_stats_t *stats, const acs_measurement_t *m, uint64_t now_us);
+
+/**
+ * @brief Decodes a snapshot with the full-scale values given at init and adds it.
+ */
+void acs_stats_update_snapshot(acs_stats_t *stats, const acs_snapshot_t *snap, uint64_t now_us);
+
+/**
+ * @brief Min, max, mean and count of a channel over a window ending at now_us.
+ * @return ACS_OK, or ACS_ERR_EMPTY if the window holds no data
+ */
+int acs_stats_query(const acs_stats_t *stats, acs_stat_window_t window,
+                    acs_stat_channel_t channel, uint64_t now_us, acs_stats_result_t *out);
+
+/**
+ * @brief Value below which a fraction p of a channel's values over a window
+ * fall, interpolated within the histogram bin and clamped to the window's
+ * min and max.
+ * @param p 0.0 to 1.0
+ * @return ACS_OK, or ACS_ERR_EMPTY if the window holds no data
+ */
+int acs_stats_percentile(const acs_stats_t *stats, acs_stat_window_t window,
+                         acs_stat_channel_t channel, uint64_t now_us, float p, float *out);
+
+#endif // _ACS71020_stats_H_
\ No newline at end of file
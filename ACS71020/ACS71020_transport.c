@@ -0,0 +1,267 @@
+#include <string.h>
+#include "ACS71020.h"
+
+#define ACS_SPI_READ_BIT 0x80U
+
+static void words_to_bytes(const uint32_t *words, uint8_t count, uint8_t *bytes)
+{
+    for (uint8_t i = 0; i < count; i++)
+    {
+        bytes[4U * i + 0U] = (uint8_t)(words[i]);
+        bytes[4U * i + 1U] = (uint8_t)(words[i] >> 8);
+        bytes[4U * i + 2U] = (uint8_t)(words[i] >> 16);
+        bytes[4U * i + 3U] = (uint8_t)(words[i] >> 24);
+    }
+}
+
+static void bytes_to_words(const uint8_t *bytes, uint8_t count, uint32_t *words)
+{
+    for (uint8_t i = 0; i < count; i++)
+    {
+        words[i] = (uint32_t)bytes[4U * i + 0U]
+                 | (uint32_t)bytes[4U * i + 1U] << 8
+                 | (uint32_t)bytes[4U * i + 2U] << 16
+                 | (uint32_t)bytes[4U * i + 3U] << 24;
+    }
+}
+
+int acs_transport_read_multi(const acs_transport_t *transport, acs_xfer_t *xfers,
+                             uint8_t count)
+{
+    if (transport->read_multi != NULL)
+        return transport->read_multi(transport->ctx, xfers, count);
+
+    for (uint8_t i = 0; i < count; i++)
+        xfers[i].status = transport->read(transport->ctx, xfers[i].dev_addr,
+                                          xfers[i].reg_addr, xfers[i].words,
+                                          xfers[i].count);
+    return ACS_OK;
+}
+
+/* ----------------------------------------------------------------------- */
+/* I2C                                                                      */
+/* ----------------------------------------------------------------------- */
+
+static int i2c_read(void *ctx, uint8_t dev_addr, uint8_t reg_addr,
+                    uint32_t *words, uint8_t count)
+{
+    acs_i2c_bus_t *bus = ctx;
+    uint8_t rx[4U * ACS_TRANSPORT_MAX_WORDS];
+
+    if (words == NULL || count == 0U || count > ACS_TRANSPORT_MAX_WORDS)
+        return ACS_ERR_PARAM;
+
+    int ret = bus->xfer(bus->ctx, dev_addr, &reg_addr, 1U, rx, 4U * count);
+    if (ret != ACS_OK)
+        return ret;
+
+    bytes_to_words(rx, count, words);
+    return ACS_OK;
+}
+
+static int i2c_write(void *ctx, uint8_t dev_addr, uint8_t reg_addr,
+                     const uint32_t *words, uint8_t count)
+{
+    acs_i2c_bus_t *bus = ctx;
+    uint8_t tx[1U + 4U * ACS_TRANSPORT_MAX_WORDS];
+
+    if (words == NULL || count == 0U || count > ACS_TRANSPORT_MAX_WORDS)
+        return ACS_ERR_PARAM;
+
+    tx[0] = reg_addr;
+    words_to_bytes(words, count, &tx[1]);
+    return bus->xfer(bus->ctx, dev_addr, tx, 1U + 4U * count, NULL, 0U);
+}
+
+void acs_transport_i2c_init(acs_transport_t *transport, acs_i2c_bus_t *bus)
+{
+    transport->read       = i2c_read;
+    transport->write      = i2c_write;
+    transport->read_multi = NULL;
+    transport->ctx        = bus;
+}
+
+/* ----------------------------------------------------------------------- */
+/* SPI                                                                      */
+/* ----------------------------------------------------------------------- */
+
+static int spi_read(void *ctx, uint8_t dev_addr, uint8_t reg_addr,
+                    uint32_t *words, uint8_t count)
+{
+    acs_spi_bus_t *bus = ctx;
+    uint8_t tx[1U + 4U * ACS_TRANSPORT_MAX_WORDS] = { 0 };
+    uint8_t rx[1U + 4U * ACS_TRANSPORT_MAX_WORDS];
+    (void)dev_addr;
+
+    if (words == NULL || count == 0U || count > ACS_TRANSPORT_MAX_WORDS)
+        return ACS_ERR_PARAM;
+
+    tx[0] = reg_addr | ACS_SPI_READ_BIT;
+    int ret = bus->xfer(bus->ctx, tx, rx, 1U + 4U * count);
+    if (ret != ACS_OK)
+        return ret;
+
+    bytes_to_words(&rx[1], count, words);
+    return ACS_OK;
+}
+
+static int spi_write(void *ctx, uint8_t dev_addr, uint8_t reg_addr,
+                     const uint32_t *words, uint8_t count)
+{
+    acs_spi_bus_t *bus = ctx;
+    uint8_t tx[1U + 4U * ACS_TRANSPORT_MAX_WORDS];
+    (void)dev_addr;
+
+    if (words == NULL || count == 0U || count > ACS_TRANSPORT_MAX_WORDS)
+        return ACS_ERR_PARAM;
+
+    tx[0] = reg_addr & (uint8_t)~ACS_SPI_READ_BIT;
+    words_to_bytes(words, count, &tx[1]);
+    return bus->xfer(bus->ctx, tx, NULL, 1U + 4U * count);
+}
+
+void acs_transport_spi_init(acs_transport_t *transport, acs_spi_bus_t *bus)
+{
+    transport->read       = spi_read;
+    transport->write      = spi_write;
+    transport->read_multi = NULL;
+    transport->ctx        = bus;
+}
+
+/* ----------------------------------------------------------------------- */
+/* In-memory fake                                                           */
+/* ----------------------------------------------------------------------- */
+
+static int fake_check(acs_fake_t *fake, uint8_t dev_addr, uint8_t reg_addr,
+                      const void *words, uint8_t count)
+{
+    if (fake->fail_next != ACS_OK)
+    {
+        int ret = fake->fail_next;
+        fake->fail_next = ACS_OK;
+        return ret;
+    }
+    if (dev_addr != fake->dev_addr)
+        return ACS_ERR_NAK;
+    if (words == NULL || count == 0U || (unsigned)reg_addr + count > 256U)
+        return ACS_ERR_PARAM;
+    return ACS_OK;
+}
+
+static int fake_read(void *ctx, uint8_t dev_addr, uint8_t reg_addr,
+                     uint32_t *words, uint8_t count)
+{
+    acs_fake_t *fake = ctx;
+    int ret = fake_check(fake, dev_addr, reg_addr, words, count);
+    if (ret != ACS_OK)
+        return ret;
+
+    memcpy(words, &fake->regs[reg_addr], sizeof(uint32_t) * count);
+    fake->read_transactions++;
+    fake->words_read += count;
+    return ACS_OK;
+}
+
+static int fake_write(void *ctx, uint8_t dev_addr, uint8_t reg_addr,
+                      const uint32_t *words, uint8_t count)
+{
+    acs_fake_t *fake = ctx;
+    int ret = fake_check(fake, dev_addr, reg_addr, words, count);
+    if (ret != ACS_OK)
+        return ret;
+
+    memcpy(&fake->regs[reg_addr], words, sizeof(uint32_t) * count);
+
+    // Mimic the access code register, 0x2F unlocks 0x30.customer_access
+    if (reg_addr <= ACS_REG_ACCESS_CODE && reg_addr + count > ACS_REG_ACCESS_CODE)
+        fake->regs[ACS_REG_CUSTOMER_ACCESS] =
+            fake->regs[ACS_REG_ACCESS_CODE] == ACS_CUSTOMER_CODE ? 1U : 0U;
+
+    fake->write_transactions++;
+    fake->words_written += count;
+    return ACS_OK;
+}
+
+void acs_transport_fake_init(acs_transport_t *transport, acs_fake_t *fake,
+                             uint8_t dev_addr)
+{
+    memset(fake, 0, sizeof(*fake));
+    fake->dev_addr = dev_addr;
+
+    transport->read       = fake_read;
+    transport->write      = fake_write;
+    transport->read_multi = NULL;
+    transport->ctx        = fake;
+}
+
+/* ----------------------------------------------------------------------- */
+/* Fake multi-device bus                                                    */
+/* ----------------------------------------------------------------------- */
+
+static acs_fake_t *fake_bus_route(acs_fake_bus_t *bus, uint8_t dev_addr)
+{
+    for (uint8_t i = 0; i < bus->count; i++)
+    {
+        if (bus->devices[i]->dev_addr == dev_addr)
+            return bus->devices[i];
+    }
+    return NULL;
+}
+
+static int fake_bus_read(void *ctx, uint8_t dev_addr, uint8_t reg_addr,
+                         uint32_t *words, uint8_t count)
+{
+    acs_fake_bus_t *bus = ctx;
+    acs_fake_t *fake = fake_bus_route(bus, dev_addr);
+
+    bus->transactions++;
+    if (fake == NULL)
+        return ACS_ERR_NAK;
+    return fake_read(fake, dev_addr, reg_addr, words, count);
+}
+
+static int fake_bus_write(void *ctx, uint8_t dev_addr, uint8_t reg_addr,
+                          const uint32_t *words, uint8_t count)
+{
+    acs_fake_bus_t *bus = ctx;
+    acs_fake_t *fake = fake_bus_route(bus, dev_addr);
+
+    bus->transactions++;
+    if (fake == NULL)
+        return ACS_ERR_NAK;
+    return fake_write(fake, dev_addr, reg_addr, words, count);
+}
+
+static int fake_bus_read_multi(void *ctx, acs_xfer_t *xfers, uint8_t count)
+{
+    acs_fake_bus_t *bus = ctx;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        acs_fake_t *fake = fake_bus_route(bus, xfers[i].dev_addr);
+        xfers[i].status = fake == NULL ? ACS_ERR_NAK
+                        : fake_read(fake, xfers[i].dev_addr, xfers[i].reg_addr,
+                                    xfers[i].words, xfers[i].count);
+    }
+
+    bus->transactions++;
+    return ACS_OK;
+}
+
+int acs_transport_fake_bus_init(acs_transport_t *transport, acs_fake_bus_t *bus,
+                                acs_fake_t *const *devices, uint8_t count)
+{
+    if (count > ACS_FAKE_BUS_MAX_DEVICES)
+        return ACS_ERR_PARAM;
+
+    memset(bus, 0, sizeof(*bus));
+    for (uint8_t i = 0; i < count; i++)
+        bus->devices[i] = devices[i];
+    bus->count = count;
+
+    transport->read       = fake_bus_read;
+    transport->write      = fake_bus_write;
+    transport->read_multi = fake_bus_read_multi;
+    transport->ctx        = bus;
+    return ACS_OK;
+}
\ No newline at end of file
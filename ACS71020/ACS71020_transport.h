@@ -0,0 +1,193 @@
+/**
+ * @file ACS71020_transport.h
+ * @author Usman Mehmood (usmanmehmood55@gmail.com)
+ * @brief Bus transport abstraction. I2C and SPI are both reduced to the same
+ * pair of function pointers that move blocks of consecutive 32-bit registers,
+ * so the rest of the library never needs to know which bus is in use.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _ACS71020_transport_H_
+#define _ACS71020_transport_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Return codes used by every function of the library. Zero is success,
+ * everything else is negative.
+ */
+typedef enum
+{
+    ACS_OK          =  0, // Success
+    ACS_ERR_PARAM   = -1, // Invalid argument
+    ACS_ERR_BUS     = -2, // Bus transfer failed
+    ACS_ERR_NAK     = -3, // Device did not acknowledge
+    ACS_ERR_LOCKED  = -4, // Register is write protected
+    ACS_ERR_RANGE   = -5, // Value out of range for the field
+    ACS_ERR_FULL    = -6, // Buffer or queue is full
+    ACS_ERR_EMPTY   = -7, // Buffer or queue is empty
+    ACS_ERR_BUSY    = -8, // Operation already in progress
+    ACS_ERR_ECC     = -9, // Uncorrectable EEPROM error
+    ACS_ERR_IO      = -10, // File read or write failed
+} acs_err_t;
+
+/**
+ * @brief Largest number of consecutive registers moved in one transaction.
+ * The measurement block 0x20 to 0x2D is 14 words, EEPROM 0x0B to 0x0F is 5.
+ */
+#define ACS_TRANSPORT_MAX_WORDS 16U
+
+/**
+ * @brief Reads count consecutive 32-bit registers starting at reg_addr from
+ * the device at dev_addr in a single bus transaction.
+ * @return ACS_OK or a negative acs_err_t
+ */
+typedef int (*acs_read_fn_t)(void *ctx, uint8_t dev_addr, uint8_t reg_addr,
+                             uint32_t *words, uint8_t count);
+
+/**
+ * @brief Writes count consecutive 32-bit registers starting at reg_addr to
+ * the device at dev_addr in a single bus transaction.
+ * @return ACS_OK or a negative acs_err_t
+ */
+typedef int (*acs_write_fn_t)(void *ctx, uint8_t dev_addr, uint8_t reg_addr,
+                              const uint32_t *words, uint8_t count);
+
+/**
+ * @brief One block read within a multi-device sweep. status is filled in by
+ * the transport.
+ */
+typedef struct
+{
+    uint8_t   dev_addr;
+    uint8_t   reg_addr;
+    uint8_t   count;
+    int       status;
+    uint32_t *words;
+} acs_xfer_t;
+
+/**
+ * @brief Optional. Performs several block reads, possibly on different
+ * devices, as one batch so the bus can run them back to back.
+ * @return ACS_OK if the batch was issued, per read results are in status
+ */
+typedef int (*acs_read_multi_fn_t)(void *ctx, acs_xfer_t *xfers, uint8_t count);
+
+/**
+ * @brief Register level transport. ctx is passed back untouched to all
+ * functions. read_multi may be NULL.
+ */
+typedef struct
+{
+    acs_read_fn_t       read;
+    acs_write_fn_t      write;
+    acs_read_multi_fn_t read_multi;
+    void               *ctx;
+} acs_transport_t;
+
+/**
+ * @brief Runs a batch of reads through read_multi, or one by one through read
+ * when the transport has no batch support.
+ * @return ACS_OK if the batch was issued, per read results are in status
+ */
+int acs_transport_read_multi(const acs_transport_t *transport, acs_xfer_t *xfers,
+                             uint8_t count);
+
+/**
+ * @brief Platform I2C primitive. Writes tx_len bytes to the 7-bit address
+ * addr, then, if rx_len is not zero, issues a repeated start and reads rx_len
+ * bytes into rx.
+ * @return ACS_OK or a negative acs_err_t
+ */
+typedef int (*acs_i2c_xfer_fn_t)(void *ctx, uint8_t addr,
+                                 const uint8_t *tx, size_t tx_len,
+                                 uint8_t *rx, size_t rx_len);
+
+/**
+ * @brief Platform SPI primitive. Full duplex transfer of len bytes with chip
+ * select held asserted for the whole transfer. rx may be NULL.
+ * @return ACS_OK or a negative acs_err_t
+ */
+typedef int (*acs_spi_xfer_fn_t)(void *ctx, const uint8_t *tx, uint8_t *rx,
+                                 size_t len);
+
+typedef struct
+{
+    acs_i2c_xfer_fn_t xfer;
+    void             *ctx;
+} acs_i2c_bus_t;
+
+typedef struct
+{
+    acs_spi_xfer_fn_t xfer;
+    void             *ctx;
+} acs_spi_bus_t;
+
+/**
+ * @brief Builds a transport on top of an I2C bus. A read is one address write
+ * followed by a repeated start and 4 * count data bytes, LSB first.
+ */
+void acs_transport_i2c_init(acs_transport_t *transport, acs_i2c_bus_t *bus);
+
+/**
+ * @brief Builds a transport on top of an SPI bus. The first byte carries the
+ * register address with bit 7 set for reads, followed by 4 * count data
+ * bytes, LSB first. dev_addr is ignored, chip select picks the device.
+ */
+void acs_transport_spi_init(acs_transport_t *transport, acs_spi_bus_t *bus);
+
+/**
+ * @brief In-memory register file standing in for a device, for use without
+ * hardware attached. Every call to read or write counts as one transaction.
+ * Apart from the access code in 0x2F setting customer_access in 0x30, all
+ * registers are plain memory.
+ */
+typedef struct
+{
+    uint32_t regs[256];
+    uint8_t  dev_addr;      // Only this address is acknowledged
+
+    uint32_t read_transactions;
+    uint32_t write_transactions;
+    uint32_t words_read;
+    uint32_t words_written;
+
+    int      fail_next;     // When not ACS_OK, returned once by the next call
+} acs_fake_t;
+
+/**
+ * @brief Clears the register file and counters of a fake device and builds a
+ * transport around it.
+ */
+void acs_transport_fake_init(acs_transport_t *transport, acs_fake_t *fake,
+                             uint8_t dev_addr);
+
+#define ACS_FAKE_BUS_MAX_DEVICES 16U
+
+/**
+ * @brief Several fake devices sharing one bus, routed by slave address. A
+ * read_multi batch counts as a single bus transaction.
+ */
+typedef struct
+{
+    acs_fake_t *devices[ACS_FAKE_BUS_MAX_DEVICES];
+    uint8_t     count;
+
+    uint32_t    transactions;
+} acs_fake_bus_t;
+
+/**
+ * @brief Builds a transport around a set of fake devices, each already
+ * initialized with acs_transport_fake_init() and its own address.
+ * @return ACS_OK, or ACS_ERR_PARAM for more than ACS_FAKE_BUS_MAX_DEVICES
+ */
+int acs_transport_fake_bus_init(acs_transport_t *transport, acs_fake_bus_t *bus,
+                                acs_fake_t *const *devices, uint8_t count);
+
+#endif // _ACS71020_transport_H_
\ No newline at end of file
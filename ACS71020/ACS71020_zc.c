@@ -0,0 +1,100 @@
+#include <string.h>
+#include "ACS71020_zc.h"
+
+#define DIO_0_SEL_VZC 0U
+
+// 0x20 to 0x29 are refreshed at the end of a window, 0x2A to 0x2D change on
+// every sample and say nothing about windows
+#define CYCLE_WORDS (0x29U - ACS_REG_MEAS_FIRST + 1U)
+
+void acs_zc_prepare_config(eeprom_0x0D_t *reg_0x0D, eeprom_0x0F_t *reg_0x0F,
+                           bool halfcycle_en, bool squarewave_en)
+{
+    reg_0x0D->eeprom_data = eeprom_0x0D_halfcycle_en_set(reg_0x0D->eeprom_data, halfcycle_en);
+    reg_0x0D->eeprom_data = eeprom_0x0D_squarewave_en_set(reg_0x0D->eeprom_data, squarewave_en);
+    reg_0x0F->eeprom_data = eeprom_0x0F_dio_0_sel_set(reg_0x0F->eeprom_data, DIO_0_SEL_VZC);
+}
+
+void acs_zc_init(acs_zc_t *zc, const acs_device_t *dev, bool halfcycle_en,
+                 bool squarewave_en, acs_zc_callback_t callback, void *user)
+{
+    memset(zc, 0, sizeof(*zc));
+    zc->dev        = dev;
+    zc->callback   = callback;
+    zc->user       = user;
+    zc->squarewave = squarewave_en;
+
+    // One rms window is a full line cycle, halfcycle_en reports two crossings
+    zc->edges_per_window = halfcycle_en ? 2U : 1U;
+}
+
+void acs_zc_on_edge(acs_zc_t *zc)
+{
+    uint8_t edges = zc->edges + 1U;
+
+    if (edges < zc->edges_per_window)
+    {
+        zc->edges = edges;
+        return;
+    }
+
+    zc->edges = 0U;
+    if (zc->pending)
+        zc->missed++;
+    zc->pending = true;
+}
+
+int acs_zc_service(acs_zc_t *zc)
+{
+    acs_snapshot_t snap;
+
+    if (!zc->pending)
+        return ACS_ERR_EMPTY;
+    zc->pending = false;
+
+    int ret = acs_read_snapshot(zc->dev, &snap);
+    if (ret != ACS_OK)
+    {
+        zc->bus_errors++;
+        return ret;
+    }
+
+    // A new window rewrites 0x20 to 0x29 including numptsout in 0x25, which
+    // stays 0 until the device has completed its first window
+    uint32_t points = acs_0x25_numptsout_get(snap.words[0x25U - ACS_REG_MEAS_FIRST]);
+    bool fresh = points != 0U &&
+                 memcmp(snap.words, zc->last.words, CYCLE_WORDS * sizeof(uint32_t)) != 0;
+    zc->reads++;
+    if (fresh)
+        zc->numptsout = (uint16_t)points;
+    else
+        zc->stale++;
+    zc->last = snap;
+
+    if (zc->callback != NULL)
+        zc->callback(zc->user, &snap, fresh);
+
+    return ACS_OK;
+}
+
+int acs_zc_poll(acs_zc_t *zc)
+{
+    uint32_t status;
+
+    int ret = acs_read_register(zc->dev, ACS_REG_MEAS_LAST, &status);
+    if (ret != ACS_OK)
+    {
+        zc->bus_errors++;
+        return ret;
+    }
+
+    uint8_t zc_now = (uint8_t)acs_0x2D_vzerocrossout_get(status);
+    bool edge = zc->squarewave ? (zc_now != zc->last_zc)
+                               : (zc_now != 0U && zc->last_zc == 0U);
+    zc->last_zc = zc_now;
+
+    if (edge)
+        acs_zc_on_edge(zc);
+
+    return acs_zc_service(zc);
+}
\ No newline at end of file
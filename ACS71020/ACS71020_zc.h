@@ -0,0 +1,91 @@
+/**
+ * @file ACS71020_zc.h
+ * @author Usman Mehmood (usmanmehmood55@gmail.com)
+ * @brief Zero-crossing synchronized acquisition. The rms, power and numptsout
+ * registers are refreshed once per line cycle, at a voltage zero crossing.
+ * Instead of polling on a fixed timer, a snapshot is read right after the
+ * crossing that completes a window, either signalled by an edge on DIO0
+ * (dio_0_sel = 0) or found by polling vzerocrossout in 0x2D.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _ACS71020_zc_H_
+#define _ACS71020_zc_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "ACS71020.h"
+
+/**
+ * @brief Called with every new snapshot. fresh is true when the read belongs
+ * to a newly completed window: numptsout in 0x25 is not zero and the
+ * per-window registers 0x20 to 0x29 differ from the previous read. The
+ * instantaneous registers 0x2A to 0x2D are not compared, they change on
+ * every sample. A window that exactly repeats the previous one cannot be
+ * told apart from a stale read and counts as stale.
+ */
+typedef void (*acs_zc_callback_t)(void *user, const acs_snapshot_t *snap, bool fresh);
+
+typedef struct
+{
+    const acs_device_t *dev;
+    acs_zc_callback_t   callback;
+    void               *user;
+
+    uint8_t             edges_per_window;   // Crossings that make up one rms window
+    volatile uint8_t    edges;              // Crossings seen in the current window
+    volatile bool       pending;            // A window completed, read not done yet
+    bool                squarewave;         // DIO0 toggles instead of pulsing
+    uint8_t             last_zc;            // Previous vzerocrossout, for polling
+
+    acs_snapshot_t      last;
+    uint32_t            reads;
+    uint16_t            numptsout;          // Samples in the window of the last fresh read
+    uint32_t            stale;              // Reads not belonging to a new window
+    uint32_t            missed;             // Windows completed while one was pending
+    uint32_t            bus_errors;
+} acs_zc_t;
+
+/**
+ * @brief Sets up DIO0 to report voltage zero crossings. With halfcycle_en
+ * both rising and falling crossings are reported, with squarewave_en the
+ * pin toggles instead of pulsing, which is what polling 0x2D needs to not
+ * miss the 32 or 256 us pulse.
+ */
+void acs_zc_prepare_config(eeprom_0x0D_t *reg_0x0D, eeprom_0x0F_t *reg_0x0F,
+                           bool halfcycle_en, bool squarewave_en);
+
+/**
+ * @brief halfcycle_en and squarewave_en must match the device configuration.
+ * In pulse mode the GPIO hook should fire on rising edges of DIO0 only, in
+ * square wave mode on both edges.
+ */
+void acs_zc_init(acs_zc_t *zc, const acs_device_t *dev, bool halfcycle_en,
+                 bool squarewave_en, acs_zc_callback_t callback, void *user);
+
+/**
+ * @brief GPIO edge hook for DIO0, safe to call from an ISR. It only counts the
+ * edge and marks a read as pending, the bus is not touched.
+ */
+void acs_zc_on_edge(acs_zc_t *zc);
+
+/**
+ * @brief Performs the pending read, if any, and calls the callback. Call it
+ * from the main loop or a worker thread.
+ * @return ACS_OK, ACS_ERR_EMPTY if nothing was pending, or a transport error
+ */
+int acs_zc_service(acs_zc_t *zc);
+
+/**
+ * @brief Polling alternative to DIO0. Reads 0x2D, feeds any change of
+ * vzerocrossout to acs_zc_on_edge() and services the result.
+ * @return as acs_zc_service()
+ */
+int acs_zc_poll(acs_zc_t *zc);
+
+#endif // _ACS71020_zc_H_
\ No newline at end of file
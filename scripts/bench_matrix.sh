@@ -0,0 +1,39 @@
+#!/bin/sh
+# Builds and runs src/benchmark.c once per compiler and optimization level,
+# library included so the flags apply to the decoders as well, and prints the
+# benchmark documents as one JSON array on stdout. Compilers that are not
+# installed are skipped with a note on stderr.
+#   scripts/bench_matrix.sh [build dir]
+# BENCH_CCS and BENCH_OPTS override the default "gcc clang" and "-O2 -O3 -Os".
+
+set -e
+cd "$(dirname "$0")/.."
+
+out=${1:-build/bench}
+ccs=${BENCH_CCS:-gcc clang}
+opts=${BENCH_OPTS:--O2 -O3 -Os}
+
+mkdir -p "$out"
+first=1
+ran=0
+
+printf '[\n'
+for cc in $ccs; do
+    if ! command -v "$cc" >/dev/null 2>&1; then
+        echo "bench_matrix: $cc not found, skipped" >&2
+        continue
+    fi
+    for opt in $opts; do
+        bin="$out/benchmark_$cc$opt"
+        echo "bench_matrix: $cc $opt" >&2
+        "$cc" -std=c11 "$opt" -DBENCH_FLAGS="\"$opt\"" -IACS71020 \
+            src/benchmark.c ACS71020/*.c -lm -lpthread -o "$bin"
+        [ $first -eq 1 ] || printf ',\n'
+        first=0
+        "$bin"
+        ran=$((ran + 1))
+    done
+done
+printf ']\n'
+
+[ $ran -gt 0 ]
@@ -0,0 +1,481 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include <string.h>
+#include <time.h>
+#include "ACS71020.h"
+#include "ACS71020_decode.h"
+#include "ACS71020_fixed.h"
+#include "ACS71020_harmonic.h"
+#include "ACS71020_log.h"
+#include "ACS71020_pack.h"
+
+/**
+ * Throughput benchmarks, printed as one JSON document on stdout. `make bench`
+ * runs it with the current compiler and flags, `make bench-matrix` builds it
+ * with GCC and Clang at -O2, -O3 and -Os through scripts/bench_matrix.sh and
+ * collects the documents in build/bench/results.json.
+ * Register decoding is measured per field, once through the bitfield unions
+ * and once through the shift/mask accessors of ACS71020_fields.h, plus the
+ * batch and snapshot decoders of ACS71020_decode.h, decoding straight out of
+ * a snapshot log, and the waveform codec of ACS71020_pack.h.
+ * The integer snapshot decoder of ACS71020_fixed.h is timed against the
+ * float one.
+ * Where there is a cycle counter, each result also has cycles_per_item
+ * counted by it: the TSC on x86, which ticks at the nominal clock whatever
+ * the core runs at, or DWT CYCCNT on Cortex-M3 and up. Elsewhere, defining
+ * BENCH_CPU_HZ to the core clock gives est_cycles_per_item instead, the
+ * wall time multiplied by that clock, which is only as good as the clock
+ * is steady.
+ */
+
+#ifndef BENCH_FLAGS
+#define BENCH_FLAGS "unknown"
+#endif
+
+#define BENCH_MIN_SECONDS 0.5
+#define DECODE_MIN_SECONDS 0.05
+#define DECODE_FRAMES 4096U
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <x86intrin.h>
+
+#define BENCH_CYCLE_COUNTER "tsc"
+
+static void cycles_init(void)
+{
+}
+
+static uint64_t read_cycles(void)
+{
+    return __rdtsc();
+}
+
+#elif defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+
+#define BENCH_CYCLE_COUNTER "dwt_cyccnt"
+
+#define DEMCR      (*(volatile uint32_t *)0xE000EDFCU)
+#define DWT_CTRL   (*(volatile uint32_t *)0xE0001000U)
+#define DWT_CYCCNT (*(volatile uint32_t *)0xE0001004U)
+
+static uint32_t cycles_last;
+static uint64_t cycles_total;
+
+static void cycles_init(void)
+{
+    DEMCR      |= 1U << 24;     // TRCENA
+    DWT_CYCCNT  = 0U;
+    DWT_CTRL   |= 1U;           // CYCCNTENA
+    cycles_last = 0U;
+}
+
+/**
+ * @brief CYCCNT is 32 bits wide. It is read at least once per pass, far
+ * more often than it wraps, so the differences add up to the full count.
+ */
+static uint64_t read_cycles(void)
+{
+    uint32_t now = DWT_CYCCNT;
+
+    cycles_total += (uint32_t)(now - cycles_last);
+    cycles_last   = now;
+    return cycles_total;
+}
+
+#else
+
+static void cycles_init(void)
+{
+}
+
+#endif
+
+typedef struct
+{
+    double   start_s;
+    double   seconds;
+#ifdef BENCH_CYCLE_COUNTER
+    uint64_t start_cycles;
+    uint64_t cycles;
+#endif
+} bench_timer_t;
+
+static volatile float sink;
+static bool first_result = true;
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static const char *cycle_counter_name(void)
+{
+#if defined(BENCH_CYCLE_COUNTER)
+    return BENCH_CYCLE_COUNTER;
+#elif defined(BENCH_CPU_HZ)
+    return "none, estimated from BENCH_CPU_HZ";
+#else
+    return "none";
+#endif
+}
+
+static void timer_start(bench_timer_t *t)
+{
+    t->start_s = now_seconds();
+    t->seconds = 0.0;
+#ifdef BENCH_CYCLE_COUNTER
+    t->start_cycles = read_cycles();
+    t->cycles       = 0U;
+#endif
+}
+
+/**
+ * @brief Seconds since timer_start(), also kept in the timer along with the
+ * cycles counted over the same span.
+ */
+static double timer_elapsed(bench_timer_t *t)
+{
+#ifdef BENCH_CYCLE_COUNTER
+    t->cycles = read_cycles() - t->start_cycles;
+#endif
+    t->seconds = now_seconds() - t->start_s;
+    return t->seconds;
+}
+
+static const char *compiler_name(void)
+{
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#else
+    return "unknown";
+#endif
+}
+
+static void print_result(const char *name, const char *unit, double items,
+                         const bench_timer_t *t, double realtime_rate)
+{
+    printf("%s\n    {\"name\": \"%s\", \"unit\": \"%s\", \"per_second\": %.1f",
+           first_result ? "" : ",", name, unit, items / t->seconds);
+    if (realtime_rate > 0.0)
+        printf(", \"realtime_factor\": %.2f", items / t->seconds / realtime_rate);
+#if defined(BENCH_CYCLE_COUNTER)
+    printf(", \"cycles_per_item\": %.1f", (double)t->cycles / items);
+#elif defined(BENCH_CPU_HZ)
+    printf(", \"est_cycles_per_item\": %.1f", (double)(BENCH_CPU_HZ) * t->seconds / items);
+#endif
+    printf("}");
+    first_result = false;
+}
+
+/* ----------------------------------------------------------------------- */
+/* Register decoding                                                        */
+/* ----------------------------------------------------------------------- */
+
+static uint32_t frames[DECODE_FRAMES];
+
+typedef uint32_t (*decode_kernel_t)(const uint32_t *words, size_t count);
+
+static void fill_frames(void)
+{
+    uint32_t x = 0x12345678U;
+
+    for (size_t i = 0; i < DECODE_FRAMES; i++)
+    {
+        // xorshift32, any bit pattern is a valid register word
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        frames[i] = x;
+    }
+}
+
+static void bench_kernel(const char *method, const char *reg, const char *field,
+                         decode_kernel_t kernel)
+{
+    char name[96];
+    uint64_t passes = 0;
+    uint32_t acc = 0;
+    bench_timer_t timer;
+    timer_start(&timer);
+    do
+    {
+        acc += kernel(frames, DECODE_FRAMES);
+        passes++;
+    } while (timer_elapsed(&timer) < DECODE_MIN_SECONDS);
+
+    sink = (float)acc;
+    snprintf(name, sizeof(name), "%s:%s.%s", method, reg, field);
+    print_result(name, "frames", (double)(passes * DECODE_FRAMES), &timer, 0.0);
+}
+
+/*
+ * Two kernels per field, generated from the register table: one reading the
+ * field through the union bitfield, one through the generated accessor. Both
+ * return the raw, unextended field so they do the same work.
+ */
+#define UNION_KERNEL(prefix, member, field)                                 \
+    static uint32_t union_##prefix##_##field(const uint32_t *words, size_t count) \
+    {                                                                       \
+        uint32_t acc = 0;                                                   \
+        for (size_t i = 0; i < count; i++)                                  \
+        {                                                                   \
+            prefix##_t reg;                                                 \
+            reg.member = words[i];                                          \
+            acc += reg.fields.field;                                        \
+        }                                                                   \
+        return acc;                                                         \
+    }
+
+#define SHIFT_KERNEL(prefix, field)                                         \
+    static uint32_t shift_##prefix##_##field(const uint32_t *words, size_t count) \
+    {                                                                       \
+        uint32_t acc = 0;                                                   \
+        for (size_t i = 0; i < count; i++)                                  \
+            acc += prefix##_##field##_get(words[i]);                        \
+        return acc;                                                         \
+    }
+
+#define VOLATILE_KERNELS(prefix, address, field, shift, width, is_signed) \
+    UNION_KERNEL(prefix, register_value, field) SHIFT_KERNEL(prefix, field)
+#define EEPROM_KERNELS(prefix, address, field, shift, width, is_signed) \
+    UNION_KERNEL(prefix, eeprom_data, field) SHIFT_KERNEL(prefix, field)
+
+ACS_VOLATILE_FIELDS(VOLATILE_KERNELS)
+ACS_EEPROM_FIELDS(EEPROM_KERNELS)
+
+#define RUN_KERNELS(prefix, address, field, shift, width, is_signed)           \
+    bench_kernel("union", #prefix, #field, union_##prefix##_##field);          \
+    bench_kernel("shift_mask", #prefix, #field, shift_##prefix##_##field);
+
+static void bench_fields(void)
+{
+    ACS_VOLATILE_FIELDS(RUN_KERNELS)
+    ACS_EEPROM_FIELDS(RUN_KERNELS)
+}
+
+/**
+ * @brief All nine engineering-unit fields of a frame, through the batch
+ * decoder and through the per snapshot decoder.
+ */
+static void bench_decoders(void)
+{
+    static float out[9][DECODE_FRAMES];
+    const acs_full_scale_t fs = { 30.0, 250.0, 7500.0 };
+    const acs_raw_batch_t raw =
+    {
+        (const acs_0x20_t *)frames, (const acs_0x21_t *)frames,
+        (const acs_0x22_t *)frames, (const acs_0x23_t *)frames,
+        (const acs_0x24_t *)frames, (const acs_0x2A_t *)frames,
+        (const acs_0x2B_t *)frames, (const acs_0x2C_t *)frames,
+    };
+    const acs_decoded_f32_t dec =
+    {
+        out[0], out[1], out[2], out[3], out[4], out[5], out[6], out[7], out[8],
+    };
+
+    uint64_t passes = 0;
+    bench_timer_t timer;
+    timer_start(&timer);
+    do
+    {
+        acs_decode_batch_f32(&raw, DECODE_FRAMES, &fs, &dec);
+        sink = out[0][passes % DECODE_FRAMES];
+        passes++;
+    } while (timer_elapsed(&timer) < DECODE_MIN_SECONDS);
+    print_result("batch_f32:measurements", "frames", (double)(passes * DECODE_FRAMES), &timer, 0.0);
+
+    const size_t snaps = DECODE_FRAMES / ACS_SNAPSHOT_WORDS;
+    const acs_snapshot_t *snap = (const acs_snapshot_t *)frames;
+    acs_measurement_t m;
+    passes = 0;
+    timer_start(&timer);
+    do
+    {
+        for (size_t i = 0; i < snaps; i++)
+        {
+            acs_decode_snapshot(&snap[i], &fs, &m);
+            sink = m.pinstant;
+        }
+        passes++;
+    } while (timer_elapsed(&timer) < DECODE_MIN_SECONDS);
+    print_result("snapshot:measurements", "frames", (double)(passes * snaps), &timer, 0.0);
+}
+
+/* ----------------------------------------------------------------------- */
+/* Integer decoding                                                         */
+/* ----------------------------------------------------------------------- */
+
+/**
+ * @brief Times the integer snapshot decoder. Its results are checked against
+ * the double precision path by test/test_fixed.c.
+ */
+static void bench_fixed(void)
+{
+    const size_t snaps = DECODE_FRAMES / ACS_SNAPSHOT_WORDS;
+    const acs_snapshot_t *snap = (const acs_snapshot_t *)frames;
+    acs_fixed_measurement_t m;
+    uint64_t passes = 0;
+    bench_timer_t timer;
+    timer_start(&timer);
+    do
+    {
+        for (size_t i = 0; i < snaps; i++)
+        {
+            acs_fixed_decode_snapshot(&snap[i], &m);
+            sink = (float)m.pinstant_mw;
+        }
+        passes++;
+    } while (timer_elapsed(&timer) < DECODE_MIN_SECONDS);
+    print_result("snapshot_fixed:measurements", "frames", (double)(passes * snaps), &timer, 0.0);
+}
+
+#define LOG_RECORDS 16384U
+
+/**
+ * @brief Walks an in-memory log the way a mapped file is walked, decoding
+ * every record.
+ */
+static void bench_log(void)
+{
+    static uint64_t image[(sizeof(acs_log_header_t) + LOG_RECORDS * sizeof(acs_log_record_t)) / 8U];
+    acs_log_header_t *h = (acs_log_header_t *)image;
+    acs_log_record_t *records = (acs_log_record_t *)(h + 1);
+    acs_log_reader_t reader;
+    acs_full_scale_t fs;
+    acs_measurement_t m;
+
+    memcpy(h->magic, ACS_LOG_MAGIC, sizeof(h->magic));
+    h->version            = ACS_LOG_VERSION;
+    h->header_size        = sizeof(acs_log_header_t);
+    h->record_size        = sizeof(acs_log_record_t);
+    h->byte_order         = ACS_LOG_BYTE_ORDER;
+    h->full_scale_current = 30.0;
+    h->full_scale_voltage = 250.0;
+    h->full_scale_power   = 7500.0;
+    for (size_t i = 0; i < LOG_RECORDS; i++)
+    {
+        records[i].timestamp_us = i * 100000U;
+        records[i].dev_addr     = (uint8_t)(96U + i % 15U);
+        memcpy(records[i].snap.words, &frames[(i * ACS_SNAPSHOT_WORDS) % (DECODE_FRAMES - ACS_SNAPSHOT_WORDS)],
+               sizeof(records[i].snap.words));
+    }
+
+    uint64_t passes = 0;
+    bench_timer_t timer;
+    timer_start(&timer);
+    do
+    {
+        acs_log_open_buffer(&reader, image, sizeof(image));
+        acs_log_full_scale(&reader, &fs);
+        for (size_t i = 0; i < reader.count; i++)
+        {
+            acs_decode_snapshot(&reader.records[i].snap, &fs, &m);
+            sink = m.pactive;
+        }
+        passes++;
+    } while (timer_elapsed(&timer) < DECODE_MIN_SECONDS);
+    print_result("log:records", "records", (double)(passes * LOG_RECORDS), &timer, 0.0);
+}
+
+#define PACK_VALUES (ACS_PACK_BLOCK * 256U)
+
+/**
+ * @brief Encodes and decodes a 17-bit, 50 Hz waveform sampled at 32 kHz.
+ */
+static void bench_pack(void)
+{
+    static int32_t wave[PACK_VALUES];
+    static uint8_t packed[PACK_VALUES / ACS_PACK_BLOCK * ACS_PACK_MAX_BLOCK_BYTES];
+    static uint32_t index[PACK_VALUES / ACS_PACK_BLOCK];
+    int32_t block[ACS_PACK_BLOCK];
+    acs_pack_stream_t stream;
+
+    for (size_t i = 0; i < PACK_VALUES; i++)
+        wave[i] = (int32_t)(60000.0 * sin(6.28318530718 * 50.0 * i / 32000.0)) + (int32_t)(frames[i % DECODE_FRAMES] & 0x3FU);
+
+    uint64_t passes = 0;
+    bench_timer_t timer;
+    timer_start(&timer);
+    do
+    {
+        acs_pack_stream_init(&stream, packed, sizeof(packed), index, PACK_VALUES / ACS_PACK_BLOCK);
+        acs_pack_stream_push(&stream, wave, PACK_VALUES);
+        passes++;
+    } while (timer_elapsed(&timer) < DECODE_MIN_SECONDS);
+    print_result("pack:encode", "values", (double)(passes * PACK_VALUES), &timer, 0.0);
+
+    passes = 0;
+    timer_start(&timer);
+    do
+    {
+        for (uint32_t b = 0; b < stream.blocks; b++)
+            acs_pack_stream_block(packed, stream.used, index, stream.blocks, b, block);
+        sink = (float)block[0];
+        passes++;
+    } while (timer_elapsed(&timer) < DECODE_MIN_SECONDS);
+    print_result("pack:decode", "values", (double)(passes * PACK_VALUES), &timer, 0.0);
+}
+
+/* ----------------------------------------------------------------------- */
+/* Harmonic analysis                                                        */
+/* ----------------------------------------------------------------------- */
+
+#define HARMONIC_MAX_SAMPLES 6400U  // 10 cycles of 50 Hz at 32 kHz
+
+static void bench_harmonic(const char *name, float sample_rate, uint16_t harmonics)
+{
+    static acs_sample_t samples[HARMONIC_MAX_SAMPLES];
+    acs_harmonic_t an;
+    acs_harmonic_result_t v, c;
+
+    uint32_t n = acs_harmonic_block_len(sample_rate, 50.0f, 10U);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        double t = 6.28318530718 * 50.0 * i / sample_rate;
+        samples[i].vcodes = (int32_t)(30000.0 * sin(t) + 1500.0 * sin(3.0 * t));
+        samples[i].icodes = (int32_t)(12000.0 * sin(t - 0.4) + 900.0 * sin(5.0 * t));
+        samples[i].seq    = i;
+    }
+    acs_harmonic_init(&an, sample_rate, 50.0f, harmonics, n);
+
+    uint64_t blocks = 0;
+    bench_timer_t timer;
+    timer_start(&timer);
+    do
+    {
+        acs_harmonic_analyze(&an, samples, n, &v, &c);
+        sink = v.thd + c.thd;
+        blocks++;
+    } while (timer_elapsed(&timer) < BENCH_MIN_SECONDS);
+
+    print_result(name, "samples", (double)(blocks * n), &timer, sample_rate);
+}
+
+int main(void)
+{
+    printf("{\n  \"compiler\": \"%s\",\n  \"flags\": \"%s\",\n  \"cycle_counter\": \"%s\",\n  \"results\": [",
+           compiler_name(), BENCH_FLAGS, cycle_counter_name());
+
+    cycles_init();
+    fill_frames();
+    bench_fields();
+    bench_decoders();
+    bench_fixed();
+    bench_log();
+    bench_pack();
+
+    bench_harmonic("harmonic_40_32khz", 32000.0f, 40U);
+    bench_harmonic("harmonic_40_4khz", 4000.0f, 40U);
+
+    printf("\n  ]\n}\n");
+    return 0;
+}
\ No newline at end of file
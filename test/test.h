@@ -0,0 +1,72 @@
+/**
+ * @file test.h
+ * @author Usman Mehmood (usmanmehmood55@gmail.com)
+ * @brief Minimal test harness. Every test/test_*.c file is one executable
+ * whose main() calls its cases and returns test_report(), so `make test`
+ * fails if any check failed. A failed check prints its location and moves
+ * on, so one run shows every failure.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef _ACS71020_test_H_
+#define _ACS71020_test_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+static unsigned test_checks;
+static unsigned test_failures;
+
+#define CHECK(cond)                                                         \
+    do                                                                      \
+    {                                                                       \
+        test_checks++;                                                      \
+        if (!(cond))                                                        \
+        {                                                                   \
+            test_failures++;                                                \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n",                    \
+                    __FILE__, __LINE__, #cond);                             \
+        }                                                                   \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                          \
+    do                                                                      \
+    {                                                                       \
+        long long a_ = (long long)(actual);                                 \
+        long long e_ = (long long)(expected);                               \
+        test_checks++;                                                      \
+        if (a_ != e_)                                                       \
+        {                                                                   \
+            test_failures++;                                                \
+            fprintf(stderr, "%s:%d: %s == %lld, expected %s == %lld\n",     \
+                    __FILE__, __LINE__, #actual, a_, #expected, e_);        \
+        }                                                                   \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                             \
+    do                                                                      \
+    {                                                                       \
+        double a_ = (double)(actual);                                       \
+        double e_ = (double)(expected);                                     \
+        test_checks++;                                                      \
+        if (!(a_ - e_ <= (tolerance) && e_ - a_ <= (tolerance)))            \
+        {                                                                   \
+            test_failures++;                                                \
+            fprintf(stderr, "%s:%d: %s == %g, expected %g +- %g\n",         \
+                    __FILE__, __LINE__, #actual, a_, e_, (double)(tolerance)); \
+        }                                                                   \
+    } while (0)
+
+#define RUN(test) test()
+
+static inline int test_report(const char *name)
+{
+    printf("%-28s %5u checks, %u failed\n", name, test_checks, test_failures);
+    return test_failures == 0U ? 0 : 1;
+}
+
+#endif // _ACS71020_test_H_
@@ -0,0 +1,280 @@
+#include <string.h>
+#include "ACS71020.h"
+#include "ACS71020_async.h"
+#include "ACS71020_shadow.h"
+#include "test.h"
+
+#define ADDR 0x60U
+
+typedef struct
+{
+    acs_transport_t transport;
+    acs_fake_t      fake;
+    acs_async_bus_t bus;
+    acs_async_sim_t sim;
+    acs_async_t     drv;
+    acs_async_op_t  op;
+
+    uint32_t        callbacks;
+    int             status;
+} rig_t;
+
+static void on_done(void *user, acs_async_op_t *op, int status)
+{
+    rig_t *rig = user;
+
+    rig->callbacks++;
+    rig->status = status;
+    CHECK(op == &rig->op);
+    CHECK(!acs_async_busy(&rig->drv));
+}
+
+static void rig_init(rig_t *rig)
+{
+    memset(rig, 0, sizeof(*rig));
+    acs_transport_fake_init(&rig->transport, &rig->fake, ADDR);
+    acs_async_bus_sim_init(&rig->bus, &rig->sim, &rig->transport, &rig->drv);
+    acs_async_init(&rig->drv, &rig->bus, ADDR);
+
+    for (uint8_t i = 0; i < ACS_SNAPSHOT_WORDS; i++)
+        rig->fake.regs[ACS_REG_MEAS_FIRST + i] = 0x10101010U * (i + 1U);
+}
+
+/**
+ * @brief Fires transfers until the operation ends, as the interrupt would.
+ */
+static uint32_t run(rig_t *rig)
+{
+    uint32_t fired = 0U;
+
+    while (acs_async_sim_fire(&rig->sim))
+        fired++;
+    return fired;
+}
+
+static void test_snapshot_read(void)
+{
+    static rig_t rig;
+    acs_snapshot_t snap;
+
+    rig_init(&rig);
+    CHECK_EQ(acs_async_read_snapshot(&rig.drv, &rig.op, &snap, on_done, &rig), ACS_OK);
+    CHECK(acs_async_busy(&rig.drv));
+    CHECK_EQ(rig.callbacks, 0);
+    CHECK_EQ(rig.fake.read_transactions, 0);    // Only started
+
+    CHECK_EQ(run(&rig), 1);
+    CHECK_EQ(rig.callbacks, 1);
+    CHECK_EQ(rig.status, ACS_OK);
+    CHECK_EQ(rig.op.status, ACS_OK);
+    CHECK_EQ(rig.fake.read_transactions, 1);
+    CHECK(memcmp(snap.words, &rig.fake.regs[ACS_REG_MEAS_FIRST], sizeof(snap.words)) == 0);
+    CHECK_EQ(rig.drv.completed, 1);
+
+    // Nothing in flight
+    acs_async_complete(&rig.drv, ACS_OK);
+    CHECK_EQ(rig.drv.spurious, 1);
+    CHECK_EQ(rig.callbacks, 1);
+
+    CHECK_EQ(acs_async_read_snapshot(&rig.drv, &rig.op, NULL, on_done, &rig), ACS_ERR_PARAM);
+}
+
+/**
+ * @brief Three words with junk in their low bits go out framed exactly as
+ * acs_shadow_flush() frames them, after one unlock.
+ */
+static void test_eeprom_write_matches_shadow_flush(void)
+{
+    static rig_t rig;
+    static const uint32_t words[3] = { 0x12345678U, 0xFFFFFFFFU, 0x8000003FU };
+
+    rig_init(&rig);
+    CHECK_EQ(acs_async_write_eeprom(&rig.drv, &rig.op, 0x0CU, words, 3U, on_done, &rig), ACS_OK);
+    CHECK_EQ(run(&rig), 2 + 3);     // Unlock, check 0x30, one write per word
+    CHECK_EQ(rig.callbacks, 1);
+    CHECK_EQ(rig.status, ACS_OK);
+    CHECK_EQ(rig.fake.regs[ACS_REG_ACCESS_CODE], ACS_CUSTOMER_CODE);
+
+    // The same words through the blocking path
+    acs_transport_t transport;
+    acs_fake_t fake;
+    acs_device_t dev;
+    acs_shadow_t shadow;
+
+    acs_transport_fake_init(&transport, &fake, ADDR);
+    acs_device_init(&dev, &transport, ADDR);
+    acs_shadow_init(&shadow, &dev);
+    CHECK_EQ(acs_shadow_load(&shadow), ACS_OK);
+    for (uint8_t i = 0; i < 3U; i++)
+        CHECK_EQ(acs_shadow_write(&shadow, (uint8_t)(0x0CU + i), words[i]), ACS_OK);
+    CHECK_EQ(acs_shadow_flush(&shadow), ACS_OK);
+
+    for (uint8_t r = ACS_REG_EEPROM_FIRST; r <= ACS_REG_EEPROM_LAST; r++)
+        CHECK_EQ(rig.fake.regs[r], fake.regs[r]);
+    CHECK_EQ(rig.fake.regs[0x0C], 0x12345640U);
+    CHECK_EQ(rig.fake.regs[0x0E], 0x80000000U);
+    CHECK_EQ(rig.fake.regs[0x0B], 0);
+    CHECK_EQ(rig.fake.regs[0x0F], 0);
+
+    CHECK_EQ(acs_async_write_eeprom(&rig.drv, &rig.op, 0x0EU, words, 3U, on_done, &rig),
+             ACS_ERR_PARAM);
+    CHECK_EQ(acs_async_write_eeprom(&rig.drv, &rig.op, 0x0AU, words, 1U, on_done, &rig),
+             ACS_ERR_PARAM);
+}
+
+static void test_eeprom_write_locked(void)
+{
+    static rig_t rig;
+    static const uint32_t word = 0x12345640U;
+
+    rig_init(&rig);
+    CHECK_EQ(acs_async_write_eeprom(&rig.drv, &rig.op, 0x0BU, &word, 1U, on_done, &rig), ACS_OK);
+
+    // The access code is taken, but 0x30 reads back 0
+    CHECK(acs_async_sim_fire(&rig.sim));
+    CHECK_EQ(atomic_load(&rig.drv.state), ACS_ASYNC_CHECK_ACCESS);
+    rig.fake.regs[ACS_REG_CUSTOMER_ACCESS] = 0U;
+
+    CHECK_EQ(run(&rig), 1);
+    CHECK_EQ(rig.callbacks, 1);
+    CHECK_EQ(rig.status, ACS_ERR_LOCKED);
+    CHECK_EQ(rig.drv.errors, 1);
+    CHECK_EQ(rig.fake.regs[0x0B], 0);
+}
+
+static void test_fail_next(void)
+{
+    static rig_t rig;
+    static const uint32_t words[2] = { 0x11111140U, 0x22222240U };
+    acs_snapshot_t snap;
+
+    rig_init(&rig);
+
+    rig.sim.fail_next = ACS_ERR_NAK;
+    CHECK_EQ(acs_async_read_snapshot(&rig.drv, &rig.op, &snap, on_done, &rig), ACS_OK);
+    CHECK_EQ(run(&rig), 1);
+    CHECK_EQ(rig.status, ACS_ERR_NAK);
+    CHECK_EQ(rig.fake.read_transactions, 0);
+
+    // Failing the second word stops the operation there
+    CHECK_EQ(acs_async_write_eeprom(&rig.drv, &rig.op, 0x0BU, words, 2U, on_done, &rig), ACS_OK);
+    for (uint8_t i = 0; i < 3U; i++)
+        CHECK(acs_async_sim_fire(&rig.sim));
+    rig.sim.fail_next = ACS_ERR_BUS;
+    CHECK_EQ(run(&rig), 1);
+    CHECK_EQ(rig.callbacks, 2);
+    CHECK_EQ(rig.status, ACS_ERR_BUS);
+    CHECK_EQ(rig.fake.regs[0x0B], words[0]);
+    CHECK_EQ(rig.fake.regs[0x0C], 0);
+    CHECK_EQ(rig.drv.errors, 2);
+
+    // The next operation runs normally
+    CHECK_EQ(acs_async_read_snapshot(&rig.drv, &rig.op, &snap, on_done, &rig), ACS_OK);
+    CHECK_EQ(run(&rig), 1);
+    CHECK_EQ(rig.status, ACS_OK);
+    CHECK_EQ(snap.words[0], rig.fake.regs[ACS_REG_MEAS_FIRST]);
+}
+
+static void test_second_submit_is_busy(void)
+{
+    static rig_t rig;
+    static const uint32_t word = 0x12345640U;
+    acs_snapshot_t snap;
+    acs_async_op_t other;
+
+    rig_init(&rig);
+    CHECK_EQ(acs_async_read_snapshot(&rig.drv, &rig.op, &snap, on_done, &rig), ACS_OK);
+    CHECK_EQ(acs_async_read_snapshot(&rig.drv, &other, &snap, on_done, &rig), ACS_ERR_BUSY);
+    CHECK_EQ(acs_async_write_eeprom(&rig.drv, &other, 0x0BU, &word, 1U, on_done, &rig),
+             ACS_ERR_BUSY);
+
+    CHECK_EQ(run(&rig), 1);
+    CHECK_EQ(rig.callbacks, 1);
+    CHECK_EQ(rig.status, ACS_OK);
+
+    // Idle again
+    CHECK_EQ(acs_async_read_snapshot(&rig.drv, &rig.op, &snap, on_done, &rig), ACS_OK);
+    CHECK_EQ(run(&rig), 1);
+    CHECK_EQ(rig.callbacks, 2);
+}
+
+static rig_t *started_rig;
+static uint32_t started_unpublished;
+static acs_async_start_read_fn_t sim_start_read;
+static acs_async_start_write_fn_t sim_start_write;
+
+/**
+ * @brief Counts transfers started while a completion could not yet have
+ * found their operation.
+ */
+static void check_published(void)
+{
+    acs_async_t *drv = &started_rig->drv;
+
+    if (drv->op == NULL || atomic_load(&drv->state) == ACS_ASYNC_CLAIMED)
+        started_unpublished++;
+}
+
+static int checked_start_read(void *ctx, uint8_t dev_addr, uint8_t reg_addr,
+                              uint32_t *words, uint8_t count)
+{
+    check_published();
+    return sim_start_read(ctx, dev_addr, reg_addr, words, count);
+}
+
+static int checked_start_write(void *ctx, uint8_t dev_addr, uint8_t reg_addr,
+                               const uint32_t *words, uint8_t count)
+{
+    check_published();
+    return sim_start_write(ctx, dev_addr, reg_addr, words, count);
+}
+
+/**
+ * @brief A completion that arrives after a submit claimed the driver but
+ * before it set up the operation, as a stray interrupt would, is spurious.
+ * Every transfer starts with its operation in place.
+ */
+static void test_stray_completion_while_claimed(void)
+{
+    static rig_t rig;
+    static const uint32_t word = 0x12345640U;
+    acs_snapshot_t snap;
+
+    rig_init(&rig);
+    started_rig     = &rig;
+    sim_start_read  = rig.bus.start_read;
+    sim_start_write = rig.bus.start_write;
+    rig.bus.start_read  = checked_start_read;
+    rig.bus.start_write = checked_start_write;
+
+    // Stopped between the claim and the operation, with op still unset
+    atomic_store(&rig.drv.state, ACS_ASYNC_CLAIMED);
+    CHECK(acs_async_busy(&rig.drv));
+    acs_async_complete(&rig.drv, ACS_OK);
+    CHECK_EQ(rig.drv.spurious, 1);
+    CHECK_EQ(rig.drv.completed + rig.drv.errors, 0);
+    CHECK_EQ(rig.callbacks, 0);
+    CHECK(rig.drv.op == NULL);
+    CHECK_EQ(acs_async_read_snapshot(&rig.drv, &rig.op, &snap, on_done, &rig), ACS_ERR_BUSY);
+    atomic_store(&rig.drv.state, ACS_ASYNC_IDLE);
+
+    CHECK_EQ(acs_async_read_snapshot(&rig.drv, &rig.op, &snap, on_done, &rig), ACS_OK);
+    CHECK_EQ(run(&rig), 1);
+    CHECK_EQ(acs_async_write_eeprom(&rig.drv, &rig.op, 0x0BU, &word, 1U, on_done, &rig), ACS_OK);
+    CHECK_EQ(run(&rig), 3);
+    CHECK_EQ(rig.callbacks, 2);
+    CHECK_EQ(rig.status, ACS_OK);
+    CHECK_EQ(rig.sim.transfers, 4);
+    CHECK_EQ(started_unpublished, 0);
+}
+
+int main(void)
+{
+    RUN(test_snapshot_read);
+    RUN(test_eeprom_write_matches_shadow_flush);
+    RUN(test_eeprom_write_locked);
+    RUN(test_fail_next);
+    RUN(test_second_submit_is_busy);
+    RUN(test_stray_completion_while_claimed);
+    return test_report("async");
+}
@@ -0,0 +1,236 @@
+#include <math.h>
+#include "ACS71020.h"
+#include "ACS71020_calib.h"
+#include "ACS71020_sim.h"
+#include "test.h"
+
+#define SAMPLES   32U
+#define READINGS  10U
+#define ICODES    32768.0
+#define PACTIVE   32768.0
+
+typedef struct
+{
+    acs_transport_t transport;
+    acs_sim_t       sim;
+    acs_device_t    dev;
+    acs_shadow_t    shadow;
+
+    int32_t         codes[3][SAMPLES];
+} rig_t;
+
+/**
+ * @brief A sensor with the given untrimmed errors, a DC current and the
+ * default voltage so the line cycles keep the power registers updated.
+ */
+static void rig_init(rig_t *rig, float gain_error, float offset, float power_offset)
+{
+    acs_sim_config_t config;
+
+    acs_sim_default_config(&config);
+    config.current.amplitude  = 0.0f;
+    config.current_gain_error = gain_error;
+    config.current_offset     = offset;
+    config.power_offset       = power_offset;
+    acs_sim_init(&rig->sim, &config);
+    acs_transport_sim_init(&rig->transport, &rig->sim);
+    acs_device_init(&rig->dev, &rig->transport, config.dev_addr);
+    acs_shadow_init(&rig->shadow, &rig->dev);
+}
+
+/**
+ * @brief SAMPLES icodes at a DC current of reference, as a point.
+ */
+static acs_calib_point_t measure_current(rig_t *rig, float reference, int32_t *codes)
+{
+    rig->sim.config.current.dc = reference;
+    for (uint32_t n = 0; n < SAMPLES; n++)
+    {
+        acs_sim_advance(&rig->sim, 31250U);
+        codes[n] = acs_0x2B_icodes_sget(rig->sim.regs[0x2B]);
+    }
+    return (acs_calib_point_t){ reference, codes, SAMPLES };
+}
+
+/**
+ * @brief READINGS pactive values at zero load, one per line cycle.
+ */
+static acs_calib_point_t measure_power(rig_t *rig, int32_t *codes)
+{
+    rig->sim.config.current.dc = 0.0f;
+    acs_sim_advance(&rig->sim, 40000000U);
+    for (uint32_t n = 0; n < READINGS; n++)
+    {
+        acs_sim_advance(&rig->sim, 20000000U);
+        codes[n] = acs_0x21_pactive_sget(rig->sim.regs[0x21]);
+    }
+    return (acs_calib_point_t){ 0.0f, codes, READINGS };
+}
+
+static double mean(const int32_t *codes, uint32_t count)
+{
+    double sum = 0.0;
+
+    for (uint32_t n = 0; n < count; n++)
+        sum += codes[n];
+    return sum / count;
+}
+
+/**
+ * @brief Solve from simulator points, write the trims through the shadow and
+ * measure again. What is left is the rounding of the trims.
+ */
+static void test_solve_apply_remeasure(void)
+{
+    static rig_t rig;
+    acs_calib_point_t current[3];
+    acs_calib_point_t power;
+    int32_t pcodes[READINGS];
+    acs_calib_result_t result;
+
+    rig_init(&rig, 0.07f, 0.01f, 0.002f);
+    current[0] = measure_current(&rig, -0.5f, rig.codes[0]);
+    current[1] = measure_current(&rig, 0.0f, rig.codes[1]);
+    current[2] = measure_current(&rig, 0.5f, rig.codes[2]);
+    power      = measure_power(&rig, pcodes);
+
+    CHECK_EQ(acs_calib_solve(rig.sim.regs[0x0B], rig.sim.regs[0x0D], current, 3U,
+                             &power, 1U, &result), ACS_OK);
+    CHECK_EQ(result.crs_sns, 0);
+    CHECK_NEAR(result.sns_fine, (1.0 / 1.07 - 1.0) * 512.0, 0.5);
+    CHECK_NEAR(result.qvo_fine, -0.01 * ICODES / 64.0, 0.5);
+    CHECK_NEAR(result.pacc_trim, -0.002 * PACTIVE / 6.0, 0.5);
+
+    // Within half a trim step of exact
+    CHECK(fabsf(result.gain_error) <= 0.5f / 512.0f * 1.07f);
+    CHECK(fabsf(result.offset_error) <= 32.0f);
+
+    CHECK_EQ(acs_calib_apply(&result, &rig.shadow), ACS_OK);
+    CHECK_EQ(eeprom_0x0B_sns_fine_sget(rig.sim.regs[0x0B]), result.sns_fine);
+    CHECK_EQ(eeprom_0x0B_qvo_fine_sget(rig.sim.regs[0x0B]), result.qvo_fine);
+    CHECK_EQ(eeprom_0x0D_pacc_trim_sget(rig.sim.regs[0x0D]), result.pacc_trim);
+
+    // The measured residuals are the predicted ones, and within 0.1 % of
+    // full scale
+    double lo = mean(measure_current(&rig, -0.5f, rig.codes[0]).codes, SAMPLES);
+    double hi = mean(measure_current(&rig, 0.5f, rig.codes[2]).codes, SAMPLES);
+    double zero = mean(measure_current(&rig, 0.0f, rig.codes[1]).codes, SAMPLES);
+    CHECK_NEAR((hi - lo) / ICODES - 1.0, result.gain_error, 1e-4);
+    CHECK_NEAR(zero, result.offset_error, 1.0);
+    CHECK_NEAR(hi, 0.5 * ICODES, 1e-3 * ICODES);
+    CHECK_NEAR(lo, -0.5 * ICODES, 1e-3 * ICODES);
+
+    CHECK_NEAR(mean(measure_power(&rig, pcodes).codes, READINGS), 0.0, 3.0);
+
+    // Solving again from the trimmed device keeps the trims
+    acs_calib_result_t again;
+    current[0] = measure_current(&rig, -0.5f, rig.codes[0]);
+    current[1] = measure_current(&rig, 0.0f, rig.codes[1]);
+    current[2] = measure_current(&rig, 0.5f, rig.codes[2]);
+    CHECK_EQ(acs_calib_solve(rig.sim.regs[0x0B], rig.sim.regs[0x0D], current, 3U,
+                             NULL, 0U, &again), ACS_OK);
+    CHECK_EQ(again.sns_fine, result.sns_fine);
+    CHECK_EQ(again.qvo_fine, result.qvo_fine);
+    CHECK_EQ(again.pacc_trim, result.pacc_trim);
+
+    uint32_t writes = rig.sim.eeprom_writes[0];
+    CHECK_EQ(acs_calib_apply(&again, &rig.shadow), ACS_OK);
+    CHECK_EQ(rig.sim.eeprom_writes[0], writes);
+}
+
+/**
+ * @brief A single zero-load power point moves pacc_trim from the trim in
+ * effect, and leaves the current trims alone.
+ */
+static void test_power_point_moves_pacc_trim(void)
+{
+    static rig_t rig;
+    acs_calib_point_t current[2];
+    acs_calib_point_t power;
+    int32_t pcodes[READINGS];
+    acs_calib_result_t result;
+
+    rig_init(&rig, 0.0f, 0.0f, -0.004f);
+    rig.sim.regs[0x0D] = eeprom_0x0D_pacc_trim_set(0U, 3U);
+
+    current[0] = measure_current(&rig, -0.25f, rig.codes[0]);
+    current[1] = measure_current(&rig, 0.25f, rig.codes[1]);
+    power      = measure_power(&rig, pcodes);
+    CHECK_NEAR(mean(pcodes, READINGS), -0.004 * PACTIVE + 18.0, 1.0);
+
+    CHECK_EQ(acs_calib_solve(rig.sim.regs[0x0B], rig.sim.regs[0x0D], current, 2U,
+                             &power, 1U, &result), ACS_OK);
+    CHECK_EQ(result.crs_sns, 0);
+    CHECK_EQ(result.sns_fine, 0);
+    CHECK_EQ(result.qvo_fine, 0);
+    CHECK_EQ(result.pacc_trim, 22);     // 3 + 131 / 6 rounded
+
+    CHECK_EQ(acs_calib_apply(&result, &rig.shadow), ACS_OK);
+    CHECK_EQ(rig.sim.eeprom_writes[0], 0);
+    CHECK_EQ(eeprom_0x0D_pacc_trim_sget(rig.sim.regs[0x0D]), 22);
+    CHECK_NEAR(mean(measure_power(&rig, pcodes).codes, READINGS), 0.0, 3.0);
+
+    // Without power points the trim in effect is kept
+    CHECK_EQ(acs_calib_solve(rig.sim.regs[0x0B], rig.sim.regs[0x0D], current, 2U,
+                             NULL, 0U, &result), ACS_OK);
+    CHECK_EQ(result.pacc_trim, 22);
+}
+
+/**
+ * @brief Sensors the trims cannot correct report ACS_ERR_RANGE, with the
+ * nearest trims in the result where there are any.
+ */
+static void test_range(void)
+{
+    static rig_t rig;
+    acs_calib_point_t current[2];
+    acs_calib_point_t power;
+    int32_t pcodes[READINGS];
+    acs_calib_result_t result;
+
+    // Offset beyond 256 qvo_fine steps of 64 icodes
+    rig_init(&rig, 0.0f, 0.6f, 0.0f);
+    current[0] = measure_current(&rig, -0.2f, rig.codes[0]);
+    current[1] = measure_current(&rig, 0.2f, rig.codes[1]);
+    CHECK_EQ(acs_calib_solve(0U, 0U, current, 2U, NULL, 0U, &result), ACS_ERR_RANGE);
+    CHECK_EQ(result.qvo_fine, -256);
+    CHECK_EQ(result.sns_fine, 0);
+
+    // Power offset beyond 64 pacc_trim steps of 6 codes
+    rig_init(&rig, 0.0f, 0.0f, 0.05f);
+    current[0] = measure_current(&rig, -0.2f, rig.codes[0]);
+    current[1] = measure_current(&rig, 0.2f, rig.codes[1]);
+    power      = measure_power(&rig, pcodes);
+    CHECK_EQ(acs_calib_solve(0U, rig.sim.regs[0x0D], current, 2U, &power, 1U, &result),
+             ACS_ERR_RANGE);
+    CHECK_EQ(result.pacc_trim, -64);
+    CHECK_EQ(result.qvo_fine, 0);
+
+    // Gain so low no coarse step reaches full scale
+    rig_init(&rig, -0.95f, 0.0f, 0.0f);
+    current[0] = measure_current(&rig, -0.5f, rig.codes[0]);
+    current[1] = measure_current(&rig, 0.5f, rig.codes[1]);
+    CHECK_EQ(acs_calib_solve(0U, 0U, current, 2U, NULL, 0U, &result), ACS_ERR_RANGE);
+
+    // Inverted sensor, references swapped
+    rig_init(&rig, 0.0f, 0.0f, 0.0f);
+    current[0] = measure_current(&rig, -0.5f, rig.codes[0]);
+    current[1] = measure_current(&rig, 0.5f, rig.codes[1]);
+    current[0].reference = 0.5f;
+    current[1].reference = -0.5f;
+    CHECK_EQ(acs_calib_solve(0U, 0U, current, 2U, NULL, 0U, &result), ACS_ERR_RANGE);
+
+    // Not enough to fit
+    current[1].reference = 0.5f;
+    CHECK_EQ(acs_calib_solve(0U, 0U, current, 2U, NULL, 0U, &result), ACS_ERR_PARAM);
+    CHECK_EQ(acs_calib_solve(0U, 0U, current, 1U, NULL, 0U, &result), ACS_ERR_PARAM);
+    CHECK_EQ(acs_calib_solve(0U, 0U, current, 2U, &power, 0U, &result), ACS_ERR_PARAM);
+}
+
+int main(void)
+{
+    RUN(test_solve_apply_remeasure);
+    RUN(test_power_point_moves_pacc_trim);
+    RUN(test_range);
+    return test_report("calib");
+}
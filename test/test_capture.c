@@ -0,0 +1,86 @@
+#include "ACS71020.h"
+#include "ACS71020_capture.h"
+#include "test.h"
+
+#define ADDR 0x60U
+
+static void test_ring_wraps_and_counts_overruns(void)
+{
+    acs_sample_t storage[4], out[8];
+    acs_ring_t ring;
+
+    CHECK_EQ(acs_ring_init(&ring, storage, 3U), ACS_ERR_PARAM);
+    CHECK_EQ(acs_ring_init(&ring, storage, 4U), ACS_OK);
+
+    for (uint32_t round = 0; round < 3U; round++)
+    {
+        for (uint32_t i = 0; i < 5U; i++)
+        {
+            acs_sample_t s = { (int32_t)i, -(int32_t)i, round * 10U + i };
+            CHECK_EQ(acs_ring_push(&ring, &s), i < 4U ? ACS_OK : ACS_ERR_FULL);
+        }
+        CHECK_EQ(acs_ring_count(&ring), 4);
+        CHECK_EQ(acs_ring_pop(&ring, out, 8U), 4);
+        CHECK_EQ(out[0].seq, round * 10U);
+        CHECK_EQ(out[3].icodes, -3);
+    }
+    CHECK_EQ(atomic_load(&ring.overruns), 3);
+    CHECK_EQ(acs_ring_pop(&ring, out, 8U), 0);
+}
+
+static void test_step_reads_sign_extended_pair(void)
+{
+    acs_transport_t transport;
+    acs_fake_t fake;
+    acs_device_t dev;
+    acs_sample_t storage[4], out[4];
+    acs_ring_t ring;
+    acs_capture_t cap;
+
+    acs_transport_fake_init(&transport, &fake, ADDR);
+    acs_device_init(&dev, &transport, ADDR);
+    acs_ring_init(&ring, storage, 4U);
+    acs_capture_init(&cap, &dev, &ring);
+
+    fake.regs[ACS_REG_VCODES]      = 0x1FFFFU;  // -1
+    fake.regs[ACS_REG_VCODES + 1U] = 0x0FFFFU;  // 65535
+
+    CHECK_EQ(acs_capture_step(&cap), ACS_OK);
+    CHECK_EQ(fake.read_transactions, 1);
+    CHECK_EQ(acs_ring_pop(&ring, out, 4U), 1);
+    CHECK_EQ(out[0].vcodes, -1);
+    CHECK_EQ(out[0].icodes, 65535);
+}
+
+static void test_bus_errors_leave_seq_gaps(void)
+{
+    acs_transport_t transport;
+    acs_fake_t fake;
+    acs_device_t dev;
+    acs_sample_t storage[8], out[8];
+    acs_ring_t ring;
+    acs_capture_t cap;
+
+    acs_transport_fake_init(&transport, &fake, ADDR);
+    acs_device_init(&dev, &transport, ADDR);
+    acs_ring_init(&ring, storage, 8U);
+    acs_capture_init(&cap, &dev, &ring);
+
+    CHECK_EQ(acs_capture_step(&cap), ACS_OK);
+    fake.fail_next = ACS_ERR_BUS;
+    CHECK_EQ(acs_capture_step(&cap), ACS_ERR_BUS);
+    CHECK_EQ(acs_capture_step(&cap), ACS_OK);
+
+    CHECK_EQ(atomic_load(&cap.bus_errors), 1);
+    CHECK_EQ(acs_ring_pop(&ring, out, 8U), 2);
+    CHECK_EQ(out[0].seq, 0);
+    CHECK_EQ(out[1].seq, 2);
+}
+
+int main(void)
+{
+    RUN(test_ring_wraps_and_counts_overruns);
+    RUN(test_step_reads_sign_extended_pair);
+    RUN(test_bus_errors_leave_seq_gaps);
+    return test_report("capture");
+}
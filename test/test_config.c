@@ -0,0 +1,149 @@
+#include "ACS71020.h"
+#include "ACS71020_ecc.h"
+#include "ACS71020_config.h"
+#include "ACS71020_sim.h"
+#include "test.h"
+
+#define WORD(address) ((address) - ACS_REG_EEPROM_FIRST)
+
+typedef struct
+{
+    acs_transport_t transport;
+    acs_sim_t       sim;
+    acs_device_t    dev;
+    acs_shadow_t    shadow;
+} rig_t;
+
+static void rig_init(rig_t *rig)
+{
+    acs_sim_config_t config;
+
+    acs_sim_default_config(&config);
+    acs_sim_init(&rig->sim, &config);
+    acs_transport_sim_init(&rig->transport, &rig->sim);
+    acs_device_init(&rig->dev, &rig->transport, config.dev_addr);
+    acs_shadow_init(&rig->shadow, &rig->dev);
+
+    rig->sim.regs[0x0B] = eeprom_0x0B_sns_fine_set(eeprom_0x0B_qvo_fine_set(0U, 0x1F3U), 0x021U);
+    rig->sim.regs[0x0D] = eeprom_0x0D_fault_set(eeprom_0x0D_chan_del_sel_set(0U, 3U), 0xC8U);
+}
+
+static void test_validate(void)
+{
+    acs_config_t config;
+    const char *bad = NULL;
+
+    acs_config_init(&config);
+    acs_config_set_pacc_trim(&config, -64);
+    acs_config_set_fault(&config, 255);
+    CHECK_EQ(acs_config_validate(&config, &bad), ACS_OK);
+
+    acs_config_set_pacc_trim(&config, -65);
+    CHECK_EQ(acs_config_validate(&config, &bad), ACS_ERR_RANGE);
+    CHECK(bad != NULL && bad[0] == 'p');
+
+    acs_config_init(&config);
+    acs_config_set_i2c_slv_addr(&config, 111);
+    CHECK_EQ(acs_config_validate(&config, NULL), ACS_ERR_RANGE);
+}
+
+static void test_apply_writes_changed_words(void)
+{
+    static rig_t rig;
+    acs_config_t config;
+    acs_config_result_t result;
+
+    rig_init(&rig);
+    acs_config_init(&config);
+    acs_config_set_pacc_trim(&config, -2);
+    acs_config_set_chan_del_sel(&config, 3);    // Unchanged
+
+    CHECK_EQ(acs_config_apply(&config, &rig.shadow, &result), ACS_OK);
+    CHECK_EQ(result.changed, 1U << WORD(0x0D));
+    CHECK_EQ(result.words_written, 1);
+    CHECK_EQ(eeprom_0x0D_pacc_trim_sget(rig.sim.regs[0x0D]), -2);
+    CHECK_EQ(eeprom_0x0D_fault_get(rig.sim.regs[0x0D]), 0xC8);
+    CHECK_EQ(rig.sim.eeprom_writes[WORD(0x0B)], 0);
+
+    // Applying it again has nothing to write
+    uint32_t transactions = rig.sim.transactions;
+    CHECK_EQ(acs_config_apply(&config, &rig.shadow, &result), ACS_OK);
+    CHECK_EQ(result.words_written, 0);
+    CHECK_EQ(rig.sim.transactions, transactions);
+}
+
+static void test_apply_refuses_partial_uncorrectable_word(void)
+{
+    static rig_t rig;
+    acs_config_t config;
+
+    rig_init(&rig);
+    rig.sim.regs[0x0D] |= eeprom_frame_EEC_set(0U, ACS_EEC_UNCORRECTABLE);
+    uint32_t before = rig.sim.regs[0x0D];
+
+    // Another word only, the bad one would still be written back
+    acs_config_init(&config);
+    acs_config_set_crs_sns(&config, 2);
+    acs_config_set_pacc_trim(&config, 1);
+    CHECK_EQ(acs_config_apply(&config, &rig.shadow, NULL), ACS_ERR_ECC);
+    CHECK(rig.shadow.loaded);
+    CHECK_EQ(rig.shadow.uncorrectable, 1U << WORD(0x0D));
+    CHECK_EQ(rig.sim.eeprom_writes[WORD(0x0B)], 0);
+    CHECK_EQ(rig.sim.eeprom_writes[WORD(0x0D)], 0);
+    CHECK_EQ(rig.sim.regs[0x0D], before);
+
+    // Still refused with the shadow already loaded
+    CHECK_EQ(acs_config_apply(&config, &rig.shadow, NULL), ACS_ERR_ECC);
+    CHECK_EQ(rig.sim.eeprom_writes[WORD(0x0D)], 0);
+}
+
+static void test_apply_replaces_covered_uncorrectable_word(void)
+{
+    static rig_t rig;
+    acs_config_t config;
+    acs_config_result_t result;
+
+    rig_init(&rig);
+    // Corrupt data in bit 19, which no field owns, as well
+    rig.sim.regs[0x0D] |= eeprom_frame_EEC_set(0U, ACS_EEC_UNCORRECTABLE) | (1UL << 19);
+    uint32_t before = rig.sim.regs[0x0D];
+
+    acs_config_init(&config);
+    acs_config_set_squarewave_en(&config, 0);
+    acs_config_set_halfcycle_en(&config, 1);
+    acs_config_set_fltdly(&config, 2);
+    acs_config_set_fault(&config, 0x40);
+    acs_config_set_chan_del_sel(&config, 5);
+    acs_config_set_ichan_del_en(&config, 1);
+    acs_config_set_pacc_trim(&config, -3);
+
+    CHECK_EQ(acs_config_apply(&config, &rig.shadow, &result), ACS_OK);
+    CHECK_EQ(result.changed, 1U << WORD(0x0D));
+    CHECK_EQ(rig.shadow.uncorrectable, 0);
+
+    uint32_t after = rig.sim.regs[0x0D];
+    CHECK(after != before);
+    CHECK_EQ(eeprom_frame_EEC_get(after), 0);
+    CHECK_EQ(after & (1UL << 19), 0);
+    CHECK_EQ(eeprom_0x0D_halfcycle_en_get(after), 1);
+    CHECK_EQ(eeprom_0x0D_fltdly_get(after), 2);
+    CHECK_EQ(eeprom_0x0D_fault_get(after), 0x40);
+    CHECK_EQ(eeprom_0x0D_chan_del_sel_get(after), 5);
+    CHECK_EQ(eeprom_0x0D_ichan_del_en_get(after), 1);
+    CHECK_EQ(eeprom_0x0D_pacc_trim_sget(after), -3);
+
+    // The word is good again, partial configs apply
+    acs_config_init(&config);
+    acs_config_set_fault(&config, 0x41);
+    CHECK_EQ(acs_config_apply(&config, &rig.shadow, NULL), ACS_OK);
+    CHECK_EQ(eeprom_0x0D_fault_get(rig.sim.regs[0x0D]), 0x41);
+}
+
+int main(void)
+{
+    RUN(test_validate);
+    RUN(test_apply_writes_changed_words);
+    RUN(test_apply_refuses_partial_uncorrectable_word);
+    RUN(test_apply_replaces_covered_uncorrectable_word);
+    return test_report("config");
+}
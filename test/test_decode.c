@@ -0,0 +1,101 @@
+#include "ACS71020.h"
+#include "ACS71020_decode.h"
+#include "test.h"
+
+#define FRAMES 37U  // Not a multiple of any vector width, exercises the tails
+
+static const acs_full_scale_t fs = { 30.0, 250.0, 7500.0 };
+
+static void test_snapshot_values(void)
+{
+    acs_snapshot_t snap = { { 0 } };
+    acs_measurement_t m;
+
+    snap.words[0x20 - ACS_REG_MEAS_FIRST] = (0x4000U << 17) | (0x2000U << 1);  // vrms 0.5, irms 0.5
+    snap.words[0x21 - ACS_REG_MEAS_FIRST] = 0x1C000U;                           // pactive -0.5
+    snap.words[0x22 - ACS_REG_MEAS_FIRST] = 0x4000U;                            // papparent 0.5
+    snap.words[0x23 - ACS_REG_MEAS_FIRST] = 0x2000U;                            // pimag 0.25
+    snap.words[0x24 - ACS_REG_MEAS_FIRST] = 0x700U;                             // pfactor -0.5
+    snap.words[0x2A - ACS_REG_MEAS_FIRST] = 0x8000U;                            // vcodes 0.5
+    snap.words[0x2B - ACS_REG_MEAS_FIRST] = 0x1C000U;                           // icodes -0.5
+    snap.words[0x2C - ACS_REG_MEAS_FIRST] = 0xF0000000U;                        // pinstant -0.5
+
+    acs_decode_snapshot(&snap, &fs, &m);
+    CHECK_NEAR(m.irms,      15.0,    1e-4);
+    CHECK_NEAR(m.vrms,      125.0,   1e-3);
+    CHECK_NEAR(m.pactive,   -3750.0, 1e-2);
+    CHECK_NEAR(m.papparent, 3750.0,  1e-2);
+    CHECK_NEAR(m.pimag,     1875.0,  1e-2);
+    CHECK_NEAR(m.pfactor,   -0.5,    1e-6);
+    CHECK_NEAR(m.vcodes,    125.0,   1e-3);
+    CHECK_NEAR(m.icodes,    -15.0,   1e-4);
+    CHECK_NEAR(m.pinstant,  -3750.0, 1e-2);
+}
+
+/*
+ * The batch decoders, vectorized or not, agree with the snapshot decoder on
+ * arbitrary words.
+ */
+static void test_batch_matches_snapshot(void)
+{
+    static uint32_t words[FRAMES];
+    static float f32[9][FRAMES];
+    static double f64[9][FRAMES];
+    uint32_t x = 0x9E3779B9U;
+
+    for (size_t i = 0; i < FRAMES; i++)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        words[i] = x;
+    }
+
+    const acs_raw_batch_t raw =
+    {
+        (const acs_0x20_t *)words, (const acs_0x21_t *)words,
+        (const acs_0x22_t *)words, (const acs_0x23_t *)words,
+        (const acs_0x24_t *)words, (const acs_0x2A_t *)words,
+        (const acs_0x2B_t *)words, (const acs_0x2C_t *)words,
+    };
+    const acs_decoded_f32_t out32 =
+    {
+        f32[0], f32[1], f32[2], f32[3], f32[4], f32[5], f32[6], f32[7], f32[8],
+    };
+    const acs_decoded_f64_t out64 =
+    {
+        f64[0], f64[1], f64[2], f64[3], f64[4], f64[5], f64[6], f64[7], f64[8],
+    };
+
+    CHECK_EQ(acs_decode_batch_f32(&raw, FRAMES, &fs, &out32), ACS_OK);
+    CHECK_EQ(acs_decode_batch_f64(&raw, FRAMES, &fs, &out64), ACS_OK);
+
+    for (size_t i = 0; i < FRAMES; i++)
+    {
+        acs_snapshot_t snap;
+        acs_measurement_t m;
+
+        for (size_t w = 0; w < ACS_SNAPSHOT_WORDS; w++)
+            snap.words[w] = words[i];
+        acs_decode_snapshot(&snap, &fs, &m);
+
+        const float expected[9] =
+        {
+            m.irms, m.vrms, m.pactive, m.papparent, m.pimag,
+            m.pfactor, m.vcodes, m.icodes, m.pinstant,
+        };
+        for (size_t f = 0; f < 9U; f++)
+        {
+            double tolerance = 1e-6 * (expected[f] < 0 ? -expected[f] : expected[f]) + 1e-6;
+            CHECK_NEAR(f32[f][i], expected[f], tolerance);
+            CHECK_NEAR(f64[f][i], expected[f], tolerance);
+        }
+    }
+}
+
+int main(void)
+{
+    RUN(test_snapshot_values);
+    RUN(test_batch_matches_snapshot);
+    return test_report("decode");
+}
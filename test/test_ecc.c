@@ -0,0 +1,138 @@
+#include "ACS71020.h"
+#include "ACS71020_ecc.h"
+#include "test.h"
+
+#define WORDS 64U
+
+static uint32_t data_words[WORDS];
+
+static void fill_data(void)
+{
+    uint32_t x = 0x2545F491U;
+
+    data_words[0] = 0U;
+    data_words[1] = ACS_EEPROM_DATA_MASK;
+    for (size_t i = 2; i < WORDS; i++)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        data_words[i] = x & ACS_EEPROM_DATA_MASK;
+    }
+}
+
+static void test_clean_codewords(void)
+{
+    for (size_t i = 0; i < WORDS; i++)
+    {
+        uint32_t codeword = acs_ecc_codeword(data_words[i]);
+        uint32_t data = 0U;
+
+        CHECK_EQ(codeword >> ACS_EEPROM_DATA_SHIFT, data_words[i]);
+        CHECK_EQ(codeword & 0x3FU, acs_ecc_encode(data_words[i]));
+        CHECK_EQ(acs_ecc_verify(codeword, &data), ACS_EEC_OK);
+        CHECK_EQ(data, data_words[i]);
+    }
+
+    // Bits above the 26 data bits do not take part
+    CHECK_EQ(acs_ecc_encode(0xFC000000U | 0x155U), acs_ecc_encode(0x155U));
+}
+
+/**
+ * @brief Every one of the 32 bits flipped on its own is corrected, data,
+ * Hamming and parity bits alike.
+ */
+static void test_single_flips_corrected(void)
+{
+    unsigned wrong = 0U;
+
+    for (size_t i = 0; i < WORDS; i++)
+    {
+        uint32_t codeword = acs_ecc_codeword(data_words[i]);
+        for (uint32_t bit = 0; bit < 32U; bit++)
+        {
+            uint32_t data = 0U;
+            if (acs_ecc_verify(codeword ^ (1UL << bit), &data) != ACS_EEC_CORRECTED ||
+                data != data_words[i])
+                wrong++;
+        }
+    }
+    CHECK_EQ(wrong, 0);
+}
+
+/**
+ * @brief Every pair of flipped bits is detected and not miscorrected.
+ */
+static void test_double_flips_uncorrectable(void)
+{
+    unsigned missed = 0U;
+
+    for (size_t i = 0; i < WORDS; i++)
+    {
+        uint32_t codeword = acs_ecc_codeword(data_words[i]);
+        for (uint32_t a = 0; a < 32U; a++)
+            for (uint32_t b = a + 1U; b < 32U; b++)
+                if (acs_ecc_verify(codeword ^ (1UL << a) ^ (1UL << b), NULL) != ACS_EEC_UNCORRECTABLE)
+                    missed++;
+    }
+    CHECK_EQ(missed, 0);
+}
+
+static void test_batch_matches_single(void)
+{
+    uint32_t codewords[WORDS];
+    uint8_t  status[WORDS];
+    uint32_t data[WORDS];
+    size_t   expected_bad = 0U;
+
+    // Clean, single and double flips in turn
+    for (size_t i = 0; i < WORDS; i++)
+    {
+        codewords[i] = acs_ecc_codeword(data_words[i]);
+        if (i % 3U == 1U)
+            codewords[i] ^= 1UL << (i % 32U);
+        if (i % 3U == 2U)
+            codewords[i] ^= 1UL << (i % 32U) | 1UL << ((i + 7U) % 32U);
+    }
+
+    size_t bad = acs_ecc_verify_batch(codewords, WORDS, status, data);
+    for (size_t i = 0; i < WORDS; i++)
+    {
+        uint32_t single_data;
+        acs_eec_t single = acs_ecc_verify(codewords[i], &single_data);
+
+        CHECK_EQ(status[i], single);
+        CHECK_EQ(data[i], single_data);
+        expected_bad += single == ACS_EEC_UNCORRECTABLE;
+    }
+    CHECK_EQ(bad, expected_bad);
+    CHECK_EQ(bad, WORDS / 3U);
+    CHECK_EQ(acs_ecc_verify_batch(codewords, WORDS, NULL, NULL), bad);
+}
+
+static void test_reported_batch(void)
+{
+    const uint32_t frames[4] =
+    {
+        eeprom_frame_EEC_set(0x12345640U, ACS_EEC_OK),
+        eeprom_frame_EEC_set(0x12345640U, ACS_EEC_CORRECTED),
+        eeprom_frame_EEC_set(0x12345640U, ACS_EEC_UNCORRECTABLE),
+        eeprom_frame_EEC_set(0x12345640U, ACS_EEC_DONT_CARE),
+    };
+    uint8_t status[4];
+
+    CHECK_EQ(acs_ecc_reported_batch(frames, 4U, status), 1);
+    for (uint8_t i = 0; i < 4U; i++)
+        CHECK_EQ(status[i], i);
+}
+
+int main(void)
+{
+    fill_data();
+    RUN(test_clean_codewords);
+    RUN(test_single_flips_corrected);
+    RUN(test_double_flips_uncorrectable);
+    RUN(test_batch_matches_single);
+    RUN(test_reported_batch);
+    return test_report("ecc");
+}
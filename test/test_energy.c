@@ -0,0 +1,150 @@
+#include <string.h>
+#include <stddef.h>
+#include "ACS71020.h"
+#include "ACS71020_energy.h"
+#include "test.h"
+
+/**
+ * @brief A snapshot with pactive in its 2^-15 codes and pospf.
+ */
+static void make_snapshot(acs_snapshot_t *snap, int32_t pactive, bool pospf)
+{
+    memset(snap, 0, sizeof(*snap));
+    snap->regs.reg_0x21.register_value = acs_0x21_pactive_set(0U, (uint32_t)pactive);
+    snap->regs.reg_0x2D.register_value = acs_0x2D_pospf_set(0U, pospf);
+}
+
+static void test_import_export_split(void)
+{
+    acs_energy_t energy;
+    acs_snapshot_t snap;
+
+    acs_energy_init(&energy, 2000U);
+
+    // Half of full scale for 1 s in 1 ms steps, the first update only starts
+    make_snapshot(&snap, 16384, true);
+    for (uint32_t i = 0; i <= 1000U; i++)
+        acs_energy_update(&energy, &snap, 1000U * i);
+    CHECK_EQ(energy.updates, 1000);
+    CHECK_EQ(energy.imported.units, 500000);
+    CHECK_EQ(energy.imported.frac, 0);
+    CHECK_EQ(energy.exported.units, 0);
+
+    // Negative pactive with pospf clear is export, booked as a magnitude
+    make_snapshot(&snap, -8192, false);
+    for (uint32_t i = 1; i <= 100U; i++)
+        acs_energy_update(&energy, &snap, 1000000U + 1000U * i);
+    CHECK_EQ(energy.exported.units, 25000);
+    CHECK_EQ(energy.imported.units, 500000);
+
+    // 3.6e9 units of full scale power times a microsecond is one hour of it
+    CHECK_NEAR(acs_energy_wh(&energy.imported, 7200.0), 1.0, 1e-12);
+}
+
+/**
+ * @brief The smallest pactive over one microsecond is 2^-15 of a unit, the
+ * 2^15-th of them carries exactly into the units.
+ */
+static void test_fractional_carry(void)
+{
+    acs_energy_t energy;
+    acs_snapshot_t snap;
+
+    acs_energy_init(&energy, 10U);
+    make_snapshot(&snap, 1, true);
+
+    acs_energy_update(&energy, &snap, 0U);
+    for (uint32_t i = 1; i < 32768U; i++)
+        acs_energy_update(&energy, &snap, i);
+    CHECK_EQ(energy.imported.units, 0);
+    CHECK_EQ(energy.imported.frac, (1UL << ACS_ENERGY_FRAC_BITS) - (1UL << 14));
+
+    acs_energy_update(&energy, &snap, 32768U);
+    CHECK_EQ(energy.imported.units, 1);
+    CHECK_EQ(energy.imported.frac, 0);
+
+    // pinstant has 29 fractional bits, one code is one frac step
+    acs_energy_init(&energy, 10U);
+    acs_energy_update_instant(&energy, 1U, 0U);
+    acs_energy_update_instant(&energy, 1U, 3U);
+    acs_energy_update_instant(&energy, (uint32_t)-2, 4U);
+    CHECK_EQ(energy.imported.frac, 3);
+    CHECK_EQ(energy.exported.frac, 2);
+}
+
+static void test_gaps_not_integrated(void)
+{
+    acs_energy_t energy;
+    acs_snapshot_t snap;
+
+    acs_energy_init(&energy, 2000U);
+    make_snapshot(&snap, 32767, true);
+
+    acs_energy_update(&energy, &snap, 0U);
+    acs_energy_update(&energy, &snap, 1000U);
+    uint64_t units = energy.imported.units;
+
+    // A stalled reader, then the interval after it counts again
+    acs_energy_update(&energy, &snap, 60000000U);
+    CHECK_EQ(energy.gaps, 1);
+    CHECK_EQ(energy.imported.units, units);
+    acs_energy_update(&energy, &snap, 60001000U);
+    CHECK(energy.imported.units > units);
+    units = energy.imported.units;
+
+    // Time going backwards is skipped too
+    acs_energy_update(&energy, &snap, 5000U);
+    CHECK_EQ(energy.imported.units, units);
+    CHECK_EQ(energy.updates, 2);
+}
+
+static void test_save_restore(void)
+{
+    acs_energy_t energy, restored;
+    acs_energy_state_t state;
+    acs_snapshot_t snap;
+
+    acs_energy_init(&energy, 2000U);
+    make_snapshot(&snap, 12345, true);
+    for (uint32_t i = 0; i < 50U; i++)
+        acs_energy_update(&energy, &snap, 777U * i);
+    make_snapshot(&snap, -321, false);
+    for (uint32_t i = 50; i < 80U; i++)
+        acs_energy_update(&energy, &snap, 777U * i);
+    CHECK(energy.imported.frac != 0U);
+    CHECK(energy.exported.units != 0U);
+
+    acs_energy_save(&energy, &state);
+
+    // Padding after frac does not take part in the checksum
+    size_t pad = offsetof(acs_energy_reg_t, frac) + sizeof(uint32_t);
+    if (sizeof(acs_energy_reg_t) > pad)
+        memset((uint8_t *)&state.imported + pad, 0xA5, sizeof(acs_energy_reg_t) - pad);
+
+    acs_energy_init(&restored, 2000U);
+    CHECK_EQ(acs_energy_restore(&restored, &state), ACS_OK);
+    CHECK_EQ(restored.imported.units, energy.imported.units);
+    CHECK_EQ(restored.imported.frac, energy.imported.frac);
+    CHECK_EQ(restored.exported.units, energy.exported.units);
+    CHECK_EQ(restored.exported.frac, energy.exported.frac);
+    CHECK(!restored.started);
+
+    acs_energy_state_t bad = state;
+    bad.exported.units++;
+    CHECK_EQ(acs_energy_restore(&restored, &bad), ACS_ERR_PARAM);
+    bad = state;
+    bad.version++;
+    CHECK_EQ(acs_energy_restore(&restored, &bad), ACS_ERR_PARAM);
+    bad = state;
+    bad.checksum ^= 1U;
+    CHECK_EQ(acs_energy_restore(&restored, &bad), ACS_ERR_PARAM);
+}
+
+int main(void)
+{
+    RUN(test_import_export_split);
+    RUN(test_fractional_carry);
+    RUN(test_gaps_not_integrated);
+    RUN(test_save_restore);
+    return test_report("energy");
+}
@@ -0,0 +1,369 @@
+#include <string.h>
+#include "ACS71020.h"
+#include "ACS71020_event.h"
+#include "ACS71020_sim.h"
+#include "test.h"
+
+#define SAMPLE_HZ 32000U
+#define MAX_LOG   64U
+
+typedef struct
+{
+    acs_transport_t    transport;
+    acs_sim_t          sim;
+    acs_device_t       dev;
+    acs_event_engine_t engine;
+
+    acs_event_t        log[MAX_LOG];
+    uint32_t           logged;
+} rig_t;
+
+static void on_event(void *user, const acs_event_t *event)
+{
+    rig_t *rig = user;
+
+    if (rig->logged < MAX_LOG)
+        rig->log[rig->logged++] = *event;
+}
+
+static void on_dio(void *user, bool level)
+{
+    rig_t *rig = user;
+
+    acs_event_on_dio(&rig->engine, 0U, level);
+}
+
+/**
+ * @brief A 50 Hz simulator with the current low enough to stay clear of the
+ * overcurrent fault, and the engine wired to its DIO0 edges.
+ */
+static void rig_init(rig_t *rig, const acs_event_config_t *config)
+{
+    acs_sim_config_t sim_config;
+
+    memset(rig, 0, sizeof(*rig));
+    acs_sim_default_config(&sim_config);
+    sim_config.current.amplitude = 0.3f;
+    acs_sim_init(&rig->sim, &sim_config);
+    acs_transport_sim_init(&rig->transport, &rig->sim);
+    acs_device_init(&rig->dev, &rig->transport, sim_config.dev_addr);
+    acs_sim_set_dio_callback(&rig->sim, on_dio, rig);
+
+    CHECK_EQ(acs_event_init(&rig->engine, &rig->dev, config, on_event, rig), ACS_OK);
+}
+
+/**
+ * @brief First logged event of a kind with the given state, NULL if none.
+ */
+static const acs_event_t *find(const rig_t *rig, acs_event_kind_t kind, bool active)
+{
+    for (uint32_t n = 0; n < rig->logged; n++)
+    {
+        if (rig->log[n].kind == kind && rig->log[n].active == active)
+            return &rig->log[n];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Runs the simulator for ms milliseconds, polling 0x2D and servicing
+ * the pins every millisecond.
+ */
+static void run_polled(rig_t *rig, uint32_t ms)
+{
+    for (uint32_t n = 0; n < ms; n++)
+    {
+        acs_sim_advance(&rig->sim, 1000000U);
+        CHECK_EQ(acs_event_poll(&rig->engine, acs_sim_now_us(&rig->sim)), ACS_OK);
+        acs_event_service(&rig->engine, acs_sim_now_us(&rig->sim));
+    }
+}
+
+/**
+ * @brief Runs the simulator for ms milliseconds, feeding every ADC sample to
+ * the peak detectors.
+ */
+static void run_sampled(rig_t *rig, uint32_t ms)
+{
+    for (uint32_t n = 0; n < ms * (SAMPLE_HZ / 1000U); n++)
+    {
+        acs_sample_t sample;
+
+        acs_sim_advance(&rig->sim, 1000000000U / SAMPLE_HZ);
+        sample.vcodes = acs_0x2A_vcodes_sget(rig->sim.regs[0x2A]);
+        sample.icodes = acs_0x2B_icodes_sget(rig->sim.regs[0x2B]);
+        sample.seq    = n;
+        acs_event_sample(&rig->engine, &sample, acs_sim_now_us(&rig->sim));
+    }
+}
+
+/**
+ * @brief Time from raising the voltage over the device's threshold to the
+ * overvoltage flag, for vevent_cycs hold cycles.
+ */
+static uint64_t overvoltage_delay_us(uint32_t vevent_cycs)
+{
+    static rig_t rig;
+    acs_event_config_t config = { 0 };
+
+    rig_init(&rig, &config);
+
+    // vrms of 0.7 / sqrt(2) is 16219 codes, the threshold 31 << 9 is 15872
+    rig.sim.config.voltage.amplitude = 0.6f;
+    rig.sim.regs[0x0E] = eeprom_0x0E_vevent_cycs_set(eeprom_0x0E_overvreg_set(0U, 31U), vevent_cycs);
+    rig.sim.regs[0x0F] = eeprom_0x0F_dio_0_sel_set(rig.sim.regs[0x0F], 1U);
+    run_polled(&rig, 100U);
+    CHECK(find(&rig, ACS_EVENT_HW_OVERVOLTAGE, true) == NULL);
+
+    uint64_t start_us = acs_sim_now_us(&rig.sim);
+    rig.sim.config.voltage.amplitude = 0.7f;
+    run_polled(&rig, 300U);
+
+    const acs_event_t *ov = find(&rig, ACS_EVENT_HW_OVERVOLTAGE, true);
+    const acs_event_t *dio = find(&rig, ACS_EVENT_DIO0, true);
+    CHECK(ov != NULL);
+    CHECK(dio != NULL);
+    if (ov == NULL || dio == NULL)
+        return 0U;
+
+    // The pin follows the flag, both seen within the same poll
+    CHECK_NEAR((double)dio->timestamp_us, (double)ov->timestamp_us, 1000.0);
+    CHECK_EQ(rig.engine.counts[ACS_EVENT_HW_OVERVOLTAGE], 1);
+    CHECK_EQ(rig.engine.counts[ACS_EVENT_DIO0], 1);
+    uint64_t delay_us = ov->timestamp_us - start_us;
+
+    // Back under the threshold, flag and pin release together
+    rig.logged = 0U;
+    rig.sim.config.voltage.amplitude = 0.6f;
+    run_polled(&rig, 100U);
+    CHECK(find(&rig, ACS_EVENT_HW_OVERVOLTAGE, false) != NULL);
+    CHECK(find(&rig, ACS_EVENT_DIO0, false) != NULL);
+
+    return delay_us;
+}
+
+/**
+ * @brief Every extra vevent_cycs hold cycle delays the device's flag by one
+ * line cycle.
+ */
+static void test_hw_overvoltage_hold_cycles(void)
+{
+    uint64_t none  = overvoltage_delay_us(0U);
+    uint64_t three = overvoltage_delay_us(3U);
+
+    CHECK(none <= 45000U);
+    CHECK_NEAR((double)(three - none), 60000.0, 2000.0);
+}
+
+/**
+ * @brief Undervoltage through DIO0 set to either condition.
+ */
+static void test_hw_undervoltage(void)
+{
+    static rig_t rig;
+    acs_event_config_t config = { 0 };
+
+    rig_init(&rig, &config);
+    rig.sim.regs[0x0E] = eeprom_0x0E_undervreg_set(0U, 25U);
+    rig.sim.regs[0x0F] = eeprom_0x0F_dio_0_sel_set(rig.sim.regs[0x0F], 3U);
+    run_polled(&rig, 100U);
+    CHECK_EQ(rig.logged, 0);
+
+    // 0.5 / sqrt(2) is 11585 codes, under 25 << 9 = 12800
+    rig.sim.config.voltage.amplitude = 0.5f;
+    run_polled(&rig, 100U);
+    CHECK(find(&rig, ACS_EVENT_HW_UNDERVOLTAGE, true) != NULL);
+    CHECK(find(&rig, ACS_EVENT_DIO0, true) != NULL);
+    CHECK(find(&rig, ACS_EVENT_HW_OVERVOLTAGE, true) == NULL);
+}
+
+/**
+ * @brief The rms detectors need trip_count snapshots in a row beyond set to
+ * assert, and clear_count within clear to release. In between, the state
+ * holds.
+ */
+static void test_rms_debounce(void)
+{
+    static rig_t rig;
+    acs_event_config_t config = { 0 };
+    acs_snapshot_t snap;
+
+    config.overvoltage_rms = (acs_event_threshold_t){ true, 0.5f, 0.45f, 3U, 2U };
+    rig_init(&rig, &config);
+
+    // 0.5 and 0.45 of full scale are 16384 and 14746 codes
+    static const uint32_t vrms[] = { 16400, 16400, 15000, 16400, 16400, 16400,
+                                     15000, 14000, 15000, 14000, 14000 };
+    static const bool active[]   = { false, false, false, false, false, true,
+                                     true,  true,  true,  true,  false };
+
+    memset(&snap, 0, sizeof(snap));
+    for (uint32_t n = 0; n < sizeof(vrms) / sizeof(vrms[0]); n++)
+    {
+        snap.regs.reg_0x20.register_value = acs_0x20_vrms_set(0U, vrms[n]);
+        CHECK_EQ(acs_event_snapshot(&rig.engine, &snap, n), ACS_OK);
+        CHECK_EQ(rig.engine.detectors[ACS_EVENT_OVERVOLTAGE_RMS].active, active[n]);
+    }
+
+    CHECK_EQ(rig.logged, 2);
+    CHECK_EQ(rig.log[0].timestamp_us, 5);
+    CHECK_NEAR(rig.log[0].level, 16400.0 / 32768.0, 1e-6);
+    CHECK_EQ(rig.log[1].active, false);
+    CHECK_EQ(rig.log[1].timestamp_us, 10);
+
+    // Clear above set is refused for an over-detector
+    config.overvoltage_rms.clear = 0.6f;
+    CHECK_EQ(acs_event_init(&rig.engine, NULL, &config, on_event, &rig), ACS_ERR_PARAM);
+}
+
+/**
+ * @brief A voltage swell trips the peak detector within the half-cycle it
+ * starts in, and releases after clear_count quiet half-cycles.
+ */
+static void test_peak_swell(void)
+{
+    static rig_t rig;
+    acs_event_config_t config = { 0 };
+
+    config.overvoltage_peak = (acs_event_threshold_t){ true, 0.8f, 0.75f, 2U, 2U };
+    config.sample_hz        = SAMPLE_HZ;
+    config.line_hz          = 50.0f;
+    rig_init(&rig, &config);
+
+    run_sampled(&rig, 100U);
+    CHECK_EQ(rig.logged, 0);
+
+    uint64_t start_us = acs_sim_now_us(&rig.sim);
+    rig.sim.config.voltage.amplitude = 0.9f;
+    run_sampled(&rig, 100U);
+
+    const acs_event_t *on = find(&rig, ACS_EVENT_OVERVOLTAGE_PEAK, true);
+    CHECK(on != NULL);
+    if (on != NULL)
+    {
+        CHECK(on->timestamp_us - start_us <= 10000U);
+        CHECK(on->level >= 0.8f);
+    }
+    CHECK_EQ(rig.engine.counts[ACS_EVENT_OVERVOLTAGE_PEAK], 1);
+
+    start_us = acs_sim_now_us(&rig.sim);
+    rig.sim.config.voltage.amplitude = 0.7f;
+    run_sampled(&rig, 100U);
+
+    const acs_event_t *off = find(&rig, ACS_EVENT_OVERVOLTAGE_PEAK, false);
+    CHECK(off != NULL);
+    if (off != NULL)
+        CHECK_NEAR((double)(off->timestamp_us - start_us), 20000.0, 10000.0);
+}
+
+/**
+ * @brief A collapsed voltage has no zero crossings, the half-cycle is closed
+ * by its maximum length and the undervoltage still trips.
+ */
+static void test_peak_collapse(void)
+{
+    static rig_t rig;
+    acs_event_config_t config = { 0 };
+
+    config.undervoltage_peak = (acs_event_threshold_t){ true, 0.3f, 0.35f, 2U, 1U };
+    config.sample_hz         = SAMPLE_HZ;
+    config.line_hz           = 50.0f;
+    rig_init(&rig, &config);
+
+    run_sampled(&rig, 100U);
+    CHECK_EQ(rig.logged, 0);
+
+    uint64_t start_us = acs_sim_now_us(&rig.sim);
+    rig.sim.config.voltage.amplitude = 0.0f;
+    run_sampled(&rig, 100U);
+
+    const acs_event_t *on = find(&rig, ACS_EVENT_UNDERVOLTAGE_PEAK, true);
+    CHECK(on != NULL);
+    if (on != NULL)
+    {
+        CHECK(on->timestamp_us - start_us <= 40000U);
+        CHECK_NEAR(on->level, 0.0, 1e-3);
+    }
+
+    rig.sim.config.voltage.amplitude = 0.7f;
+    run_sampled(&rig, 100U);
+    CHECK(find(&rig, ACS_EVENT_UNDERVOLTAGE_PEAK, false) != NULL);
+
+    config.sample_hz = 0U;
+    CHECK_EQ(acs_event_init(&rig.engine, NULL, &config, on_event, &rig), ACS_ERR_PARAM);
+}
+
+/**
+ * @brief An overcurrent sets faultout and faultlatched. With auto-clear the
+ * latch is written back, and released once the current is back down.
+ */
+static void test_fault_latched(void)
+{
+    static rig_t rig;
+    acs_event_config_t config = { 0 };
+
+    config.auto_clear_latched = true;
+    rig_init(&rig, &config);
+
+    rig.sim.config.current.amplitude = 0.9f;
+    run_polled(&rig, 20U);
+    CHECK(find(&rig, ACS_EVENT_HW_FAULT, true) != NULL);
+    CHECK(find(&rig, ACS_EVENT_HW_FAULT_LATCHED, true) != NULL);
+
+    rig.sim.config.current.amplitude = 0.3f;
+    run_polled(&rig, 20U);
+    CHECK(find(&rig, ACS_EVENT_HW_FAULT, false) != NULL);
+    CHECK(find(&rig, ACS_EVENT_HW_FAULT_LATCHED, false) != NULL);
+    CHECK_EQ(acs_0x2D_faultlatched_get(rig.sim.regs[0x2D]), 0);
+    CHECK_EQ(rig.engine.bus_errors, 0);
+
+    // While the overcurrent lasted, every clear was latched again
+    uint32_t latched = rig.engine.counts[ACS_EVENT_HW_FAULT_LATCHED];
+    CHECK(latched >= 1U);
+    run_polled(&rig, 20U);
+    CHECK_EQ(rig.engine.counts[ACS_EVENT_HW_FAULT_LATCHED], latched);
+}
+
+/**
+ * @brief Edges recorded from an ISR are dispatched once per pin, with the
+ * latest level.
+ */
+static void test_dio_edges(void)
+{
+    static rig_t rig;
+    acs_event_config_t config = { 0 };
+
+    rig_init(&rig, &config);
+
+    acs_event_service(&rig.engine, 1U);
+    CHECK_EQ(rig.logged, 0);
+
+    acs_event_on_dio(&rig.engine, 1U, true);
+    acs_event_on_dio(&rig.engine, 0U, true);
+    acs_event_on_dio(&rig.engine, 0U, false);
+    acs_event_service(&rig.engine, 2U);
+
+    CHECK_EQ(rig.logged, 2);
+    CHECK_EQ(rig.log[0].kind, ACS_EVENT_DIO0);
+    CHECK_EQ(rig.log[0].active, false);
+    CHECK_EQ(rig.log[1].kind, ACS_EVENT_DIO1);
+    CHECK_EQ(rig.log[1].active, true);
+    CHECK_EQ(rig.log[1].timestamp_us, 2);
+    CHECK_EQ(rig.engine.counts[ACS_EVENT_DIO1], 1);
+    CHECK_EQ(rig.engine.counts[ACS_EVENT_DIO0], 0);
+
+    acs_event_service(&rig.engine, 3U);
+    CHECK_EQ(rig.logged, 2);
+}
+
+int main(void)
+{
+    RUN(test_hw_overvoltage_hold_cycles);
+    RUN(test_hw_undervoltage);
+    RUN(test_rms_debounce);
+    RUN(test_peak_swell);
+    RUN(test_peak_collapse);
+    RUN(test_fault_latched);
+    RUN(test_dio_edges);
+    return test_report("event");
+}
@@ -0,0 +1,55 @@
+#include "ACS71020.h"
+#include "test.h"
+
+static void test_union_layout(void)
+{
+    CHECK_EQ(acs_fields_verify_layout(), ACS_OK);
+}
+
+/*
+ * Every field: the table entry matches the X-macro row, and the generated
+ * accessors touch exactly the bits of the field.
+ */
+#define CHECK_ACCESSORS(prefix, address, field, fshift, fwidth, is_signed)            \
+    {                                                                                 \
+        const acs_field_desc_t *desc = acs_field_find(address, #field);               \
+        CHECK(desc != NULL);                                                          \
+        if (desc != NULL)                                                             \
+        {                                                                             \
+            CHECK_EQ(desc->shift, fshift);                                            \
+            CHECK_EQ(desc->width, fwidth);                                            \
+        }                                                                             \
+        CHECK_EQ(prefix##_##field##_get(0xFFFFFFFFU), ACS_FIELD_MASK(fwidth));        \
+        CHECK_EQ(prefix##_##field##_set(0U, 0xFFFFFFFFU),                             \
+                 ACS_FIELD_MASK(fwidth) << (fshift));                                 \
+        CHECK_EQ(prefix##_##field##_set(0xFFFFFFFFU, 0U),                             \
+                 ~(ACS_FIELD_MASK(fwidth) << (fshift)));                              \
+        CHECK_EQ(prefix##_##field##_get(prefix##_##field##_set(0x5A5A5A5AU, 1U)), 1); \
+    }
+
+static void test_accessors(void)
+{
+    ACS_VOLATILE_FIELDS(CHECK_ACCESSORS)
+    ACS_EEPROM_FIELDS(CHECK_ACCESSORS)
+}
+
+static void test_signed_fields(void)
+{
+    const acs_field_desc_t *pactive = acs_field_find(0x21U, "pactive");
+
+    CHECK_EQ(acs_0x21_pactive_sget(0x0001FFFFU), -1);
+    CHECK_EQ(acs_0x21_pactive_sget(0x00010000U), -65536);
+    CHECK_EQ(acs_0x21_pactive_sget(0x0000FFFFU), 65535);
+    CHECK_EQ(acs_0x2C_pinstant_sget(0x80000000U), INT32_MIN);
+    CHECK_EQ(eeprom_0x0D_pacc_trim_sget(0x7FU << 25), -1);
+    CHECK_EQ(acs_field_decode(pactive, 0xFFFE0000U | 0x1FFFFU), -1);
+    CHECK(acs_field_find(0x21U, "irms") == NULL);
+}
+
+int main(void)
+{
+    RUN(test_union_layout);
+    RUN(test_accessors);
+    RUN(test_signed_fields);
+    return test_report("fields");
+}
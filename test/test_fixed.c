@@ -0,0 +1,159 @@
+#include <math.h>
+#include "ACS71020.h"
+#include "ACS71020_decode.h"
+#include "ACS71020_fixed.h"
+#include "test.h"
+
+#define MAX_CODES     (1U << 17)
+#define RANDOM_FRAMES 65536U
+
+typedef int64_t (*fixed_decoder_t)(uint32_t reg);
+
+#define FIXED_WRAPPER(field, fn) \
+    static int64_t fixed_##field(uint32_t reg) { return (int64_t)fn(reg); }
+
+FIXED_WRAPPER(irms,      acs_fixed_irms_ma)
+FIXED_WRAPPER(vrms,      acs_fixed_vrms_mv)
+FIXED_WRAPPER(pactive,   acs_fixed_pactive_mw)
+FIXED_WRAPPER(papparent, acs_fixed_papparent_mva)
+FIXED_WRAPPER(pimag,     acs_fixed_pimag_mvar)
+FIXED_WRAPPER(pfactor,   acs_fixed_pfactor_milli)
+FIXED_WRAPPER(vcodes,    acs_fixed_vcodes_mv)
+FIXED_WRAPPER(icodes,    acs_fixed_icodes_ma)
+FIXED_WRAPPER(pinstant,  acs_fixed_pinstant_mw)
+
+static uint32_t words[MAX_CODES];
+
+/**
+ * @brief Decodes count register words both ways and checks that the integer
+ * result equals the double result in milli units, rounded, for every word.
+ * @param output which member of acs_decoded_f64_t holds the field
+ */
+static void check_fixed(const char *field, size_t count, fixed_decoder_t fixed, size_t output)
+{
+    static double out[9][MAX_CODES];
+    const acs_full_scale_t fs =
+    {
+        ACS_FS_CURRENT_MA / 1000.0, ACS_FS_VOLTAGE_MV / 1000.0, ACS_FS_POWER_MW / 1000.0,
+    };
+    const acs_raw_batch_t raw =
+    {
+        (const acs_0x20_t *)words, (const acs_0x21_t *)words,
+        (const acs_0x22_t *)words, (const acs_0x23_t *)words,
+        (const acs_0x24_t *)words, (const acs_0x2A_t *)words,
+        (const acs_0x2B_t *)words, (const acs_0x2C_t *)words,
+    };
+    const acs_decoded_f64_t dec =
+    {
+        out[0], out[1], out[2], out[3], out[4], out[5], out[6], out[7], out[8],
+    };
+    size_t mismatches = 0;
+
+    CHECK_EQ(acs_decode_batch_f64(&raw, count, &fs, &dec), ACS_OK);
+    for (size_t i = 0; i < count; i++)
+    {
+        int64_t expected = (int64_t)llround(out[output][i] * 1000.0);
+        int64_t actual   = fixed(words[i]);
+        if (actual == expected)
+            continue;
+
+        // Only the first one of a field, the count says the rest
+        if (mismatches++ == 0U)
+            fprintf(stderr, "%s: 0x%08lX decodes to %lld, expected %lld\n", field,
+                    (unsigned long)words[i], (long long)actual, (long long)expected);
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+/**
+ * @brief Every code of every field up to 17 bits wide.
+ */
+static void test_every_code(void)
+{
+    static const struct
+    {
+        const char     *field;
+        uint32_t        shift;
+        uint32_t        width;
+        fixed_decoder_t fixed;
+        size_t          output;
+    } fields[] =
+    {
+        { "irms",       1U, 15U, fixed_irms,      0U },
+        { "vrms",      17U, 15U, fixed_vrms,      1U },
+        { "pactive",    0U, 17U, fixed_pactive,   2U },
+        { "papparent",  0U, 16U, fixed_papparent, 3U },
+        { "pimag",      0U, 16U, fixed_pimag,     4U },
+        { "pfactor",    0U, 11U, fixed_pfactor,   5U },
+        { "vcodes",     0U, 17U, fixed_vcodes,    6U },
+        { "icodes",     0U, 17U, fixed_icodes,    7U },
+    };
+
+    for (size_t f = 0; f < sizeof(fields) / sizeof(fields[0]); f++)
+    {
+        size_t count = (size_t)1U << fields[f].width;
+        for (size_t i = 0; i < count; i++)
+            words[i] = (uint32_t)i << fields[f].shift;
+        check_fixed(fields[f].field, count, fields[f].fixed, fields[f].output);
+    }
+}
+
+/**
+ * @brief pinstant is 32 bits wide, random words and its extremes.
+ */
+static void test_pinstant(void)
+{
+    uint32_t x = 0x12345678U;
+
+    for (size_t i = 0; i < RANDOM_FRAMES; i++)
+    {
+        // xorshift32
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        words[i] = x;
+    }
+    words[RANDOM_FRAMES + 0U] = 0x00000000U;
+    words[RANDOM_FRAMES + 1U] = 0x00000001U;
+    words[RANDOM_FRAMES + 2U] = 0xFFFFFFFFU;
+    words[RANDOM_FRAMES + 3U] = 0x7FFFFFFFU;
+    words[RANDOM_FRAMES + 4U] = 0x80000000U;
+    words[RANDOM_FRAMES + 5U] = 0x80000001U;
+    check_fixed("pinstant", RANDOM_FRAMES + 6U, fixed_pinstant, 8U);
+}
+
+/**
+ * @brief The snapshot decoder gives the same as the per field functions.
+ */
+static void test_snapshot(void)
+{
+    acs_snapshot_t snap;
+    acs_fixed_measurement_t m;
+
+    for (uint8_t i = 0; i < ACS_SNAPSHOT_WORDS; i++)
+        snap.words[i] = 0x9E3779B9U * (i + 1U);
+    acs_fixed_decode_snapshot(&snap, &m);
+
+    CHECK_EQ(m.irms_ma,       acs_fixed_irms_ma(snap.words[0]));
+    CHECK_EQ(m.vrms_mv,       acs_fixed_vrms_mv(snap.words[0]));
+    CHECK_EQ(m.pactive_mw,    acs_fixed_pactive_mw(snap.words[1]));
+    CHECK_EQ(m.papparent_mva, acs_fixed_papparent_mva(snap.words[2]));
+    CHECK_EQ(m.pimag_mvar,    acs_fixed_pimag_mvar(snap.words[3]));
+    CHECK_EQ(m.pfactor_milli, acs_fixed_pfactor_milli(snap.words[4]));
+    CHECK_EQ(m.vcodes_mv,     acs_fixed_vcodes_mv(snap.regs.reg_0x2A.register_value));
+    CHECK_EQ(m.icodes_ma,     acs_fixed_icodes_ma(snap.regs.reg_0x2B.register_value));
+    CHECK_EQ(m.pinstant_mw,   acs_fixed_pinstant_mw(snap.regs.reg_0x2C.register_value));
+
+    // Halves round away from zero on both sides
+    CHECK_EQ(acs_fixed_scale_s(1, 1U, 1U), 1);
+    CHECK_EQ(acs_fixed_scale_s(-1, 1U, 1U), -1);
+    CHECK_EQ(acs_fixed_scale_u(1U, 1U, 1U), 1);
+}
+
+int main(void)
+{
+    RUN(test_every_code);
+    RUN(test_pinstant);
+    RUN(test_snapshot);
+    return test_report("fixed");
+}
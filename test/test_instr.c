@@ -0,0 +1,277 @@
+#include <string.h>
+#include "ACS71020.h"
+#include "ACS71020_instr.h"
+#include "ACS71020_ecc.h"
+#include "test.h"
+
+#define ADDR 0x60U
+
+typedef struct
+{
+    uint64_t now_ns;
+    uint64_t step_ns;   // Added on every reading, so each transaction takes it
+} fake_clock_t;
+
+static uint64_t clock_ns(void *ctx)
+{
+    fake_clock_t *clock = ctx;
+    uint64_t now = clock->now_ns;
+
+    clock->now_ns += clock->step_ns;
+    return now;
+}
+
+typedef struct
+{
+    acs_fake_t      fake;
+    acs_transport_t inner;
+    acs_instr_t     instr;
+    acs_transport_t transport;
+    acs_device_t    dev;
+    fake_clock_t    clock;
+} rig_t;
+
+static void rig_init(rig_t *rig, uint8_t retries)
+{
+    memset(rig, 0, sizeof(*rig));
+    acs_transport_fake_init(&rig->inner, &rig->fake, ADDR);
+    rig->clock.step_ns = 1000U;
+    acs_transport_instr_init(&rig->transport, &rig->instr, &rig->inner, clock_ns,
+                             &rig->clock, retries);
+    acs_device_init(&rig->dev, &rig->transport, ADDR);
+}
+
+/**
+ * @brief Every latency lies within its bucket, and the buckets are
+ * contiguous.
+ */
+static void test_buckets(void)
+{
+    for (uint64_t ns = 0; ns < 4096U; ns++)
+    {
+        uint32_t b = acs_instr_bucket(ns);
+        CHECK(acs_instr_bucket_max(b) >= ns);
+        if (b > 0U)
+            CHECK(acs_instr_bucket_max(b - 1U) < ns);
+    }
+
+    CHECK_EQ(acs_instr_bucket(7U), 7);
+    CHECK_EQ(acs_instr_bucket(8U), 8);
+    CHECK_EQ(acs_instr_bucket(16U), 16);
+    CHECK_EQ(acs_instr_bucket(17U), 16);
+    CHECK_EQ(acs_instr_bucket_max(16U), 17);
+    CHECK_EQ(acs_instr_bucket(UINT64_MAX), ACS_INSTR_BUCKETS - 1U);
+    CHECK(acs_instr_bucket_max(ACS_INSTR_BUCKETS - 1U) == UINT64_MAX);
+
+    // Buckets are at most 1/8 wide past the linear range
+    for (uint32_t b = 8U; b < ACS_INSTR_BUCKETS - 1U; b++)
+    {
+        uint64_t lo = acs_instr_bucket_max(b - 1U) + 1U;
+        uint64_t hi = acs_instr_bucket_max(b);
+        CHECK(hi - lo + 1U <= (lo + 7U) / 8U);
+    }
+}
+
+#if ACS_INSTRUMENT
+
+/**
+ * @brief Reads count every word of a block against its register, writes
+ * count only once they succeed.
+ */
+static void test_per_register_counts(void)
+{
+    static rig_t rig;
+    acs_snapshot_t snap;
+
+    rig_init(&rig, 0U);
+
+    CHECK_EQ(acs_read_snapshot(&rig.dev, &snap), ACS_OK);
+    CHECK_EQ(acs_read_snapshot(&rig.dev, &snap), ACS_OK);
+    CHECK_EQ(acs_write_register(&rig.dev, 0x2DU, 1U), ACS_OK);
+
+    acs_instr_stats_t stats;
+    acs_instr_snapshot(&rig.instr, &stats);
+    for (uint32_t r = 0; r < 256U; r++)
+    {
+        bool measured = r >= ACS_REG_MEAS_FIRST && r <= ACS_REG_MEAS_LAST;
+        CHECK_EQ(stats.reads[r], measured ? 2U : 0U);
+        CHECK_EQ(stats.writes[r], r == 0x2DU ? 1U : 0U);
+    }
+    CHECK_EQ(stats.transactions[ACS_INSTR_READ], 2);
+    CHECK_EQ(stats.transactions[ACS_INSTR_WRITE], 1);
+
+    acs_instr_reset(&rig.instr);
+    CHECK_EQ(rig.instr.stats.reads[ACS_REG_MEAS_FIRST], 0);
+    CHECK_EQ(rig.instr.stats.transactions[ACS_INSTR_READ], 0);
+}
+
+/**
+ * @brief With a clock that advances a fixed step per reading, every
+ * transaction lands in the bucket of that step.
+ */
+static void test_latency_histogram(void)
+{
+    static rig_t rig;
+    uint32_t value;
+
+    rig_init(&rig, 0U);
+    for (uint32_t n = 0; n < 90U; n++)
+        CHECK_EQ(acs_read_register(&rig.dev, 0x20U, &value), ACS_OK);
+    rig.clock.step_ns = 50000U;
+    for (uint32_t n = 0; n < 10U; n++)
+        CHECK_EQ(acs_read_register(&rig.dev, 0x20U, &value), ACS_OK);
+
+    const acs_instr_hist_t *h = &rig.instr.stats.latency[ACS_INSTR_READ];
+    CHECK_EQ(h->total, 100);
+    CHECK_EQ(h->counts[acs_instr_bucket(1000U)], 90);
+    CHECK_EQ(h->counts[acs_instr_bucket(50000U)], 10);
+    CHECK_EQ(h->min_ns, 1000);
+    CHECK_EQ(h->max_ns, 50000);
+    CHECK_EQ(h->sum_ns, 90U * 1000U + 10U * 50000U);
+
+    CHECK_EQ(acs_instr_percentile(h, 0.5f), acs_instr_bucket_max(acs_instr_bucket(1000U)));
+    CHECK_EQ(acs_instr_percentile(h, 0.9f), acs_instr_bucket_max(acs_instr_bucket(1000U)));
+    CHECK_EQ(acs_instr_percentile(h, 0.99f), 50000);
+    CHECK_EQ(acs_instr_percentile(&rig.instr.stats.latency[ACS_INSTR_WRITE], 0.5f), 0);
+
+    // Without a clock transactions are still counted, just not timed
+    acs_transport_instr_init(&rig.transport, &rig.instr, &rig.inner, NULL, NULL, 0U);
+    CHECK_EQ(acs_read_register(&rig.dev, 0x20U, &value), ACS_OK);
+    CHECK_EQ(rig.instr.stats.transactions[ACS_INSTR_READ], 1);
+    CHECK_EQ(rig.instr.stats.latency[ACS_INSTR_READ].total, 0);
+}
+
+/**
+ * @brief Reads are retried after a NAK or bus error, writes are not, and
+ * other errors are never retried.
+ */
+static void test_errors_and_retries(void)
+{
+    static rig_t rig;
+    uint32_t value;
+
+    rig_init(&rig, 2U);
+
+    rig.fake.fail_next = ACS_ERR_NAK;
+    CHECK_EQ(acs_read_register(&rig.dev, 0x20U, &value), ACS_OK);
+    CHECK_EQ(rig.instr.stats.naks, 1);
+    CHECK_EQ(rig.instr.stats.retries, 1);
+    CHECK_EQ(rig.instr.stats.transactions[ACS_INSTR_READ], 2);
+    CHECK_EQ(rig.instr.stats.reads[0x20], 1);
+
+    rig.fake.fail_next = ACS_ERR_BUS;
+    CHECK_EQ(acs_write_register(&rig.dev, 0x2DU, 1U), ACS_ERR_BUS);
+    CHECK_EQ(rig.instr.stats.bus_errors, 1);
+    CHECK_EQ(rig.instr.stats.retries, 1);
+    CHECK_EQ(rig.instr.stats.transactions[ACS_INSTR_WRITE], 1);
+    CHECK_EQ(rig.instr.stats.writes[0x2D], 0);
+    CHECK_EQ(rig.fake.write_transactions, 0);
+
+    // Out of attempts: the first try and two retries all NAK
+    acs_device_t absent;
+    acs_device_init(&absent, &rig.transport, ADDR + 1U);
+    CHECK_EQ(acs_read_register(&absent, 0x20U, &value), ACS_ERR_NAK);
+    CHECK_EQ(rig.instr.stats.naks, 4);
+    CHECK_EQ(rig.instr.stats.retries, 3);
+
+    rig.fake.fail_next = ACS_ERR_LOCKED;
+    CHECK_EQ(acs_read_register(&rig.dev, 0x20U, &value), ACS_ERR_LOCKED);
+    CHECK_EQ(rig.instr.stats.other_errors, 1);
+    CHECK_EQ(rig.instr.stats.retries, 3);
+}
+
+/**
+ * @brief A batch is timed as one transaction, and its failed reads are
+ * retried one by one.
+ */
+static void test_read_multi(void)
+{
+    static rig_t rig;
+    uint32_t a[2];
+    uint32_t b[2];
+    acs_xfer_t xfers[2] =
+    {
+        { ADDR,      0x20U, 2U, 0, a },
+        { ADDR + 1U, 0x20U, 2U, 0, b },
+    };
+
+    rig_init(&rig, 1U);
+    CHECK_EQ(acs_transport_read_multi(&rig.transport, xfers, 2U), ACS_OK);
+    CHECK_EQ(xfers[0].status, ACS_OK);
+    CHECK_EQ(xfers[1].status, ACS_ERR_NAK);
+    CHECK_EQ(rig.instr.stats.transactions[ACS_INSTR_READ_MULTI], 1);
+    CHECK_EQ(rig.instr.stats.transactions[ACS_INSTR_READ], 1);
+    CHECK_EQ(rig.instr.stats.naks, 2);
+    CHECK_EQ(rig.instr.stats.retries, 1);
+    CHECK_EQ(rig.instr.stats.reads[0x21], 1);
+}
+
+/**
+ * @brief EEPROM words are counted by the EEC status the device put on them,
+ * other registers are not looked at.
+ */
+static void test_eec_counts(void)
+{
+    static rig_t rig;
+    uint32_t words[ACS_EEPROM_WORDS];
+
+    rig_init(&rig, 0U);
+    rig.fake.regs[0x0B] = eeprom_frame_EEC_set(0U, ACS_EEC_CORRECTED);
+    rig.fake.regs[0x0C] = eeprom_frame_EEC_set(0U, ACS_EEC_UNCORRECTABLE);
+    rig.fake.regs[0x0E] = eeprom_frame_EEC_set(0U, ACS_EEC_CORRECTED);
+    rig.fake.regs[0x20] = eeprom_frame_EEC_set(0U, ACS_EEC_UNCORRECTABLE);
+
+    CHECK_EQ(rig.transport.read(rig.transport.ctx, ADDR, ACS_REG_EEPROM_FIRST, words,
+                                ACS_EEPROM_WORDS), ACS_OK);
+    CHECK_EQ(acs_read_register(&rig.dev, 0x20U, &words[0]), ACS_OK);
+    CHECK_EQ(rig.instr.stats.eec_corrected, 2);
+    CHECK_EQ(rig.instr.stats.eec_uncorrectable, 1);
+}
+
+#else
+
+/**
+ * @brief Compiled out, the wrapper is the inner transport itself: nothing is
+ * counted and nothing is retried.
+ */
+static void test_compiled_out(void)
+{
+    static rig_t rig;
+    uint32_t value;
+
+    rig_init(&rig, 2U);
+    CHECK(rig.transport.read == rig.inner.read);
+    CHECK(rig.transport.write == rig.inner.write);
+    CHECK(rig.transport.ctx == rig.inner.ctx);
+
+    CHECK_EQ(acs_read_register(&rig.dev, 0x20U, &value), ACS_OK);
+    rig.fake.fail_next = ACS_ERR_NAK;
+    CHECK_EQ(acs_read_register(&rig.dev, 0x20U, &value), ACS_ERR_NAK);
+    CHECK_EQ(rig.fake.read_transactions, 1);
+
+    acs_instr_stats_t stats;
+    acs_instr_snapshot(&rig.instr, &stats);
+    CHECK_EQ(stats.transactions[ACS_INSTR_READ], 0);
+    CHECK_EQ(stats.reads[0x20], 0);
+    CHECK_EQ(stats.naks, 0);
+    CHECK_EQ(stats.retries, 0);
+    CHECK_EQ(rig.clock.now_ns, 0);
+}
+
+#endif // ACS_INSTRUMENT
+
+int main(void)
+{
+    RUN(test_buckets);
+#if ACS_INSTRUMENT
+    RUN(test_per_register_counts);
+    RUN(test_latency_histogram);
+    RUN(test_errors_and_retries);
+    RUN(test_read_multi);
+    RUN(test_eec_counts);
+    return test_report("instr");
+#else
+    RUN(test_compiled_out);
+    return test_report("instr (compiled out)");
+#endif
+}
@@ -0,0 +1,342 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include "ACS71020.h"
+#include "test.h"
+
+#if defined(__linux__)
+
+#include <errno.h>
+#include <time.h>
+#include <linux/spi/spidev.h>
+#include "ACS71020_linux.h"
+
+#define ADDR    0x60U
+#define DEVICES 4U
+
+typedef struct
+{
+    acs_fake_t       fakes[DEVICES];
+    acs_fake_bus_t   bus;
+    acs_transport_t  target;        // The fake bus the fake kernel drives
+    acs_linux_fake_t kernel;
+    acs_linux_ops_t  ops;
+    acs_linux_t      port;
+    acs_transport_t  transport;     // The Linux transport under test
+} rig_t;
+
+/**
+ * @brief Fake devices at ADDR onwards, measurement words tagged with the
+ * device and register so that a swapped block shows.
+ */
+static void rig_init(rig_t *rig)
+{
+    acs_fake_t *devices[DEVICES];
+    acs_transport_t unused;
+
+    for (uint8_t d = 0; d < DEVICES; d++)
+    {
+        acs_transport_fake_init(&unused, &rig->fakes[d], (uint8_t)(ADDR + d));
+        for (uint8_t r = ACS_REG_MEAS_FIRST; r <= ACS_REG_MEAS_LAST; r++)
+            rig->fakes[d].regs[r] = 0xA5000000U | (uint32_t)d << 16 | (uint32_t)r << 8 | r;
+        devices[d] = &rig->fakes[d];
+    }
+    (void)acs_transport_fake_bus_init(&rig->target, &rig->bus, devices, DEVICES);
+    acs_linux_fake_ops(&rig->ops, &rig->kernel, &rig->target);
+}
+
+static void rig_open_i2c(rig_t *rig)
+{
+    rig_init(rig);
+    CHECK_EQ(acs_linux_open_i2c(&rig->port, "/dev/i2c-1", &rig->ops), ACS_OK);
+    acs_transport_linux_init(&rig->transport, &rig->port);
+}
+
+static void rig_open_spi(rig_t *rig)
+{
+    rig_init(rig);
+    rig->kernel.spi_dev_addr = ADDR + 1U;
+    CHECK_EQ(acs_linux_open_spi(&rig->port, "/dev/spidev0.0", 1000000U, &rig->ops), ACS_OK);
+    acs_transport_linux_init(&rig->transport, &rig->port);
+}
+
+static void check_snapshot(const acs_snapshot_t *snap, const acs_fake_t *fake)
+{
+    CHECK(memcmp(snap->words, &fake->regs[ACS_REG_MEAS_FIRST], sizeof(snap->words)) == 0);
+}
+
+static void test_i2c_snapshot(void)
+{
+    static rig_t rig;
+    acs_device_t dev;
+    acs_snapshot_t snap;
+
+    rig_open_i2c(&rig);
+    CHECK_EQ(rig.kernel.opens, 1);
+    acs_device_init(&dev, &rig.transport, ADDR + 2U);
+
+    CHECK_EQ(acs_read_snapshot(&dev, &snap), ACS_OK);
+    CHECK_EQ(rig.kernel.ioctls, 1);
+    CHECK_EQ(rig.kernel.messages, 2);   // Address write, data read
+    check_snapshot(&snap, &rig.fakes[2]);
+
+    CHECK_EQ(acs_write_register(&dev, 0x0BU, 0x11223344U), ACS_OK);
+    CHECK_EQ(rig.fakes[2].regs[0x0B], 0x11223344U);
+
+    acs_device_init(&dev, &rig.transport, ADDR + DEVICES);
+    CHECK_EQ(acs_read_snapshot(&dev, &snap), ACS_ERR_NAK);
+    CHECK_EQ(rig.port.errors, 1);
+
+    acs_linux_close(&rig.port);
+    CHECK_EQ(rig.kernel.closes, 1);
+}
+
+/**
+ * @brief 30 snapshots round robin over the devices: 21 blocks in the first
+ * ioctl, the other 9 in a second one.
+ */
+static void test_i2c_sweep_batches(void)
+{
+    static rig_t rig;
+    uint32_t words[30][ACS_SNAPSHOT_WORDS];
+    acs_xfer_t xfers[30];
+
+    rig_open_i2c(&rig);
+    for (uint8_t i = 0; i < 30U; i++)
+        xfers[i] = (acs_xfer_t){ (uint8_t)(ADDR + i % DEVICES), ACS_REG_MEAS_FIRST,
+                                 ACS_SNAPSHOT_WORDS, ACS_ERR_BUS, words[i] };
+
+    CHECK_EQ(acs_transport_read_multi(&rig.transport, xfers, 21U), ACS_OK);
+    CHECK_EQ(rig.kernel.ioctls, 1);
+    CHECK_EQ(rig.kernel.messages, 42);
+
+    CHECK_EQ(acs_transport_read_multi(&rig.transport, xfers, 30U), ACS_OK);
+    CHECK_EQ(rig.kernel.ioctls, 3);
+    CHECK_EQ(rig.kernel.messages, 42 + 60);
+    CHECK_EQ(rig.port.errors, 0);
+
+    for (uint8_t i = 0; i < 30U; i++)
+    {
+        CHECK_EQ(xfers[i].status, ACS_OK);
+        CHECK(memcmp(words[i], &rig.fakes[i % DEVICES].regs[ACS_REG_MEAS_FIRST],
+                     sizeof(words[i])) == 0);
+    }
+}
+
+/**
+ * @brief A failed I2C_RDWR reports nothing per block, so each block is
+ * retried on its own.
+ */
+static void test_i2c_batch_fallback(void)
+{
+    static rig_t rig;
+    uint32_t words[5][ACS_SNAPSHOT_WORDS];
+    acs_xfer_t xfers[5];
+
+    rig_open_i2c(&rig);
+    for (uint8_t i = 0; i < 5U; i++)
+        xfers[i] = (acs_xfer_t){ (uint8_t)(ADDR + i), ACS_REG_MEAS_FIRST,
+                                 ACS_SNAPSHOT_WORDS, ACS_ERR_BUS, words[i] };
+
+    // Transient failure of the whole batch, every retry succeeds
+    rig.kernel.fail_errno = EIO;
+    CHECK_EQ(acs_transport_read_multi(&rig.transport, xfers, 4U), ACS_OK);
+    CHECK_EQ(rig.kernel.ioctls, 1 + 4);
+    CHECK_EQ(rig.port.errors, 1);
+    for (uint8_t i = 0; i < 4U; i++)
+    {
+        CHECK_EQ(xfers[i].status, ACS_OK);
+        CHECK(memcmp(words[i], &rig.fakes[i].regs[ACS_REG_MEAS_FIRST], sizeof(words[i])) == 0);
+    }
+
+    // An absent device fails the batch, the retries single it out
+    memset(words, 0, sizeof(words));
+    CHECK_EQ(acs_transport_read_multi(&rig.transport, xfers, 5U), ACS_OK);
+    CHECK_EQ(rig.kernel.ioctls, 5 + 1 + 5);
+    for (uint8_t i = 0; i < 4U; i++)
+        CHECK_EQ(xfers[i].status, ACS_OK);
+    CHECK_EQ(xfers[4].status, ACS_ERR_NAK);
+    CHECK_EQ(words[3][0], rig.fakes[3].regs[ACS_REG_MEAS_FIRST]);
+
+    // A NAK on a single read maps to ACS_ERR_NAK, anything else to ACS_ERR_BUS
+    rig.kernel.fail_errno = EREMOTEIO;
+    CHECK_EQ(rig.transport.read(rig.transport.ctx, ADDR, ACS_REG_MEAS_FIRST, words[0], 1U),
+             ACS_ERR_NAK);
+    rig.kernel.fail_errno = ETIMEDOUT;
+    CHECK_EQ(rig.transport.read(rig.transport.ctx, ADDR, ACS_REG_MEAS_FIRST, words[0], 1U),
+             ACS_ERR_BUS);
+}
+
+/* SPI, with the transfers of every SPI_IOC_MESSAGE recorded on the way */
+
+typedef struct
+{
+    int      (*ioctl)(void *ctx, int fd, unsigned long request, void *arg);
+    uint32_t   messages;
+    uint32_t   transfers[4];
+    uint8_t    cs_change[4][ACS_LINUX_SPI_BATCH];
+} spi_spy_t;
+
+static spi_spy_t spy;
+
+static int spy_ioctl(void *ctx, int fd, unsigned long request, void *arg)
+{
+    if (_IOC_TYPE(request) == SPI_IOC_MAGIC && _IOC_NR(request) == 0U && spy.messages < 4U)
+    {
+        const struct spi_ioc_transfer *tr = arg;
+        uint32_t n = _IOC_SIZE(request) / sizeof(*tr);
+
+        spy.transfers[spy.messages] = n;
+        for (uint32_t i = 0; i < n && i < ACS_LINUX_SPI_BATCH; i++)
+            spy.cs_change[spy.messages][i] = tr[i].cs_change;
+        spy.messages++;
+    }
+    return spy.ioctl(ctx, fd, request, arg);
+}
+
+static void test_spi_snapshot(void)
+{
+    static rig_t rig;
+    acs_device_t dev;
+    acs_snapshot_t snap;
+
+    rig_open_spi(&rig);
+    CHECK_EQ(rig.kernel.ioctls, 3);     // Mode, word size and clock
+    acs_device_init(&dev, &rig.transport, 0U);
+
+    CHECK_EQ(acs_read_snapshot(&dev, &snap), ACS_OK);
+    CHECK_EQ(rig.kernel.ioctls, 4);
+    CHECK_EQ(rig.kernel.messages, 1);
+    check_snapshot(&snap, &rig.fakes[1]);
+
+    CHECK_EQ(acs_write_register(&dev, 0x0CU, 0x55667788U), ACS_OK);
+    CHECK_EQ(rig.fakes[1].regs[0x0C], 0x55667788U);
+
+    rig.kernel.fail_errno = EIO;
+    CHECK_EQ(acs_read_snapshot(&dev, &snap), ACS_ERR_BUS);
+}
+
+/**
+ * @brief Chip select is released between the blocks of a batch, but not
+ * after the last one of each SPI_IOC_MESSAGE.
+ */
+static void test_spi_batch_cs_change(void)
+{
+    static rig_t rig;
+    uint32_t words[20][ACS_SNAPSHOT_WORDS];
+    acs_xfer_t xfers[20];
+
+    rig_init(&rig);
+    rig.kernel.spi_dev_addr = ADDR + 3U;
+    memset(&spy, 0, sizeof(spy));
+    spy.ioctl     = rig.ops.ioctl;
+    rig.ops.ioctl = spy_ioctl;
+    CHECK_EQ(acs_linux_open_spi(&rig.port, "/dev/spidev0.0", 1000000U, &rig.ops), ACS_OK);
+    acs_transport_linux_init(&rig.transport, &rig.port);
+
+    for (uint8_t i = 0; i < 20U; i++)
+        xfers[i] = (acs_xfer_t){ 0U, (uint8_t)(ACS_REG_MEAS_FIRST + i % 2U),
+                                 (uint8_t)(ACS_SNAPSHOT_WORDS - i % 2U), ACS_ERR_BUS, words[i] };
+
+    CHECK_EQ(acs_transport_read_multi(&rig.transport, xfers, 20U), ACS_OK);
+    CHECK_EQ(spy.messages, 2);
+    CHECK_EQ(spy.transfers[0], ACS_LINUX_SPI_BATCH);
+    CHECK_EQ(spy.transfers[1], 20U - ACS_LINUX_SPI_BATCH);
+    for (uint8_t m = 0; m < 2U; m++)
+        for (uint32_t i = 0; i < spy.transfers[m]; i++)
+            CHECK_EQ(spy.cs_change[m][i], i + 1U < spy.transfers[m]);
+
+    for (uint8_t i = 0; i < 20U; i++)
+    {
+        CHECK_EQ(xfers[i].status, ACS_OK);
+        CHECK(memcmp(words[i], &rig.fakes[3].regs[xfers[i].reg_addr],
+                     4U * xfers[i].count) == 0);
+    }
+
+    // A batch of one has nothing to separate
+    CHECK_EQ(acs_transport_read_multi(&rig.transport, xfers, 1U), ACS_OK);
+    CHECK_EQ(spy.messages, 3);
+    CHECK_EQ(spy.transfers[2], 1);
+    CHECK_EQ(spy.cs_change[2][0], 0);
+
+    // SPI has one result per message, a failure fails every block of it
+    rig.kernel.fail_errno = EIO;
+    CHECK_EQ(acs_transport_read_multi(&rig.transport, xfers, 3U), ACS_OK);
+    for (uint8_t i = 0; i < 3U; i++)
+        CHECK_EQ(xfers[i].status, ACS_ERR_BUS);
+}
+
+static void on_poll(void *user, const acs_xfer_t *xfers, uint8_t count, uint64_t now_us)
+{
+    uint32_t *calls = user;
+
+    (void)now_us;
+    if (count == 1U && xfers[0].status == ACS_OK)
+        (*calls)++;
+}
+
+/**
+ * @brief The poller runs its batch from the thread until stopped, refuses a
+ * second start while running, and can be started again once stopped.
+ */
+static void test_poller(void)
+{
+    static rig_t rig;
+    static acs_linux_poller_t poller;
+    uint32_t words[ACS_SNAPSHOT_WORDS];
+    acs_xfer_t xfer = { ADDR + 3U, ACS_REG_MEAS_FIRST, ACS_SNAPSHOT_WORDS, 0, words };
+    uint32_t calls = 0U;
+    const struct timespec tick = { 0, 1000000L };
+
+    rig_init(&rig);
+
+    // Garbage left in the struct is cleared by init, not read by start
+    memset(&poller, 0xFF, sizeof(poller));
+    acs_linux_poller_init(&poller);
+    CHECK(!poller.running);
+    acs_linux_poller_stop(&poller);
+
+    CHECK_EQ(acs_linux_poller_start(&poller, &rig.target, &xfer, 1U, 0U, 0, on_poll, &calls),
+             ACS_ERR_PARAM);
+    CHECK_EQ(acs_linux_poller_start(&poller, &rig.target, &xfer, 1U, 500U, 0, on_poll, &calls),
+             ACS_OK);
+    CHECK(poller.running);
+    CHECK_EQ(acs_linux_poller_start(&poller, &rig.target, &xfer, 1U, 500U, 0, on_poll, &calls),
+             ACS_ERR_BUSY);
+
+    for (uint32_t n = 0; n < 1000U && atomic_load(&poller.cycles) < 5U; n++)
+        nanosleep(&tick, NULL);
+    acs_linux_poller_stop(&poller);
+    CHECK(!poller.running);
+
+    uint32_t cycles = atomic_load(&poller.cycles);
+    CHECK(cycles >= 5U);
+    CHECK_EQ(calls, cycles);
+    CHECK(memcmp(words, &rig.fakes[3].regs[ACS_REG_MEAS_FIRST], sizeof(words)) == 0);
+
+    // A stopped poller starts again with fresh counters
+    CHECK_EQ(acs_linux_poller_start(&poller, &rig.target, &xfer, 1U, 500U, 0, on_poll, &calls),
+             ACS_OK);
+    acs_linux_poller_stop(&poller);
+    CHECK_EQ(calls, cycles + atomic_load(&poller.cycles));
+}
+
+int main(void)
+{
+    RUN(test_i2c_snapshot);
+    RUN(test_i2c_sweep_batches);
+    RUN(test_i2c_batch_fallback);
+    RUN(test_spi_snapshot);
+    RUN(test_spi_batch_cs_change);
+    RUN(test_poller);
+    return test_report("linux");
+}
+
+#else
+
+int main(void)
+{
+    return test_report("linux (not built)");
+}
+
+#endif // __linux__
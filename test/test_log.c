@@ -0,0 +1,180 @@
+#define _POSIX_C_SOURCE 200112L
+#define _DEFAULT_SOURCE         // mkstemp
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "ACS71020.h"
+#include "ACS71020_log.h"
+#include "test.h"
+
+static char path[] = "/tmp/acs_log_XXXXXX";
+
+/**
+ * @brief A snapshot whose words are all derived from n, so that every record
+ * of a log can be told apart from its neighbours.
+ */
+static void make_snapshot(acs_snapshot_t *snap, uint32_t n)
+{
+    memset(snap, 0, sizeof(*snap));
+    snap->regs.reg_0x20.register_value = acs_0x20_irms_set(0U, n);
+    snap->regs.reg_0x21.register_value = acs_0x21_pactive_set(0U, (uint32_t)(-(int32_t)n));
+    snap->regs.reg_0x2D.register_value = acs_0x2D_pospf_set(0U, (n & 1U) != 0U);
+}
+
+/**
+ * @brief Writes a log, appends to it after reopening, and walks the records
+ * back from the mapping.
+ */
+static void test_round_trip(void)
+{
+    acs_log_writer_t writer;
+    acs_log_reader_t reader;
+    acs_snapshot_t snap;
+    const acs_full_scale_t fs = { .current = 30.0, .voltage = 275.0, .power = 8250.0 };
+    const uint32_t eeprom[ACS_EEPROM_WORDS] = { 0x0B, 0x0C, 0x0D, 0x0E, 0x0F };
+
+    CHECK_EQ(acs_log_create(&writer, path, &fs, eeprom), ACS_OK);
+    for (uint32_t n = 0; n < 10U; n++)
+    {
+        make_snapshot(&snap, n);
+        CHECK_EQ(acs_log_append(&writer, 96U, 1000U * n, &snap), ACS_OK);
+    }
+    CHECK_EQ(writer.records, 10);
+    CHECK_EQ(acs_log_close(&writer), ACS_OK);
+    CHECK(writer.file == NULL);
+    CHECK_EQ(acs_log_close(&writer), ACS_OK);
+
+    // A torn last record is dropped on reopen and overwritten by the next
+    FILE *f = fopen(path, "ab");
+    CHECK(f != NULL);
+    CHECK_EQ(fwrite("torn", 4U, 1U, f), 1);
+    fclose(f);
+
+    CHECK_EQ(acs_log_open_append(&writer, path), ACS_OK);
+    CHECK_EQ(writer.records, 10);
+    for (uint32_t n = 10; n < 15U; n++)
+    {
+        make_snapshot(&snap, n);
+        CHECK_EQ(acs_log_append(&writer, 97U, 1000U * n, &snap), ACS_OK);
+    }
+    CHECK_EQ(acs_log_flush(&writer), ACS_OK);
+    CHECK_EQ(acs_log_close(&writer), ACS_OK);
+
+    CHECK_EQ(acs_log_open(&reader, path), ACS_OK);
+    CHECK_EQ(reader.count, 15);
+    CHECK(reader.map != NULL);
+    CHECK_EQ(memcmp(reader.header->eeprom, eeprom, sizeof(eeprom)), 0);
+
+    acs_full_scale_t got;
+    acs_log_full_scale(&reader, &got);
+    CHECK_NEAR(got.current, fs.current, 0.0);
+    CHECK_NEAR(got.voltage, fs.voltage, 0.0);
+    CHECK_NEAR(got.power, fs.power, 0.0);
+
+    for (uint32_t n = 0; n < 15U; n++)
+    {
+        const acs_log_record_t *r = &reader.records[n];
+        make_snapshot(&snap, n);
+        CHECK_EQ(r->timestamp_us, 1000U * n);
+        CHECK_EQ(r->dev_addr, n < 10U ? 96U : 97U);
+        CHECK_EQ(memcmp(&r->snap, &snap, sizeof(snap)), 0);
+    }
+
+    acs_log_close_reader(&reader);
+    CHECK(reader.map == NULL);
+    CHECK_EQ(reader.count, 0);
+}
+
+/**
+ * @brief The same file read from an aligned copy in memory.
+ */
+static void test_open_buffer(void)
+{
+    static uint64_t buffer[256];
+    acs_log_reader_t reader;
+
+    FILE *f = fopen(path, "rb");
+    CHECK(f != NULL);
+    size_t size = fread(buffer, 1U, sizeof(buffer), f);
+    fclose(f);
+    CHECK_EQ(size, sizeof(acs_log_header_t) + 15U * sizeof(acs_log_record_t));
+
+    CHECK_EQ(acs_log_open_buffer(&reader, buffer, size), ACS_OK);
+    CHECK_EQ(reader.count, 15);
+    CHECK(reader.map == NULL);
+    CHECK_EQ(reader.records[14].timestamp_us, 14000);
+
+    CHECK_EQ(acs_log_open_buffer(&reader, (const uint8_t *)buffer + 4, size - 4U), ACS_ERR_PARAM);
+    CHECK_EQ(acs_log_open_buffer(&reader, buffer, sizeof(acs_log_header_t) - 1U), ACS_ERR_PARAM);
+
+    // Any header field that does not match this build is refused
+    acs_log_header_t h;
+    memcpy(&h, buffer, sizeof(h));
+    h.version++;
+    memcpy(buffer, &h, sizeof(h));
+    CHECK_EQ(acs_log_open_buffer(&reader, buffer, size), ACS_ERR_PARAM);
+    CHECK(reader.header == NULL);
+}
+
+/**
+ * @brief Files that cannot be opened are I/O errors, files that are not logs
+ * and writers that are not open are parameter errors.
+ */
+static void test_errors(void)
+{
+    acs_log_writer_t writer = { 0 };
+    acs_log_reader_t reader;
+    acs_snapshot_t snap;
+    const acs_full_scale_t fs = { 0 };
+
+    make_snapshot(&snap, 0U);
+
+    CHECK_EQ(acs_log_create(&writer, "/nonexistent/dir/log", &fs, NULL), ACS_ERR_IO);
+    CHECK(writer.file == NULL);
+    CHECK_EQ(acs_log_open_append(&writer, "/nonexistent/dir/log"), ACS_ERR_IO);
+    CHECK_EQ(acs_log_open(&reader, "/nonexistent/dir/log"), ACS_ERR_IO);
+
+    CHECK_EQ(acs_log_append(&writer, 96U, 0U, &snap), ACS_ERR_PARAM);
+    CHECK_EQ(acs_log_append(NULL, 96U, 0U, &snap), ACS_ERR_PARAM);
+    CHECK_EQ(acs_log_flush(&writer), ACS_ERR_PARAM);
+    CHECK_EQ(acs_log_close(NULL), ACS_ERR_PARAM);
+    CHECK_EQ(acs_log_create(&writer, NULL, &fs, NULL), ACS_ERR_PARAM);
+
+    // A file too short to be a log, and one with a foreign header
+    FILE *f = fopen(path, "wb");
+    CHECK(f != NULL);
+    CHECK_EQ(fwrite("ACS71LOG", 8U, 1U, f), 1);
+    fclose(f);
+    CHECK_EQ(acs_log_open(&reader, path), ACS_ERR_PARAM);
+    CHECK_EQ(acs_log_open_append(&writer, path), ACS_ERR_PARAM);
+    CHECK(writer.file == NULL);
+
+    static const uint8_t junk[sizeof(acs_log_header_t)] = { 'n', 'o', 't', ' ', 'a', ' ', 'l', 'o', 'g' };
+    f = fopen(path, "wb");
+    CHECK(f != NULL);
+    CHECK_EQ(fwrite(junk, sizeof(junk), 1U, f), 1);
+    fclose(f);
+    CHECK_EQ(acs_log_open(&reader, path), ACS_ERR_PARAM);
+    CHECK(reader.map == NULL);
+    CHECK_EQ(acs_log_open_append(&writer, path), ACS_ERR_PARAM);
+}
+
+int main(void)
+{
+    int fd = mkstemp(path);
+    if (fd < 0)
+    {
+        perror("mkstemp");
+        return 1;
+    }
+    close(fd);
+
+    RUN(test_round_trip);
+    RUN(test_open_buffer);
+    RUN(test_errors);
+
+    unlink(path);
+    return test_report("log");
+}
@@ -0,0 +1,214 @@
+#include <string.h>
+#include "ACS71020.h"
+#include "ACS71020_pack.h"
+#include "test.h"
+
+#define VALUES 1000U
+
+static uint32_t lcg = 12345U;
+
+static uint32_t next_random(void)
+{
+    lcg = lcg * 1664525U + 1013904223U;
+    return lcg;
+}
+
+/**
+ * @brief Encodes count values as one block and checks they decode to the
+ * same values at the expected width.
+ */
+static void round_trip(const int32_t *values, uint32_t count, uint8_t width)
+{
+    uint8_t block[ACS_PACK_MAX_BLOCK_BYTES];
+    int32_t decoded[ACS_PACK_BLOCK];
+    uint32_t got = 0U;
+
+    size_t bytes = acs_pack_encode_block(values, count, block);
+    CHECK_EQ(bytes, acs_pack_block_bytes(width));
+    CHECK_EQ(block[4], width);
+    CHECK_EQ(acs_pack_decode_block(block, bytes, decoded, &got), bytes);
+    CHECK_EQ(got, count);
+    CHECK_EQ(memcmp(decoded, values, count * sizeof(int32_t)), 0);
+}
+
+static void test_block_round_trip(void)
+{
+    int32_t values[ACS_PACK_BLOCK];
+
+    // Constant, nothing but the header
+    for (uint32_t i = 0; i < ACS_PACK_BLOCK; i++)
+        values[i] = -1234;
+    round_trip(values, ACS_PACK_BLOCK, 0U);
+
+    // Steps of +1 and -1 zigzag to 2 and 1
+    for (uint32_t i = 0; i < ACS_PACK_BLOCK; i++)
+        values[i] = (i & 1U) != 0U ? 100 : 101;
+    round_trip(values, ACS_PACK_BLOCK, 2U);
+
+    // A slow ramp with a width that straddles the 32-bit lane words
+    for (uint32_t i = 0; i < ACS_PACK_BLOCK; i++)
+        values[i] = (int32_t)(i * 37U) - 2000;
+    round_trip(values, ACS_PACK_BLOCK, 7U);
+
+    // Full range jumps wrap modulo 2^32 and need every bit
+    values[0] = INT32_MIN;
+    values[1] = INT32_MAX;
+    for (uint32_t i = 2; i < ACS_PACK_BLOCK; i++)
+        values[i] = (int32_t)next_random();
+    round_trip(values, ACS_PACK_BLOCK, 32U);
+
+    // Short blocks, down to a single value
+    for (uint32_t i = 0; i < 5U; i++)
+        values[i] = (int32_t)(i * i);
+    round_trip(values, 5U, 4U);
+    round_trip(values, 1U, 0U);
+
+    CHECK_EQ(acs_pack_encode_block(values, 0U, (uint8_t[ACS_PACK_MAX_BLOCK_BYTES]){ 0 }), 0);
+    CHECK_EQ(acs_pack_encode_block(values, ACS_PACK_BLOCK + 1U, (uint8_t[ACS_PACK_MAX_BLOCK_BYTES]){ 0 }), 0);
+}
+
+static void test_block_malformed(void)
+{
+    uint8_t block[ACS_PACK_MAX_BLOCK_BYTES];
+    int32_t values[ACS_PACK_BLOCK] = { 0 };
+    uint32_t count = 0U;
+
+    for (uint32_t i = 0; i < ACS_PACK_BLOCK; i++)
+        values[i] = (int32_t)(i * 3U);
+    size_t bytes = acs_pack_encode_block(values, ACS_PACK_BLOCK, block);
+
+    CHECK_EQ(acs_pack_decode_block(block, bytes - 1U, values, &count), 0);
+    CHECK_EQ(acs_pack_decode_block(block, sizeof(acs_pack_header_t) - 1U, values, &count), 0);
+    CHECK_EQ(acs_pack_decode_block(NULL, bytes, values, &count), 0);
+
+    acs_pack_header_t h;
+    memcpy(&h, block, sizeof(h));
+    h.width = 33U;
+    memcpy(block, &h, sizeof(h));
+    CHECK_EQ(acs_pack_decode_block(block, sizeof(block), values, &count), 0);
+    h.width = 3U;
+    h.count = 0U;
+    memcpy(block, &h, sizeof(h));
+    CHECK_EQ(acs_pack_decode_block(block, sizeof(block), values, &count), 0);
+    h.count = ACS_PACK_BLOCK + 1U;
+    memcpy(block, &h, sizeof(h));
+    CHECK_EQ(acs_pack_decode_block(block, sizeof(block), values, &count), 0);
+    CHECK_EQ(count, 0);
+}
+
+/**
+ * @brief Values pushed in uneven pieces come back block by block in any
+ * order through the index.
+ */
+static void test_stream(void)
+{
+    static int32_t values[VALUES];
+    static uint8_t out[VALUES * 4U + 64U];
+    uint32_t index[16];
+    int32_t decoded[ACS_PACK_BLOCK];
+    acs_pack_stream_t stream;
+
+    for (uint32_t i = 0; i < VALUES; i++)
+        values[i] = (int32_t)(next_random() >> 20) - 2048;
+
+    CHECK_EQ(acs_pack_stream_init(&stream, out, sizeof(out), index, 16U), ACS_OK);
+    for (uint32_t i = 0; i < VALUES; )
+    {
+        uint32_t n = 1U + next_random() % 200U;
+        if (n > VALUES - i)
+            n = VALUES - i;
+        CHECK_EQ(acs_pack_stream_push(&stream, &values[i], n), ACS_OK);
+        i += n;
+    }
+    CHECK_EQ(stream.blocks, VALUES / ACS_PACK_BLOCK);
+    CHECK_EQ(acs_pack_stream_finish(&stream), ACS_OK);
+    CHECK_EQ(stream.blocks, (VALUES + ACS_PACK_BLOCK - 1U) / ACS_PACK_BLOCK);
+    CHECK_EQ(stream.values, VALUES);
+    CHECK(stream.used < sizeof(values));
+
+    for (uint32_t b = stream.blocks; b-- > 0U; )
+    {
+        uint32_t expected = b == stream.blocks - 1U ? VALUES % ACS_PACK_BLOCK : ACS_PACK_BLOCK;
+        CHECK_EQ(acs_pack_stream_block(out, stream.used, index, stream.blocks, b, decoded), expected);
+        CHECK_EQ(memcmp(decoded, &values[b * ACS_PACK_BLOCK], expected * sizeof(int32_t)), 0);
+    }
+    CHECK_EQ(acs_pack_stream_block(out, stream.used, index, stream.blocks, stream.blocks, decoded), 0);
+    CHECK_EQ(acs_pack_stream_init(NULL, out, sizeof(out), index, 16U), ACS_ERR_PARAM);
+}
+
+/**
+ * @brief A full index stops the stream and keeps the value that did not fit
+ * out of the pending block.
+ */
+static void test_stream_full(void)
+{
+    static int32_t values[3U * ACS_PACK_BLOCK];
+    static uint8_t out[4U * ACS_PACK_MAX_BLOCK_BYTES];
+    uint32_t index[2];
+    acs_pack_stream_t stream;
+
+    for (uint32_t i = 0; i < 3U * ACS_PACK_BLOCK; i++)
+        values[i] = (int32_t)i;
+
+    acs_pack_stream_init(&stream, out, sizeof(out), index, 2U);
+    CHECK_EQ(acs_pack_stream_push(&stream, values, 3U * ACS_PACK_BLOCK), ACS_ERR_FULL);
+    CHECK_EQ(stream.blocks, 2);
+    CHECK_EQ(stream.values, 2U * ACS_PACK_BLOCK);
+    CHECK_EQ(stream.pending_count, ACS_PACK_BLOCK - 1U);
+
+    // Out of bytes rather than index entries, a ramp packs at width 2
+    acs_pack_stream_init(&stream, out, acs_pack_block_bytes(2U), index, 2U);
+    CHECK_EQ(acs_pack_stream_push(&stream, values, 2U * ACS_PACK_BLOCK), ACS_ERR_FULL);
+    CHECK_EQ(stream.blocks, 1);
+}
+
+/**
+ * @brief When only the icodes stream runs out of room, the vcodes stream is
+ * put back so both still describe the same samples.
+ */
+static void test_push_samples_lockstep(void)
+{
+    static acs_sample_t samples[5U * ACS_PACK_BLOCK];
+    static uint8_t vout[8U * ACS_PACK_MAX_BLOCK_BYTES];
+    static uint8_t iout[8U * ACS_PACK_MAX_BLOCK_BYTES];
+    uint32_t vindex[8];
+    uint32_t iindex[2];
+    int32_t decoded[ACS_PACK_BLOCK];
+    acs_pack_stream_t vcodes;
+    acs_pack_stream_t icodes;
+
+    for (uint32_t i = 0; i < 5U * ACS_PACK_BLOCK; i++)
+    {
+        samples[i].vcodes = (int32_t)(i * 5U);
+        samples[i].icodes = -(int32_t)i;
+        samples[i].seq    = i;
+    }
+
+    acs_pack_stream_init(&vcodes, vout, sizeof(vout), vindex, 8U);
+    acs_pack_stream_init(&icodes, iout, sizeof(iout), iindex, 2U);
+
+    // Half a block first, so the groups do not line up with the blocks
+    CHECK_EQ(acs_pack_stream_push_samples(&vcodes, &icodes, samples, ACS_PACK_BLOCK / 2U), ACS_OK);
+    CHECK_EQ(acs_pack_stream_push_samples(&vcodes, &icodes, &samples[ACS_PACK_BLOCK / 2U],
+                                          4U * ACS_PACK_BLOCK), ACS_ERR_FULL);
+
+    CHECK_EQ(vcodes.blocks, icodes.blocks);
+    CHECK_EQ(vcodes.values, icodes.values);
+    CHECK_EQ(vcodes.pending_count, icodes.pending_count);
+    CHECK_EQ(vcodes.values + vcodes.pending_count, 2U * ACS_PACK_BLOCK + ACS_PACK_BLOCK / 2U);
+
+    CHECK_EQ(acs_pack_stream_block(vout, vcodes.used, vindex, vcodes.blocks, 1U, decoded), ACS_PACK_BLOCK);
+    CHECK_EQ(decoded[0], (int32_t)(ACS_PACK_BLOCK * 5U));
+    CHECK_EQ(acs_pack_stream_block(iout, icodes.used, iindex, icodes.blocks, 1U, decoded), ACS_PACK_BLOCK);
+    CHECK_EQ(decoded[ACS_PACK_BLOCK - 1U], -(int32_t)(2U * ACS_PACK_BLOCK - 1U));
+}
+
+int main(void)
+{
+    RUN(test_block_round_trip);
+    RUN(test_block_malformed);
+    RUN(test_stream);
+    RUN(test_stream_full);
+    RUN(test_push_samples_lockstep);
+    return test_report("pack");
+}
@@ -0,0 +1,145 @@
+#include "ACS71020.h"
+#include "ACS71020_phase.h"
+#include "ACS71020_sim.h"
+#include "test.h"
+
+#define CYCLES      5U
+#define MAX_SAMPLES (CYCLES * 32000U / 50U)
+
+typedef struct
+{
+    acs_transport_t transport;
+    acs_sim_t       sim;
+    acs_device_t    dev;
+    acs_shadow_t    shadow;
+    acs_sample_t    samples[MAX_SAMPLES];
+    size_t          count;
+} rig_t;
+
+/**
+ * @brief Resistive load, current in phase with voltage but for the sensor's
+ * own lag, at 32 kHz or 4 kHz.
+ */
+static void rig_init(rig_t *rig, float lag_us, bool slow_adc)
+{
+    acs_sim_config_t config;
+
+    acs_sim_default_config(&config);
+    config.line_hz        = 50.0f;
+    config.current_lag_us = lag_us;
+    acs_sim_init(&rig->sim, &config);
+    acs_transport_sim_init(&rig->transport, &rig->sim);
+    acs_device_init(&rig->dev, &rig->transport, config.dev_addr);
+    acs_shadow_init(&rig->shadow, &rig->dev);
+
+    rig->sim.regs[0x0E] = eeprom_0x0E_vadc_rate_set_set(rig->sim.regs[0x0E], slow_adc);
+}
+
+/**
+ * @brief Whole line cycles of vcodes and icodes, one per ADC sample, taken
+ * straight from the register file so that bus time does not skew them.
+ */
+static float rig_capture(rig_t *rig)
+{
+    uint32_t rate = acs_adc_rate_hz(rig->sim.regs[0x0E]);
+
+    // Let the delay lines fill
+    acs_sim_advance(&rig->sim, 20000000U);
+
+    rig->count = CYCLES * rate / 50U;
+    for (size_t n = 0; n < rig->count; n++)
+    {
+        acs_sim_advance(&rig->sim, 1000000000U / rate);
+        rig->samples[n].vcodes = acs_0x2A_vcodes_sget(rig->sim.regs[0x2A]);
+        rig->samples[n].icodes = acs_0x2B_icodes_sget(rig->sim.regs[0x2B]);
+        rig->samples[n].seq    = (uint32_t)n;
+    }
+    return (float)rate;
+}
+
+static void test_step_sizes(void)
+{
+    CHECK_EQ(acs_chan_del_step_ns(eeprom_0x0E_vadc_rate_set_set(0U, 0U)) * ACS_PHASE_DELAY_MAX, 218750);
+    CHECK_EQ(acs_chan_del_step_ns(eeprom_0x0E_vadc_rate_set_set(0U, 1U)) * ACS_PHASE_DELAY_MAX, 875000);
+}
+
+/**
+ * @brief Solves, applies, captures again and checks what is left, for a lag
+ * that needs steps chan_del_sel steps on the channel del_current selects.
+ */
+static void check_tuning(float lag_us, bool slow_adc, uint8_t steps, uint8_t del_current)
+{
+    static rig_t rig;
+    acs_phase_result_t result;
+    acs_phase_check_t check;
+    float step_us = slow_adc ? 125.0f : 31.25f;
+
+    rig_init(&rig, lag_us, slow_adc);
+    float rate = rig_capture(&rig);
+
+    CHECK_EQ(acs_phase_solve(rig.samples, rig.count, rate, rig.sim.regs[0x0D],
+                             rig.sim.regs[0x0E], &result), ACS_OK);
+    CHECK_NEAR(result.lag_us, lag_us, 2.0);
+    CHECK_NEAR(result.sensor_lag_us, lag_us, 2.0);
+    CHECK_EQ(result.chan_del_sel, steps);
+    CHECK_EQ(result.ichan_del_en, del_current);
+    CHECK_NEAR(result.residual_us, lag_us - (del_current ? -1.0f : 1.0f) * steps * step_us, 2.0);
+
+    CHECK_EQ(acs_phase_apply(&result, &rig.shadow), ACS_OK);
+    CHECK_EQ(eeprom_0x0D_chan_del_sel_get(rig.sim.regs[0x0D]), steps);
+    CHECK_EQ(eeprom_0x0D_ichan_del_en_get(rig.sim.regs[0x0D]), del_current);
+
+    // The delay line now takes out all but the residual
+    float residual_us = result.residual_us;
+    rig_capture(&rig);
+    CHECK_EQ(acs_phase_solve(rig.samples, rig.count, rate, rig.sim.regs[0x0D],
+                             rig.sim.regs[0x0E], &result), ACS_OK);
+    CHECK_NEAR(result.lag_us, residual_us, 2.0);
+    CHECK_NEAR(result.sensor_lag_us, lag_us, 2.0);
+    CHECK_EQ(result.chan_del_sel, steps);
+
+    CHECK_EQ(acs_phase_verify(&rig.dev, &result, 50.0f, 20U, &check), ACS_OK);
+    CHECK_EQ(check.reads, 20);
+}
+
+static void test_tuning_32khz(void)
+{
+    check_tuning(95.0f, false, 3U, 0U);     // 3 steps of 31.25 us
+    check_tuning(-160.0f, false, 5U, 1U);   // Current leads, delay it instead
+}
+
+static void test_tuning_4khz(void)
+{
+    check_tuning(480.0f, true, 4U, 0U);     // 4 steps of 125 us, 2 samples
+    check_tuning(-390.0f, true, 3U, 1U);    // An odd number of half samples
+}
+
+static void test_out_of_range(void)
+{
+    static rig_t rig;
+    acs_phase_result_t result;
+
+    rig_init(&rig, 300.0f, false);
+    float rate = rig_capture(&rig);
+
+    CHECK_EQ(acs_phase_solve(rig.samples, rig.count, rate, rig.sim.regs[0x0D],
+                             rig.sim.regs[0x0E], &result), ACS_ERR_RANGE);
+    CHECK_EQ(result.chan_del_sel, ACS_PHASE_DELAY_MAX);
+    CHECK_NEAR(result.lag_us, 300.0, 2.0);
+
+    // The same lag is within reach at 4 kHz
+    rig_init(&rig, 300.0f, true);
+    rate = rig_capture(&rig);
+    CHECK_EQ(acs_phase_solve(rig.samples, rig.count, rate, rig.sim.regs[0x0D],
+                             rig.sim.regs[0x0E], &result), ACS_OK);
+    CHECK_EQ(result.chan_del_sel, 2);
+}
+
+int main(void)
+{
+    RUN(test_step_sizes);
+    RUN(test_tuning_32khz);
+    RUN(test_tuning_4khz);
+    RUN(test_out_of_range);
+    return test_report("phase");
+}
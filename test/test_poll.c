@@ -0,0 +1,256 @@
+#include <string.h>
+#include "ACS71020.h"
+#include "ACS71020_poll.h"
+#include "ACS71020_sim.h"
+#include "test.h"
+
+#define RUN_US      10000000U
+#define CYCLE_WORDS 10U         // 0x20 to 0x29
+
+typedef struct
+{
+    acs_transport_t transport;
+    acs_sim_t       sim;
+    acs_device_t    dev;
+    acs_poll_t      poll;
+
+    uint32_t        calls;
+    uint32_t        read_us;
+} rig_t;
+
+static void on_snapshot(void *user, const acs_snapshot_t *snap)
+{
+    rig_t *rig = user;
+
+    (void)snap;
+    rig->calls++;
+}
+
+/**
+ * @brief A simulator at line_hz, at 4 kHz when slow, and a poller assuming
+ * nominal_hz.
+ */
+static void rig_init(rig_t *rig, float line_hz, bool slow, float nominal_hz, uint32_t guard_us)
+{
+    acs_sim_config_t config;
+
+    memset(rig, 0, sizeof(*rig));
+    acs_sim_default_config(&config);
+    config.line_hz = line_hz;
+    acs_sim_init(&rig->sim, &config);
+    if (slow)
+        rig->sim.regs[0x0E] = eeprom_0x0E_vadc_rate_set_set(0U, 1U);
+    acs_transport_sim_init(&rig->transport, &rig->sim);
+    acs_device_init(&rig->dev, &rig->transport, config.dev_addr);
+
+    rig->read_us = (uint32_t)((acs_sim_transaction_ns(&rig->sim, ACS_SNAPSHOT_WORDS, true) + 999U) / 1000U);
+    acs_poll_init(&rig->poll, &rig->dev, rig->sim.regs[0x0E], nominal_hz, guard_us,
+                  rig->read_us, on_snapshot, rig);
+}
+
+/**
+ * @brief Runs the simulator to end_us, reading whenever the poller asks to.
+ */
+static void run_until(rig_t *rig, uint64_t end_us)
+{
+    for (;;)
+    {
+        uint64_t now = acs_sim_now_us(&rig->sim);
+        if (now >= end_us)
+            break;
+
+        uint64_t due = acs_poll_next_due(&rig->poll);
+        if (due > now)
+            acs_sim_advance(&rig->sim, (due - now) * 1000U);
+        else
+            CHECK(acs_poll_run(&rig->poll, now) >= 0);
+    }
+}
+
+/**
+ * @brief Times the window registers change in the first end_us of a
+ * simulator like the rig's, watched every 10 us.
+ */
+static uint32_t window_changes(float line_hz, bool slow, uint64_t end_us)
+{
+    static acs_sim_t sim;
+    acs_sim_config_t config;
+    uint32_t last[CYCLE_WORDS] = { 0 };
+    uint32_t changes = 0U;
+
+    acs_sim_default_config(&config);
+    config.line_hz = line_hz;
+    acs_sim_init(&sim, &config);
+    if (slow)
+        sim.regs[0x0E] = eeprom_0x0E_vadc_rate_set_set(0U, 1U);
+
+    for (uint64_t t = 0; t < end_us; t += 10U)
+    {
+        acs_sim_advance(&sim, 10000U);
+        if (memcmp(last, &sim.regs[ACS_REG_MEAS_FIRST], sizeof(last)) != 0)
+        {
+            memcpy(last, &sim.regs[ACS_REG_MEAS_FIRST], sizeof(last));
+            changes++;
+        }
+    }
+    return changes;
+}
+
+/**
+ * @brief Frequency and delivery at one line frequency. The first read
+ * returns the all-zero registers, which count as new data too; the change
+ * of the last window may not have been read yet.
+ */
+static void check_line(float line_hz, bool slow, float nominal_hz, float tolerance_hz)
+{
+    static rig_t rig;
+
+    rig_init(&rig, line_hz, slow, nominal_hz, 500U);
+    run_until(&rig, RUN_US);
+
+    CHECK_NEAR(acs_poll_line_hz(&rig.poll), line_hz, tolerance_hz);
+    CHECK_EQ(rig.poll.saturated, !slow);
+    CHECK_EQ(rig.poll.state, ACS_POLL_TRACK);
+    CHECK_EQ(rig.poll.acquisitions, 1);
+    CHECK_EQ(rig.poll.bus_errors, 0);
+
+    // The last read may have started just before the end
+    uint32_t changes = window_changes(line_hz, slow, RUN_US + rig.read_us);
+    CHECK(rig.calls - 1U == changes || rig.calls == changes);
+    CHECK_EQ(rig.poll.fresh, rig.calls);
+}
+
+/**
+ * @brief At 32 kHz numptsout saturates, the period comes from the spacing of
+ * the window ends the poller located.
+ */
+static void test_line_hz_saturated(void)
+{
+    check_line(49.8f, false, 50.0f, 0.1f);
+    check_line(50.2f, false, 50.0f, 0.1f);
+    check_line(59.8f, false, 60.0f, 0.1f);
+    check_line(60.0f, false, 60.0f, 0.1f);
+    check_line(60.2f, false, 60.0f, 0.1f);
+}
+
+/**
+ * @brief At 4 kHz numptsout holds the cycle. It alternates between the whole
+ * counts around the period, smoothed over about eight windows, so one count
+ * in 67 shows as a few tenths of a hertz.
+ */
+static void test_line_hz_numptsout(void)
+{
+    check_line(50.0f, true, 60.0f, 0.01f);
+    check_line(50.2f, true, 50.0f, 0.3f);
+    check_line(60.0f, true, 50.0f, 0.3f);
+}
+
+/**
+ * @brief A guard shorter than a snapshot read is raised to it. Stepping
+ * finer than the read biased the located window ends, 49.2 Hz were measured
+ * at 50.2 Hz with 300 us on a 400 kHz bus.
+ */
+static void test_guard_raised_to_read_time(void)
+{
+    static rig_t rig;
+
+    rig_init(&rig, 50.2f, false, 50.0f, 300U);
+    CHECK(rig.read_us > 1300U);
+    CHECK_EQ(rig.poll.guard_us, rig.read_us);
+    run_until(&rig, RUN_US);
+    CHECK_NEAR(acs_poll_line_hz(&rig.poll), 50.2, 0.1);
+
+    rig_init(&rig, 50.2f, false, 50.0f, 2000U);
+    CHECK_EQ(rig.poll.guard_us, 2000);
+}
+
+/**
+ * @brief Acquisition reads every guard_us until it brackets a window end,
+ * tracking then reads about once per window, with a probe before the end
+ * every ACS_POLL_PROBE_EVERY windows.
+ */
+static void test_acquire_track_probe(void)
+{
+    static rig_t rig;
+
+    rig_init(&rig, 50.2f, false, 50.0f, 500U);
+    CHECK_EQ(rig.poll.state, ACS_POLL_ACQUIRE);
+    CHECK_EQ(acs_poll_next_due(&rig.poll), 0);
+
+    // Until the first window closes, every read is guard_us after the last
+    run_until(&rig, 15000U);
+    CHECK_EQ(rig.poll.state, ACS_POLL_ACQUIRE);
+    CHECK(rig.poll.reads >= 15000U / (rig.read_us + rig.poll.guard_us));
+
+    run_until(&rig, 100000U);
+    CHECK_EQ(rig.poll.state, ACS_POLL_TRACK);
+    CHECK(rig.poll.has_edge);
+
+    uint32_t reads = rig.poll.reads;
+    uint32_t probes = rig.poll.probes;
+    run_until(&rig, 100000U + RUN_US);
+    uint32_t windows = (uint32_t)(50.2 * RUN_US / 1e6);
+    CHECK(rig.poll.reads - reads < 2U * windows);
+    CHECK_NEAR(rig.poll.probes - probes, windows / ACS_POLL_PROBE_EVERY, 3.0);
+    CHECK_EQ(rig.poll.acquisitions, 1);
+
+    // Nothing is read before it is due
+    uint32_t transactions = rig.sim.transactions;
+    uint64_t now = acs_sim_now_us(&rig.sim);
+    if (acs_poll_next_due(&rig.poll) > now)
+    {
+        CHECK_EQ(acs_poll_run(&rig.poll, now), 0);
+        CHECK_EQ(rig.sim.transactions, transactions);
+    }
+}
+
+/**
+ * @brief At exactly 50 Hz and 32 kHz every window repeats the one before.
+ * Each is read, retried ACS_POLL_RETRIES times and skipped, and the period
+ * stays at its nominal value.
+ */
+static void test_stale_retries(void)
+{
+    static rig_t rig;
+
+    rig_init(&rig, 50.0f, false, 50.0f, 500U);
+    run_until(&rig, RUN_US);
+
+    CHECK_EQ(rig.calls, 2);
+    CHECK_EQ(rig.poll.state, ACS_POLL_TRACK);
+    CHECK_NEAR(acs_poll_line_hz(&rig.poll), 50.0, 0.05);
+
+    uint32_t windows = 50U * RUN_US / 1000000U;
+    CHECK(rig.poll.stale >= windows * ACS_POLL_RETRIES);
+    CHECK(rig.poll.reads <= windows * (ACS_POLL_RETRIES + 1U) + 100U);
+}
+
+/**
+ * @brief A failed read counts as a bus error and is retried guard_us later.
+ */
+static void test_bus_error(void)
+{
+    static rig_t rig;
+    acs_device_t absent;
+
+    rig_init(&rig, 50.0f, false, 50.0f, 500U);
+    acs_device_init(&absent, &rig.transport, 97U);
+    rig.poll.dev = &absent;
+
+    CHECK_EQ(acs_poll_run(&rig.poll, 0U), ACS_ERR_NAK);
+    CHECK_EQ(rig.poll.bus_errors, 1);
+    CHECK_EQ(rig.poll.reads, 0);
+    CHECK_EQ(acs_poll_next_due(&rig.poll), rig.poll.guard_us);
+    CHECK_EQ(rig.calls, 0);
+}
+
+int main(void)
+{
+    RUN(test_line_hz_saturated);
+    RUN(test_line_hz_numptsout);
+    RUN(test_guard_raised_to_read_time);
+    RUN(test_acquire_track_probe);
+    RUN(test_stale_retries);
+    RUN(test_bus_error);
+    return test_report("poll");
+}
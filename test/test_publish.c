@@ -0,0 +1,192 @@
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+#include "ACS71020.h"
+#include "ACS71020_publish.h"
+#include "test.h"
+
+#define READERS   3U
+#define PUBLISHES 2000000U
+
+static void fill(acs_snapshot_t *snap, uint32_t value)
+{
+    for (uint32_t i = 0; i < ACS_SNAPSHOT_WORDS; i++)
+        snap->words[i] = value + i;
+}
+
+/**
+ * @brief Generation counting, ACS_ERR_EMPTY before the first publish and
+ * read_newer only copying what is new.
+ */
+static void test_single_thread(void)
+{
+    static acs_publish_t pub;
+    acs_snapshot_t snap;
+    acs_snapshot_t out;
+    uint64_t timestamp = 0U;
+    uint32_t generation = 0U;
+
+    acs_publish_init(&pub);
+    CHECK_EQ(acs_publish_generation(&pub), 0);
+    CHECK_EQ(acs_publish_read(&pub, &out, NULL, NULL), ACS_ERR_EMPTY);
+    CHECK_EQ(acs_publish_read_newer(&pub, &generation, &out, NULL), ACS_ERR_EMPTY);
+
+    fill(&snap, 100U);
+    acs_publish(&pub, &snap, 0x123456789ULL);
+    CHECK_EQ(acs_publish_generation(&pub), 1);
+    CHECK_EQ(acs_publish_read(&pub, &out, &timestamp, &generation), ACS_OK);
+    CHECK_EQ(memcmp(&out, &snap, sizeof(out)), 0);
+    CHECK_EQ(timestamp, 0x123456789ULL);
+    CHECK_EQ(generation, 1);
+
+    // Nothing newer than what was just read
+    memset(&out, 0, sizeof(out));
+    CHECK_EQ(acs_publish_read_newer(&pub, &generation, &out, &timestamp), ACS_ERR_EMPTY);
+    CHECK_EQ(out.words[0], 0);
+
+    fill(&snap, 200U);
+    acs_publish(&pub, &snap, 7U);
+    fill(&snap, 300U);
+    acs_publish(&pub, &snap, 8U);
+    CHECK_EQ(acs_publish_read_newer(&pub, &generation, &out, &timestamp), ACS_OK);
+    CHECK_EQ(generation, 3);
+    CHECK_EQ(out.words[ACS_SNAPSHOT_WORDS - 1U], 300U + ACS_SNAPSHOT_WORDS - 1U);
+    CHECK_EQ(timestamp, 8);
+    CHECK_EQ(acs_publish_read_newer(&pub, &generation, &out, &timestamp), ACS_ERR_EMPTY);
+}
+
+/**
+ * @brief After 2^31 - 1 publishes the counter wraps. The snapshot stays
+ * readable and the generation goes on from 1, 0 stays nothing published.
+ */
+static void test_wrap(void)
+{
+    static acs_publish_t pub;
+    acs_snapshot_t snap;
+    acs_snapshot_t out;
+    uint32_t generation = 0U;
+
+    acs_publish_init(&pub);
+    atomic_store(&pub.seq, UINT32_MAX - 1U);
+    CHECK_EQ(acs_publish_generation(&pub), INT32_MAX);
+
+    fill(&snap, 400U);
+    acs_publish(&pub, &snap, 9U);
+    CHECK_EQ(acs_publish_generation(&pub), 1);
+    CHECK_EQ(acs_publish_read(&pub, &out, NULL, &generation), ACS_OK);
+    CHECK_EQ(generation, 1);
+    CHECK_EQ(out.words[0], 400);
+
+    generation = INT32_MAX;
+    CHECK_EQ(acs_publish_read_newer(&pub, &generation, &out, NULL), ACS_OK);
+    CHECK_EQ(generation, 1);
+
+    acs_publish(&pub, &snap, 10U);
+    CHECK_EQ(acs_publish_generation(&pub), 2);
+}
+
+typedef struct
+{
+    acs_publish_t *pub;
+    uint32_t       reads;
+    uint32_t       torn;        // Words or timestamp from different publishes
+    uint32_t       backwards;   // Generation older than one read before
+    uint32_t       mismatched;  // Generation not the one the payload was published as
+} reader_t;
+
+static atomic_bool writer_done;
+static atomic_uint readers_running;
+
+/**
+ * @brief Publish n has every word and the timestamp derived from n, so any
+ * copy mixing two publishes shows. After the first publish the writer waits
+ * for every reader to have copied it, so they all overlap the rest.
+ */
+static void *writer(void *arg)
+{
+    acs_publish_t *pub = arg;
+    acs_snapshot_t snap;
+
+    for (uint32_t n = 1; n <= PUBLISHES; n++)
+    {
+        fill(&snap, n * 16U);
+        acs_publish(pub, &snap, ((uint64_t)n << 32) | n);
+        while (n == 1U && atomic_load(&readers_running) < READERS)
+            ;
+    }
+    atomic_store(&writer_done, true);
+    return NULL;
+}
+
+static void *reader(void *arg)
+{
+    reader_t *r = arg;
+    acs_snapshot_t snap;
+    uint64_t timestamp;
+    uint32_t generation;
+    uint32_t last = 0U;
+
+    while (!atomic_load(&writer_done))
+    {
+        if (acs_publish_read(r->pub, &snap, &timestamp, &generation) != ACS_OK)
+            continue;
+        if (r->reads++ == 0U)
+            atomic_fetch_add(&readers_running, 1U);
+
+        uint32_t n = (uint32_t)timestamp;
+        if ((uint32_t)(timestamp >> 32) != n)
+            r->torn++;
+        for (uint32_t i = 0; i < ACS_SNAPSHOT_WORDS; i++)
+            if (snap.words[i] != n * 16U + i)
+                r->torn++;
+        if (generation != n)
+            r->mismatched++;
+        if (generation < last)
+            r->backwards++;
+        last = generation;
+    }
+    return NULL;
+}
+
+/**
+ * @brief One writer publishing as fast as it can against several readers.
+ * No copy is torn and every copy carries its own generation.
+ */
+static void test_concurrent_readers(void)
+{
+    static acs_publish_t pub;
+    reader_t readers[READERS];
+    pthread_t reader_threads[READERS];
+    pthread_t writer_thread;
+
+    acs_publish_init(&pub);
+    atomic_store(&writer_done, false);
+    atomic_store(&readers_running, 0U);
+    memset(readers, 0, sizeof(readers));
+
+    for (uint32_t i = 0; i < READERS; i++)
+    {
+        readers[i].pub = &pub;
+        CHECK_EQ(pthread_create(&reader_threads[i], NULL, reader, &readers[i]), 0);
+    }
+    CHECK_EQ(pthread_create(&writer_thread, NULL, writer, &pub), 0);
+
+    pthread_join(writer_thread, NULL);
+    for (uint32_t i = 0; i < READERS; i++)
+    {
+        pthread_join(reader_threads[i], NULL);
+        CHECK(readers[i].reads > 0U);
+        CHECK_EQ(readers[i].torn, 0);
+        CHECK_EQ(readers[i].mismatched, 0);
+        CHECK_EQ(readers[i].backwards, 0);
+    }
+    CHECK_EQ(acs_publish_generation(&pub), PUBLISHES);
+}
+
+int main(void)
+{
+    RUN(test_single_thread);
+    RUN(test_wrap);
+    RUN(test_concurrent_readers);
+    return test_report("publish");
+}
@@ -0,0 +1,170 @@
+#include <string.h>
+#include "ACS71020.h"
+#include "ACS71020_sched.h"
+#include "test.h"
+
+#define DEVICES 4U
+#define ADDR0   96U
+
+typedef struct
+{
+    acs_transport_t  bus;
+    acs_fake_bus_t   fake_bus;
+    acs_fake_t       fakes[DEVICES];
+    acs_device_t     devs[DEVICES + 1U];    // The last one is not on the bus
+    acs_sched_slot_t slots[DEVICES + 1U];
+    acs_sched_t      sched;
+
+    uint32_t         calls[DEVICES + 1U];
+    uint32_t         bad_data;
+} rig_t;
+
+static void on_read(void *user, uint8_t slot, const acs_snapshot_t *snap, int status)
+{
+    rig_t *rig = user;
+
+    rig->calls[slot]++;
+    if (status == ACS_OK && snap->words[0] != ADDR0 + slot)
+        rig->bad_data++;
+}
+
+/**
+ * @brief DEVICES fake devices on one simulated bus, each with its own address
+ * in 0x20 so the data can be traced back.
+ */
+static void rig_init(rig_t *rig, acs_sched_policy_t policy, uint8_t max_batch)
+{
+    acs_fake_t *devices[DEVICES];
+    acs_transport_t unused;
+
+    memset(rig, 0, sizeof(*rig));
+    for (uint8_t i = 0; i < DEVICES; i++)
+    {
+        acs_transport_fake_init(&unused, &rig->fakes[i], (uint8_t)(ADDR0 + i));
+        rig->fakes[i].regs[ACS_REG_MEAS_FIRST] = ADDR0 + i;
+        devices[i] = &rig->fakes[i];
+    }
+    acs_transport_fake_bus_init(&rig->bus, &rig->fake_bus, devices, DEVICES);
+    for (uint8_t i = 0; i <= DEVICES; i++)
+        acs_device_init(&rig->devs[i], &rig->bus, (uint8_t)(ADDR0 + i));
+
+    CHECK_EQ(acs_sched_init(&rig->sched, &rig->bus, rig->slots, DEVICES + 1U,
+                            policy, max_batch), ACS_OK);
+    acs_sched_set_callback(&rig->sched, on_read, rig);
+}
+
+static void test_add_checks(void)
+{
+    static rig_t rig;
+    acs_transport_t other;
+    acs_fake_t fake;
+    acs_device_t stranger;
+
+    rig_init(&rig, ACS_SCHED_ROUND_ROBIN, 4U);
+    acs_transport_fake_init(&other, &fake, ADDR0);
+    acs_device_init(&stranger, &other, ADDR0);
+
+    CHECK_EQ(acs_sched_add(&rig.sched, &stranger, 1000U, 0U), ACS_ERR_PARAM);
+    CHECK_EQ(acs_sched_add(&rig.sched, &rig.devs[0], 0U, 0U), ACS_ERR_PARAM);
+    for (uint8_t i = 0; i <= DEVICES; i++)
+        CHECK_EQ(acs_sched_add(&rig.sched, &rig.devs[i], 1000U, 0U), i);
+    CHECK_EQ(acs_sched_add(&rig.sched, &rig.devs[0], 1000U, 0U), ACS_ERR_FULL);
+    CHECK_EQ(acs_sched_run(&rig.sched, 0U), 4);   // max_batch
+}
+
+static void test_round_robin_batches_share_the_bus(void)
+{
+    static rig_t rig;
+
+    rig_init(&rig, ACS_SCHED_ROUND_ROBIN, 2U);
+    for (uint8_t i = 0; i < DEVICES; i++)
+        acs_sched_add(&rig.sched, &rig.devs[i], 1000U, 0U);
+
+    // All four are due, two per batch, rotating
+    CHECK_EQ(acs_sched_run(&rig.sched, 0U), 2);
+    CHECK_EQ(acs_sched_run(&rig.sched, 0U), 2);
+    CHECK_EQ(acs_sched_run(&rig.sched, 0U), 0);
+    for (uint8_t i = 0; i < DEVICES; i++)
+        CHECK_EQ(rig.calls[i], 1);
+
+    CHECK_EQ(rig.sched.batches, 2);
+    CHECK_EQ(rig.fake_bus.transactions, 2);     // One bus transaction per batch
+    CHECK_EQ(rig.bad_data, 0);
+    CHECK_EQ(acs_sched_next_due(&rig.sched), 1000U);
+}
+
+static void test_per_device_rates(void)
+{
+    static rig_t rig;
+    acs_sched_stats_t fast, slow;
+
+    rig_init(&rig, ACS_SCHED_ROUND_ROBIN, 4U);
+    acs_sched_add(&rig.sched, &rig.devs[0], 1000U, 0U);
+    acs_sched_add(&rig.sched, &rig.devs[1], 4000U, 0U);
+
+    for (uint64_t now = 0; now <= 1000000U; now += 500U)
+        CHECK(acs_sched_run(&rig.sched, now) >= 0);
+
+    acs_sched_stats(&rig.sched, 0U, &fast);
+    acs_sched_stats(&rig.sched, 1U, &slow);
+    CHECK_EQ(fast.reads, 1001);
+    CHECK_EQ(slow.reads, 251);
+    CHECK_NEAR(fast.rate_hz, 1000.0, 0.5);
+    CHECK_NEAR(slow.rate_hz, 250.0, 0.5);
+    CHECK_EQ(fast.late + slow.late, 0);
+    CHECK_EQ(rig.bad_data, 0);
+}
+
+static void test_priority_and_lateness(void)
+{
+    static rig_t rig;
+
+    rig_init(&rig, ACS_SCHED_PRIORITY, 1U);
+    acs_sched_add(&rig.sched, &rig.devs[0], 1000U, 1U);
+    acs_sched_add(&rig.sched, &rig.devs[1], 1000U, 5U);
+    acs_sched_add(&rig.sched, &rig.devs[2], 1000U, 1U);
+
+    CHECK_EQ(acs_sched_run(&rig.sched, 0U), 1);
+    CHECK_EQ(rig.calls[1], 1);
+
+    // Equal priorities take turns
+    CHECK_EQ(acs_sched_run(&rig.sched, 0U), 1);
+    CHECK_EQ(acs_sched_run(&rig.sched, 0U), 1);
+    CHECK_EQ(rig.calls[0], 1);
+    CHECK_EQ(rig.calls[2], 1);
+
+    // Served two periods late, counted, and moved back onto a future slot
+    CHECK_EQ(acs_sched_run(&rig.sched, 3000U), 1);
+    CHECK_EQ(rig.calls[1], 2);
+    CHECK_EQ(rig.slots[1].late, 1);
+    CHECK_EQ(rig.slots[1].next_due_us, 4000U);
+}
+
+static void test_missing_device_counts_errors(void)
+{
+    static rig_t rig;
+    acs_sched_stats_t stats;
+
+    rig_init(&rig, ACS_SCHED_ROUND_ROBIN, 8U);
+    for (uint8_t i = 0; i <= DEVICES; i++)
+        acs_sched_add(&rig.sched, &rig.devs[i], 1000U, 0U);
+
+    CHECK_EQ(acs_sched_run(&rig.sched, 0U), DEVICES + 1U);
+    acs_sched_stats(&rig.sched, DEVICES, &stats);
+    CHECK_EQ(stats.errors, 1);
+    CHECK_EQ(stats.reads, 0);
+    CHECK_EQ(rig.calls[DEVICES], 1);
+    acs_sched_stats(&rig.sched, 0U, &stats);
+    CHECK_EQ(stats.errors, 0);
+    CHECK_EQ(rig.bad_data, 0);
+}
+
+int main(void)
+{
+    RUN(test_add_checks);
+    RUN(test_round_robin_batches_share_the_bus);
+    RUN(test_per_device_rates);
+    RUN(test_priority_and_lateness);
+    RUN(test_missing_device_counts_errors);
+    return test_report("sched");
+}
@@ -0,0 +1,131 @@
+#include "ACS71020.h"
+#include "ACS71020_ecc.h"
+#include "ACS71020_shadow.h"
+#include "ACS71020_sim.h"
+#include "test.h"
+
+typedef struct
+{
+    acs_transport_t transport;
+    acs_sim_t       sim;
+    acs_device_t    dev;
+    acs_shadow_t    shadow;
+} rig_t;
+
+/**
+ * @brief Simulated device with factory trims in 0x0B and a delay in 0x0D,
+ * the fields an unloaded write-back would have wiped.
+ */
+static void rig_init(rig_t *rig)
+{
+    acs_sim_config_t config;
+
+    acs_sim_default_config(&config);
+    acs_sim_init(&rig->sim, &config);
+    acs_transport_sim_init(&rig->transport, &rig->sim);
+    acs_device_init(&rig->dev, &rig->transport, config.dev_addr);
+    acs_shadow_init(&rig->shadow, &rig->dev);
+
+    rig->sim.regs[0x0B] = eeprom_0x0B_sns_fine_set(eeprom_0x0B_qvo_fine_set(0U, 0x1F3U), 0x021U);
+    rig->sim.regs[0x0D] = eeprom_0x0D_fault_set(eeprom_0x0D_chan_del_sel_set(0U, 3U), 0xC8U);
+}
+
+static void test_unloaded_shadow_refuses_writes(void)
+{
+    static rig_t rig;
+
+    rig_init(&rig);
+    uint32_t before = rig.sim.regs[0x0D];
+
+    CHECK_EQ(acs_shadow_set_pacc_trim(&rig.shadow, 5U), ACS_ERR_PARAM);
+    CHECK_EQ(acs_shadow_write(&rig.shadow, 0x0DU, 0U), ACS_ERR_PARAM);
+    CHECK(!acs_shadow_is_dirty(&rig.shadow));
+    CHECK_EQ(acs_shadow_flush(&rig.shadow), ACS_ERR_PARAM);
+    CHECK_EQ(rig.sim.transactions, 0);
+    CHECK_EQ(rig.sim.regs[0x0D], before);
+}
+
+static void test_flush_writes_only_dirty_words(void)
+{
+    static rig_t rig;
+
+    rig_init(&rig);
+    uint32_t r0x0B = rig.sim.regs[0x0B];
+
+    CHECK_EQ(acs_shadow_load(&rig.shadow), ACS_OK);
+    CHECK_EQ(acs_shadow_get_chan_del_sel(&rig.shadow), 3);
+
+    // Same value, nothing to do
+    CHECK_EQ(acs_shadow_set_chan_del_sel(&rig.shadow, 3U), ACS_OK);
+    CHECK(!acs_shadow_is_dirty(&rig.shadow));
+
+    CHECK_EQ(acs_shadow_set_pacc_trim(&rig.shadow, 0x7EU), ACS_OK);
+    CHECK_EQ(acs_shadow_set_halfcycle_en(&rig.shadow, 1U), ACS_OK);
+    CHECK_EQ(rig.shadow.dirty, 1U << (0x0D - ACS_REG_EEPROM_FIRST));
+
+    CHECK_EQ(acs_shadow_flush(&rig.shadow), ACS_OK);
+    CHECK_EQ(rig.sim.eeprom_writes[0x0D - ACS_REG_EEPROM_FIRST], 1);
+    CHECK_EQ(rig.sim.eeprom_writes[0x0B - ACS_REG_EEPROM_FIRST], 0);
+    CHECK_EQ(rig.sim.rejected_writes, 0);
+    CHECK_EQ(rig.shadow.words_written, 1);
+
+    uint32_t r0x0D = rig.sim.regs[0x0D];
+    CHECK_EQ(eeprom_0x0D_pacc_trim_sget(r0x0D), -2);
+    CHECK_EQ(eeprom_0x0D_halfcycle_en_get(r0x0D), 1);
+    CHECK_EQ(eeprom_0x0D_chan_del_sel_get(r0x0D), 3);
+    CHECK_EQ(eeprom_0x0D_fault_get(r0x0D), 0xC8);
+    CHECK_EQ(rig.sim.regs[0x0B], r0x0B);
+
+    // Clean cache, no bus traffic
+    uint32_t transactions = rig.sim.transactions;
+    CHECK_EQ(acs_shadow_flush(&rig.shadow), ACS_OK);
+    CHECK_EQ(rig.sim.transactions, transactions);
+}
+
+static void test_load_reports_uncorrectable_words(void)
+{
+    static rig_t rig;
+
+    rig_init(&rig);
+    rig.sim.regs[0x0C] |= eeprom_frame_EEC_set(0U, ACS_EEC_UNCORRECTABLE);
+
+    CHECK_EQ(acs_shadow_load(&rig.shadow), ACS_ERR_ECC);
+    CHECK(rig.shadow.loaded);
+    CHECK_EQ(rig.shadow.uncorrectable, 1U << (0x0C - ACS_REG_EEPROM_FIRST));
+    CHECK_EQ(eeprom_frame_EEC_get(acs_shadow_read(&rig.shadow, 0x0CU)), 0);
+}
+
+static void test_failed_load_keeps_cache(void)
+{
+    acs_transport_t transport;
+    acs_fake_t fake;
+    acs_device_t dev;
+    acs_shadow_t shadow;
+
+    acs_transport_fake_init(&transport, &fake, 0x60U);
+    acs_device_init(&dev, &transport, 0x60U);
+    acs_shadow_init(&shadow, &dev);
+    fake.regs[0x0E] = 0x12345640U;
+
+    fake.fail_next = ACS_ERR_BUS;
+    CHECK_EQ(acs_shadow_load(&shadow), ACS_ERR_BUS);
+    CHECK(!shadow.loaded);
+    CHECK_EQ(acs_shadow_read(&shadow, 0x0EU), 0);
+
+    CHECK_EQ(acs_shadow_load(&shadow), ACS_OK);
+    CHECK_EQ(acs_shadow_read(&shadow, 0x0EU), 0x12345640U);
+
+    fake.regs[0x0E] = 0U;
+    fake.fail_next = ACS_ERR_BUS;
+    CHECK_EQ(acs_shadow_load(&shadow), ACS_ERR_BUS);
+    CHECK_EQ(acs_shadow_read(&shadow, 0x0EU), 0x12345640U);
+}
+
+int main(void)
+{
+    RUN(test_unloaded_shadow_refuses_writes);
+    RUN(test_flush_writes_only_dirty_words);
+    RUN(test_load_reports_uncorrectable_words);
+    RUN(test_failed_load_keeps_cache);
+    return test_report("shadow");
+}
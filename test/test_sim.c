@@ -0,0 +1,110 @@
+#include <math.h>
+#include "ACS71020.h"
+#include "ACS71020_sim.h"
+#include "test.h"
+
+typedef struct
+{
+    acs_transport_t transport;
+    acs_sim_t       sim;
+    acs_device_t    dev;
+} rig_t;
+
+static void rig_init(rig_t *rig, const acs_sim_config_t *config)
+{
+    acs_sim_init(&rig->sim, config);
+    acs_transport_sim_init(&rig->transport, &rig->sim);
+    acs_device_init(&rig->dev, &rig->transport, config->dev_addr);
+}
+
+static void test_rms_and_power(void)
+{
+    static rig_t rig;
+    acs_sim_config_t config;
+    acs_snapshot_t snap;
+
+    acs_sim_default_config(&config);
+    rig_init(&rig, &config);
+    acs_sim_advance(&rig.sim, 200000000U);
+    CHECK_EQ(acs_read_snapshot(&rig.dev, &snap), ACS_OK);
+
+    uint32_t r0x20 = snap.regs.reg_0x20.register_value;
+    CHECK_NEAR(acs_0x20_vrms_get(r0x20), 0.7 / sqrt(2.0) * 32768.0, 8.0);
+    CHECK_NEAR(acs_0x20_irms_get(r0x20), 0.5 / sqrt(2.0) * 16384.0, 4.0);
+    CHECK_NEAR(acs_0x21_pactive_sget(snap.regs.reg_0x21.register_value), 0.7 * 0.5 / 2.0 * 32768.0, 8.0);
+    CHECK_NEAR(acs_0x22_papparent_get(snap.regs.reg_0x22.register_value), 0.7 * 0.5 / 2.0 * 32768.0, 8.0);
+    CHECK_NEAR(acs_0x24_pfactor_sget(snap.regs.reg_0x24.register_value), 512.0, 1.0);
+    CHECK_EQ(acs_0x25_numptsout_get(snap.regs.reg_0x25.register_value), 511);   // 640 saturates
+}
+
+static void test_quadrature_load(void)
+{
+    static rig_t rig;
+    acs_sim_config_t config;
+    acs_snapshot_t snap;
+
+    acs_sim_default_config(&config);
+    config.current.phase = -1.5707963f;    // Current lags by 90 degrees
+    rig_init(&rig, &config);
+    rig.sim.regs[0x0E] = eeprom_0x0E_vadc_rate_set_set(0U, 1U);
+    acs_sim_advance(&rig.sim, 200000000U);
+    CHECK_EQ(acs_read_snapshot(&rig.dev, &snap), ACS_OK);
+
+    CHECK_NEAR(acs_0x24_pfactor_sget(snap.regs.reg_0x24.register_value), 0.0, 8.0);
+    CHECK_NEAR(acs_0x23_pimag_get(snap.regs.reg_0x23.register_value), 0.7 * 0.5 / 2.0 * 32768.0, 64.0);
+    CHECK_EQ(acs_0x25_numptsout_get(snap.regs.reg_0x25.register_value), 80);  // 4 kHz / 50 Hz
+}
+
+static void test_eeprom_needs_access_code(void)
+{
+    static rig_t rig;
+    acs_sim_config_t config;
+    uint32_t value;
+
+    acs_sim_default_config(&config);
+    rig_init(&rig, &config);
+
+    CHECK_EQ(acs_write_register(&rig.dev, 0x0CU, 0x12345640U), ACS_OK);
+    CHECK_EQ(rig.sim.rejected_writes, 1);
+    CHECK_EQ(acs_read_register(&rig.dev, 0x0CU, &value), ACS_OK);
+    CHECK_EQ(value, 0);
+
+    CHECK_EQ(acs_unlock(&rig.dev), ACS_OK);
+    CHECK_EQ(acs_write_register(&rig.dev, 0x0CU, 0x1234567FU), ACS_OK);
+    CHECK_EQ(acs_read_register(&rig.dev, 0x0CU, &value), ACS_OK);
+    CHECK_EQ(value, 0x12345640U);   // EEC and reserved bits are not stored
+    CHECK_EQ(rig.sim.eeprom_writes[0x0C - ACS_REG_EEPROM_FIRST], 1);
+}
+
+static void test_bus_timing(void)
+{
+    static rig_t rig;
+    acs_sim_config_t config;
+    acs_snapshot_t snap;
+
+    acs_sim_default_config(&config);
+    rig_init(&rig, &config);
+
+    // 400 kHz I2C: 9 bits per byte, 3 address/register bytes and 56 data
+    // bytes plus start, repeated start and stop
+    uint64_t expected = (9U * (3U + 56U) + 3U) * 1000000000ULL / 400000U;
+    CHECK_EQ(acs_sim_transaction_ns(&rig.sim, ACS_SNAPSHOT_WORDS, true), expected);
+
+    uint64_t before = rig.sim.now_ns;
+    CHECK_EQ(acs_read_snapshot(&rig.dev, &snap), ACS_OK);
+    CHECK_EQ(rig.sim.now_ns - before, expected);
+    CHECK_EQ(rig.sim.transactions, 1);
+
+    acs_device_t wrong;
+    acs_device_init(&wrong, &rig.transport, (uint8_t)(config.dev_addr + 1U));
+    CHECK_EQ(acs_read_snapshot(&wrong, &snap), ACS_ERR_NAK);
+}
+
+int main(void)
+{
+    RUN(test_rms_and_power);
+    RUN(test_quadrature_load);
+    RUN(test_eeprom_needs_access_code);
+    RUN(test_bus_timing);
+    return test_report("sim");
+}
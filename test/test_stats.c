@@ -0,0 +1,130 @@
+#include "ACS71020.h"
+#include "ACS71020_stats.h"
+#include "test.h"
+
+static const acs_full_scale_t fs = { 30.0, 250.0, 7500.0 };
+
+static void add(acs_stats_t *stats, float irms, uint64_t now_us)
+{
+    acs_measurement_t m = { 0 };
+
+    m.irms      = irms;
+    m.vrms      = 230.0f;
+    m.papparent = 230.0f * irms;
+    m.pactive   = m.papparent;
+    m.pfactor   = 1.0f;
+    acs_stats_update(stats, &m, now_us);
+}
+
+static void test_query_and_percentile(void)
+{
+    static acs_stats_t stats;
+    acs_stats_result_t r;
+    float p;
+
+    acs_stats_init(&stats, &fs);
+    CHECK_EQ(acs_stats_query(&stats, ACS_STAT_1S, ACS_STAT_IRMS, 0U, &r), ACS_ERR_EMPTY);
+
+    // 1 to 10 A, one value per 10 ms
+    for (uint32_t i = 0; i < 100U; i++)
+        add(&stats, 1.0f + 9.0f * (float)i / 99.0f, 10000U * i);
+
+    CHECK_EQ(acs_stats_query(&stats, ACS_STAT_1S, ACS_STAT_IRMS, 999999U, &r), ACS_OK);
+    CHECK_EQ(r.count, 100);
+    CHECK_NEAR(r.min, 1.0, 1e-6);
+    CHECK_NEAR(r.max, 10.0, 1e-6);
+    CHECK_NEAR(r.mean, 5.5, 1e-4);
+
+    CHECK_EQ(acs_stats_percentile(&stats, ACS_STAT_1S, ACS_STAT_IRMS, 999999U, 0.5f, &p), ACS_OK);
+    CHECK_NEAR(p, 5.5, 60.0 / ACS_STATS_BINS);
+
+    // A second later the 1 s window has slid past all of it, 10 s has not
+    CHECK_EQ(acs_stats_query(&stats, ACS_STAT_1S, ACS_STAT_IRMS, 2000000U, &r), ACS_ERR_EMPTY);
+    CHECK_EQ(acs_stats_query(&stats, ACS_STAT_10S, ACS_STAT_IRMS, 2000000U, &r), ACS_OK);
+    CHECK_EQ(r.count, 100);
+}
+
+/**
+ * @brief Bins counted against the old range must not be read against the
+ * new one.
+ */
+static void test_range_change_clears_channel(void)
+{
+    static acs_stats_t stats;
+    acs_stats_result_t r;
+    float p;
+
+    acs_stats_init(&stats, &fs);
+    for (uint32_t i = 0; i < 50U; i++)
+        add(&stats, 20.0f, 10000U * i);
+
+    // Same range again, nothing lost
+    CHECK_EQ(acs_stats_set_range(&stats, ACS_STAT_IRMS, stats.lo[ACS_STAT_IRMS],
+                                 stats.hi[ACS_STAT_IRMS]), ACS_OK);
+    CHECK_EQ(acs_stats_query(&stats, ACS_STAT_1S, ACS_STAT_IRMS, 490000U, &r), ACS_OK);
+    CHECK_EQ(r.count, 50);
+
+    CHECK_EQ(acs_stats_set_range(&stats, ACS_STAT_IRMS, 0.0f, 10.0f), ACS_OK);
+    CHECK_EQ(acs_stats_query(&stats, ACS_STAT_1S, ACS_STAT_IRMS, 490000U, &r), ACS_ERR_EMPTY);
+    CHECK_EQ(acs_stats_query(&stats, ACS_STAT_15MIN, ACS_STAT_IRMS, 490000U, &r), ACS_ERR_EMPTY);
+
+    // The rest of the current slot, then later ones
+    for (uint32_t i = 50U; i < 100U; i++)
+        add(&stats, 2.0f + 6.0f * (float)(i - 50U) / 49.0f, 10000U * i);
+
+    CHECK_EQ(acs_stats_query(&stats, ACS_STAT_1S, ACS_STAT_IRMS, 999999U, &r), ACS_OK);
+    CHECK_EQ(r.count, 50);
+    CHECK_NEAR(r.min, 2.0, 1e-6);
+    CHECK_NEAR(r.max, 8.0, 1e-6);
+
+    CHECK_EQ(acs_stats_percentile(&stats, ACS_STAT_1S, ACS_STAT_IRMS, 999999U, 0.5f, &p), ACS_OK);
+    CHECK_NEAR(p, 5.0, 10.0 / ACS_STATS_BINS);
+    CHECK_EQ(acs_stats_percentile(&stats, ACS_STAT_15MIN, ACS_STAT_IRMS, 999999U, 0.9f, &p), ACS_OK);
+    CHECK_NEAR(p, 7.4, 10.0 / ACS_STATS_BINS);
+
+    // Other channels keep everything
+    CHECK_EQ(acs_stats_query(&stats, ACS_STAT_1S, ACS_STAT_VRMS, 999999U, &r), ACS_OK);
+    CHECK_EQ(r.count, 100);
+
+    CHECK_EQ(acs_stats_set_range(&stats, ACS_STAT_IRMS, 1.0f, 1.0f), ACS_ERR_PARAM);
+    CHECK_EQ(acs_stats_set_range(&stats, ACS_STAT_CHANNELS, 0.0f, 1.0f), ACS_ERR_PARAM);
+}
+
+/**
+ * @brief Default ranges span every code of each field.
+ */
+static void test_default_ranges(void)
+{
+    static acs_stats_t stats;
+
+    acs_stats_init(&stats, &fs);
+
+    CHECK_NEAR(stats.lo[ACS_STAT_IRMS], 0.0, 0.0);
+    CHECK_NEAR(stats.hi[ACS_STAT_IRMS], 32767.0 / 16384.0 * 30.0, 1e-3);
+    CHECK_NEAR(stats.lo[ACS_STAT_VRMS], 0.0, 0.0);
+    CHECK_NEAR(stats.hi[ACS_STAT_VRMS], 32767.0 / 32768.0 * 250.0, 1e-3);
+    CHECK_NEAR(stats.lo[ACS_STAT_PACTIVE], -2.0 * 7500.0, 1e-2);
+    CHECK_NEAR(stats.hi[ACS_STAT_PACTIVE], 65535.0 / 32768.0 * 7500.0, 1e-2);
+    CHECK_NEAR(stats.lo[ACS_STAT_PAPPARENT], 0.0, 0.0);
+    CHECK_NEAR(stats.hi[ACS_STAT_PAPPARENT], 65535.0 / 32768.0 * 7500.0, 1e-2);
+    CHECK_NEAR(stats.lo[ACS_STAT_PIMAG], 0.0, 0.0);
+    CHECK_NEAR(stats.hi[ACS_STAT_PIMAG], 65535.0 / 32768.0 * 7500.0, 1e-2);
+    CHECK_NEAR(stats.lo[ACS_STAT_PFACTOR], -2.0, 1e-6);
+    CHECK_NEAR(stats.hi[ACS_STAT_PFACTOR], 1023.0 / 512.0, 1e-6);
+
+    // A current past full scale is binned, not piled into the top bin
+    for (uint32_t i = 0; i < 10U; i++)
+        add(&stats, 45.0f, 10000U * i);
+
+    float p;
+    CHECK_EQ(acs_stats_percentile(&stats, ACS_STAT_1S, ACS_STAT_IRMS, 90000U, 0.5f, &p), ACS_OK);
+    CHECK_NEAR(p, 45.0, 60.0 / ACS_STATS_BINS);
+}
+
+int main(void)
+{
+    RUN(test_query_and_percentile);
+    RUN(test_range_change_clears_channel);
+    RUN(test_default_ranges);
+    return test_report("stats");
+}
@@ -0,0 +1,204 @@
+#include <string.h>
+#include "ACS71020.h"
+#include "test.h"
+
+#define ADDR 0x60U
+
+static void fill_measurements(acs_fake_t *fake)
+{
+    for (uint8_t i = 0; i < ACS_SNAPSHOT_WORDS; i++)
+        fake->regs[ACS_REG_MEAS_FIRST + i] = 0x01000000U * (i + 1U) + i;
+}
+
+static void test_snapshot_is_one_transaction(void)
+{
+    acs_transport_t transport;
+    acs_fake_t fake;
+    acs_device_t dev;
+    acs_snapshot_t snap;
+
+    acs_transport_fake_init(&transport, &fake, ADDR);
+    acs_device_init(&dev, &transport, ADDR);
+    fill_measurements(&fake);
+
+    CHECK_EQ(acs_read_snapshot(&dev, &snap), ACS_OK);
+    CHECK_EQ(fake.read_transactions, 1);
+    CHECK_EQ(fake.words_read, ACS_SNAPSHOT_WORDS);
+    CHECK(memcmp(snap.words, &fake.regs[ACS_REG_MEAS_FIRST], sizeof(snap.words)) == 0);
+    CHECK_EQ(snap.regs.reg_0x2D.register_value, fake.regs[ACS_REG_MEAS_LAST]);
+}
+
+static void test_errors_leave_snapshot_untouched(void)
+{
+    acs_transport_t transport;
+    acs_fake_t fake;
+    acs_device_t dev, other;
+    acs_snapshot_t snap;
+
+    acs_transport_fake_init(&transport, &fake, ADDR);
+    acs_device_init(&dev, &transport, ADDR);
+    acs_device_init(&other, &transport, ADDR + 1U);
+    fill_measurements(&fake);
+    memset(&snap, 0xA5, sizeof(snap));
+
+    fake.fail_next = ACS_ERR_BUS;
+    CHECK_EQ(acs_read_snapshot(&dev, &snap), ACS_ERR_BUS);
+    CHECK_EQ(snap.words[0], 0xA5A5A5A5U);
+    CHECK_EQ(acs_read_snapshot(&other, &snap), ACS_ERR_NAK);
+    CHECK_EQ(acs_read_snapshot(&dev, &snap), ACS_OK);
+    CHECK_EQ(acs_read_snapshot(NULL, &snap), ACS_ERR_PARAM);
+}
+
+static void test_unlock(void)
+{
+    acs_transport_t transport;
+    acs_fake_t fake;
+    acs_device_t dev;
+    uint32_t value;
+
+    acs_transport_fake_init(&transport, &fake, ADDR);
+    acs_device_init(&dev, &transport, ADDR);
+
+    CHECK_EQ(acs_unlock(&dev), ACS_OK);
+    CHECK_EQ(fake.regs[ACS_REG_ACCESS_CODE], ACS_CUSTOMER_CODE);
+
+    CHECK_EQ(acs_write_register(&dev, ACS_REG_ACCESS_CODE, 0U), ACS_OK);
+    CHECK_EQ(acs_read_register(&dev, ACS_REG_CUSTOMER_ACCESS, &value), ACS_OK);
+    CHECK_EQ(acs_0x30_customer_access_get(value), 0);
+}
+
+/* I2C and SPI adapters, over a platform primitive that records the bytes */
+
+typedef struct
+{
+    uint8_t  addr;
+    uint8_t  tx[1U + 4U * ACS_TRANSPORT_MAX_WORDS];
+    size_t   tx_len;
+    size_t   rx_len;
+    unsigned calls;
+} wire_t;
+
+static int wire_i2c(void *ctx, uint8_t addr, const uint8_t *tx, size_t tx_len,
+                    uint8_t *rx, size_t rx_len)
+{
+    wire_t *w = ctx;
+
+    w->calls++;
+    w->addr   = addr;
+    w->tx_len = tx_len;
+    w->rx_len = rx_len;
+    memcpy(w->tx, tx, tx_len);
+    for (size_t i = 0; i < rx_len; i++)
+        rx[i] = (uint8_t)i;
+    return ACS_OK;
+}
+
+static int wire_spi(void *ctx, const uint8_t *tx, uint8_t *rx, size_t len)
+{
+    wire_t *w = ctx;
+
+    w->calls++;
+    w->tx_len = len;
+    memcpy(w->tx, tx, len);
+    if (rx != NULL)
+        for (size_t i = 0; i < len; i++)
+            rx[i] = (uint8_t)(i - 1U);
+    return ACS_OK;
+}
+
+static void test_i2c_framing(void)
+{
+    wire_t wire = { 0 };
+    acs_i2c_bus_t bus = { wire_i2c, &wire };
+    acs_transport_t transport;
+    acs_device_t dev;
+    acs_snapshot_t snap;
+
+    acs_transport_i2c_init(&transport, &bus);
+    acs_device_init(&dev, &transport, ADDR);
+
+    CHECK_EQ(acs_read_snapshot(&dev, &snap), ACS_OK);
+    CHECK_EQ(wire.calls, 1);
+    CHECK_EQ(wire.addr, ADDR);
+    CHECK_EQ(wire.tx_len, 1);
+    CHECK_EQ(wire.tx[0], ACS_REG_MEAS_FIRST);
+    CHECK_EQ(wire.rx_len, 4U * ACS_SNAPSHOT_WORDS);
+    CHECK_EQ(snap.words[0], 0x03020100U);   // LSB first
+    CHECK_EQ(snap.words[1], 0x07060504U);
+
+    CHECK_EQ(acs_write_register(&dev, 0x0BU, 0x11223344U), ACS_OK);
+    CHECK_EQ(wire.tx_len, 5);
+    CHECK_EQ(wire.tx[0], 0x0B);
+    CHECK_EQ(wire.tx[1], 0x44);
+    CHECK_EQ(wire.tx[4], 0x11);
+}
+
+static void test_spi_framing(void)
+{
+    wire_t wire = { 0 };
+    acs_spi_bus_t bus = { wire_spi, &wire };
+    acs_transport_t transport;
+    acs_device_t dev;
+    acs_snapshot_t snap;
+
+    acs_transport_spi_init(&transport, &bus);
+    acs_device_init(&dev, &transport, 0U);
+
+    CHECK_EQ(acs_read_snapshot(&dev, &snap), ACS_OK);
+    CHECK_EQ(wire.calls, 1);
+    CHECK_EQ(wire.tx_len, 1U + 4U * ACS_SNAPSHOT_WORDS);
+    CHECK_EQ(wire.tx[0], ACS_REG_MEAS_FIRST | 0x80U);
+    CHECK_EQ(snap.words[0], 0x03020100U);
+
+    CHECK_EQ(acs_write_register(&dev, 0x0BU, 0x11223344U), ACS_OK);
+    CHECK_EQ(wire.tx[0], 0x0B);
+    CHECK_EQ(wire.tx[1], 0x44);
+}
+
+static void test_fake_bus_batch(void)
+{
+    acs_transport_t transport;
+    acs_fake_t fakes[3];
+    acs_fake_t *const devices[3] = { &fakes[0], &fakes[1], &fakes[2] };
+    acs_transport_t unused;
+    acs_fake_bus_t bus;
+    uint32_t words[4][ACS_SNAPSHOT_WORDS];
+    acs_xfer_t xfers[4];
+
+    for (uint8_t i = 0; i < 3U; i++)
+    {
+        acs_transport_fake_init(&unused, &fakes[i], (uint8_t)(ADDR + i));
+        fill_measurements(&fakes[i]);
+        fakes[i].regs[ACS_REG_MEAS_FIRST] = i;
+    }
+    CHECK_EQ(acs_transport_fake_bus_init(&transport, &bus, devices, 3U), ACS_OK);
+
+    for (uint8_t i = 0; i < 4U; i++)
+        xfers[i] = (acs_xfer_t){ (uint8_t)(ADDR + i), ACS_REG_MEAS_FIRST,
+                                 ACS_SNAPSHOT_WORDS, 1, words[i] };
+
+    CHECK_EQ(acs_transport_read_multi(&transport, xfers, 4U), ACS_OK);
+    CHECK_EQ(bus.transactions, 1);
+    CHECK_EQ(xfers[0].status, ACS_OK);
+    CHECK_EQ(xfers[2].status, ACS_OK);
+    CHECK_EQ(xfers[3].status, ACS_ERR_NAK);
+    CHECK_EQ(words[1][0], 1);
+    CHECK_EQ(words[2][0], 2);
+
+    // Without read_multi the batch falls back to one read per transfer
+    transport.read_multi = NULL;
+    CHECK_EQ(acs_transport_read_multi(&transport, xfers, 3U), ACS_OK);
+    CHECK_EQ(bus.transactions, 4);
+    CHECK_EQ(xfers[1].status, ACS_OK);
+}
+
+int main(void)
+{
+    RUN(test_snapshot_is_one_transaction);
+    RUN(test_errors_leave_snapshot_untouched);
+    RUN(test_unlock);
+    RUN(test_i2c_framing);
+    RUN(test_spi_framing);
+    RUN(test_fake_bus_batch);
+    return test_report("transport");
+}
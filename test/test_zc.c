@@ -0,0 +1,142 @@
+#include <string.h>
+#include "ACS71020.h"
+#include "ACS71020_sim.h"
+#include "ACS71020_zc.h"
+#include "test.h"
+
+typedef struct
+{
+    acs_transport_t transport;
+    acs_sim_t       sim;
+    acs_device_t    dev;
+    acs_zc_t        zc;
+    uint32_t        fresh;
+    uint32_t        not_fresh;
+} rig_t;
+
+static void on_snapshot(void *user, const acs_snapshot_t *snap, bool fresh)
+{
+    rig_t *rig = user;
+    (void)snap;
+
+    if (fresh)
+        rig->fresh++;
+    else
+        rig->not_fresh++;
+}
+
+static void on_dio0(void *user, bool level)
+{
+    rig_t *rig = user;
+
+    // Pulse mode, rising edges only
+    if (level)
+        acs_zc_on_edge(&rig->zc);
+}
+
+/**
+ * @brief Simulated device with DIO0 reporting zero crossings. The simulator is
+ * noiseless, so rig_step() lets the voltage drift slowly to keep consecutive
+ * windows from being bit-identical.
+ */
+static void rig_init(rig_t *rig, bool squarewave)
+{
+    acs_sim_config_t config;
+    eeprom_0x0D_t r0x0D;
+    eeprom_0x0F_t r0x0F;
+
+    memset(rig, 0, sizeof(*rig));
+    acs_sim_default_config(&config);
+    config.line_hz = 50.3f;
+    acs_sim_init(&rig->sim, &config);
+    acs_transport_sim_init(&rig->transport, &rig->sim);
+    acs_device_init(&rig->dev, &rig->transport, config.dev_addr);
+
+    r0x0D.eeprom_data = rig->sim.regs[0x0D];
+    r0x0F.eeprom_data = rig->sim.regs[0x0F];
+    acs_zc_prepare_config(&r0x0D, &r0x0F, false, squarewave);
+    rig->sim.regs[0x0D] = r0x0D.eeprom_data;
+    rig->sim.regs[0x0F] = r0x0F.eeprom_data;
+
+    acs_zc_init(&rig->zc, &rig->dev, false, squarewave, on_snapshot, rig);
+}
+
+static void rig_step(rig_t *rig, uint64_t ns)
+{
+    rig->sim.config.voltage.amplitude += 1e-5f;
+    acs_sim_advance(&rig->sim, ns);
+}
+
+static void test_edge_driven_reads_one_per_window(void)
+{
+    static rig_t rig;
+
+    rig_init(&rig, false);
+    acs_sim_set_dio_callback(&rig.sim, on_dio0, &rig);
+
+    // Reads advance the simulated clock too, so run by simulated time
+    while (acs_sim_now_us(&rig.sim) < 1000000U)
+    {
+        rig_step(&rig, 1000000U);
+        int ret = acs_zc_service(&rig.zc);
+        CHECK(ret == ACS_OK || ret == ACS_ERR_EMPTY);
+    }
+
+    // 50 crossings in 1 s. The first comes before any window has completed,
+    // numptsout is still 0, so that read is the only stale one.
+    CHECK_EQ(rig.zc.reads, 50);
+    CHECK_EQ(rig.zc.stale, 1);
+    CHECK_EQ(rig.zc.missed, 0);
+    CHECK_EQ(rig.fresh, 49);
+    CHECK_EQ(rig.not_fresh, 1);
+    CHECK_EQ(rig.zc.numptsout, 511);    // 636 samples per cycle saturate 9 bits
+}
+
+static void test_read_without_new_window_is_stale(void)
+{
+    static rig_t rig;
+
+    rig_init(&rig, false);
+    acs_sim_set_dio_callback(&rig.sim, on_dio0, &rig);
+    rig_step(&rig, 45000000U);
+    (void)acs_zc_service(&rig.zc);
+    CHECK_EQ(rig.fresh, 1);
+
+    // vcodes, icodes and pinstant have moved on, the window has not
+    acs_zc_on_edge(&rig.zc);
+    CHECK_EQ(acs_zc_service(&rig.zc), ACS_OK);
+    CHECK_EQ(rig.fresh, 1);
+    CHECK_EQ(rig.zc.stale, 1);
+    CHECK(rig.zc.last.words[0x2A - ACS_REG_MEAS_FIRST] != 0U);
+
+    CHECK_EQ(acs_zc_service(&rig.zc), ACS_ERR_EMPTY);
+}
+
+static void test_polled_square_wave(void)
+{
+    static rig_t rig;
+
+    rig_init(&rig, true);
+
+    // Square wave toggles at every rising crossing, so no pulse can be missed
+    // between two polls of 0x2D
+    while (acs_sim_now_us(&rig.sim) < 1000000U)
+    {
+        rig_step(&rig, 500000U);
+        int ret = acs_zc_poll(&rig.zc);
+        CHECK(ret == ACS_OK || ret == ACS_ERR_EMPTY);
+    }
+
+    CHECK(rig.zc.reads >= 49U && rig.zc.reads <= 51U);
+    CHECK(rig.zc.stale <= 1U);
+    CHECK_EQ(rig.zc.missed, 0);
+    CHECK_EQ(rig.zc.bus_errors, 0);
+}
+
+int main(void)
+{
+    RUN(test_edge_driven_reads_one_per_window);
+    RUN(test_read_without_new_window_is_stale);
+    RUN(test_polled_square_wave);
+    return test_report("zc");
+}